@@ -2,6 +2,7 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <optional>
 #include <string>
@@ -33,6 +34,11 @@ struct SSLConfig {
     bool enable_tls_key_logging{false};
     bool enforce_tls_1_3{false};
     std::filesystem::path tls_key_logging_path{};
+    // TLS session resumption: session id cache for TLS 1.2 and tickets (with rotating keys) for TLS 1.2/1.3
+    bool enable_session_resumption{true};
+    std::size_t session_cache_size{64};
+    // hand the record encryption to the kernel (kTLS) after the handshake, if kernel and ciphersuite support it
+    bool enable_ktls{false};
 };
 
 } // namespace iso15118::config
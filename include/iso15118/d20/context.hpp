@@ -2,12 +2,19 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <optional>
 #include <string>
 #include <tuple>
+#include <type_traits>
 
 #include <iso15118/message/payload_type.hpp>
+#include <iso15118/message/response_builder.hpp>
+#include <iso15118/message/response_template.hpp>
 #include <iso15118/message/variant.hpp>
 #include <iso15118/session/feedback.hpp>
 #include <iso15118/session/logger.hpp>
@@ -25,25 +32,53 @@ class ControlEventQueue;
 class MessageExchange {
 public:
     MessageExchange(io::StreamOutputView);
+    // the session independent responses are taken from the shared templates (see ResponseTemplates)
+    MessageExchange(io::StreamOutputView, std::shared_ptr<message_20::ResponseTemplates> shared_templates);
 
-    void set_request(std::unique_ptr<message_20::Variant> new_request);
-    std::unique_ptr<message_20::Variant> pull_request();
+    // decodes the request into the storage of the previous one
+    void set_request(io::v2gtp::PayloadType, const io::StreamInputView&);
+    // the reference stays valid until the response has been cleared or the next request is set
+    const message_20::Variant& pull_request();
     message_20::Type peek_request_type() const;
 
+    // the builder writes into a document, which is reused for every response
+    template <typename BuilderType> BuilderType build_response() {
+        return response_documents.create_builder<BuilderType>();
+    }
+
     template <typename MessageType> void set_response(const MessageType& msg) {
-        response_size = message_20::serialize(msg, response);
+        using BuilderType = typename message_20::ResponseBuilderTrait<MessageType>::type;
+        if constexpr (std::is_void_v<BuilderType>) {
+            response_size = message_20::serialize(msg, response_templates, response);
+        } else {
+            response_size = message_20::serialize(build_response<BuilderType>().set(msg), response_templates, response);
+        }
         response_available = true;
         payload_type = message_20::PayloadTypeTrait<MessageType>::type;
         response_type = message_20::TypeTrait<MessageType>::type;
     }
 
+    // ends the exchange, the memory of a handled request is released at once
     std::tuple<bool, size_t, io::v2gtp::PayloadType, message_20::Type> check_and_clear_response();
 
 private:
-    // input
-    std::unique_ptr<message_20::Variant> request{nullptr};
+    void release_request();
+
+    // Memory of the decoded request (i.e. its lists, which are not stored in place), which is only needed until the
+    // end of the exchange.  Allocations are taken from the buffer in order and never freed on their own, the whole
+    // arena is released after each exchange.  Requests larger than the buffer get additional memory from the heap.
+    static constexpr std::size_t ARENA_SIZE = 4096;
+    std::array<std::byte, ARENA_SIZE> arena_buffer;
+    std::pmr::monotonic_buffer_resource arena{arena_buffer.data(), arena_buffer.size(),
+                                              std::pmr::new_delete_resource()};
+
+    // input, reused across all exchanges
+    message_20::Variant request{&arena};
+    bool request_available{false};
 
     // output
+    message_20::ResponseDocuments response_documents;
+    message_20::ResponseTemplates response_templates;
     const io::StreamOutputView response;
     size_t response_size{0};
     bool response_available{false};
@@ -54,7 +89,41 @@ private:
 std::unique_ptr<MessageExchange> create_message_exchange(uint8_t* buf, const size_t len);
 
 class StateBase;
-using BasePointerType = std::unique_ptr<StateBase>;
+
+// Storage of the states of the fsm.  Only the current state and the one it transitions to exist at the same time, so
+// the states are constructed in a few preallocated slots and a transition doesn't allocate.  Should all slots be in
+// use, the state is allocated on the heap instead.
+class StatePool {
+public:
+    static constexpr std::size_t SLOT_SIZE = 128;
+    static constexpr std::size_t SLOT_COUNT = 3;
+
+    StatePool() = default;
+    // the states refer to the context, which owns the pool, so neither of them can be copied
+    StatePool(const StatePool&) = delete;
+    StatePool& operator=(const StatePool&) = delete;
+
+    void* allocate(std::size_t size);
+    void deallocate(void* memory);
+
+private:
+    struct Slot {
+        alignas(std::max_align_t) std::array<std::byte, SLOT_SIZE> data;
+        bool used{false};
+    };
+
+    std::array<Slot, SLOT_COUNT> slots;
+};
+
+// destroys a state and hands its memory back to the pool (without a pool the state has been allocated with new)
+struct StateDeleter {
+    StatePool* pool{nullptr};
+    void* memory{nullptr};
+
+    void operator()(StateBase*) const;
+};
+
+using BasePointerType = std::unique_ptr<StateBase, StateDeleter>;
 
 class Context {
 public:
@@ -63,12 +132,27 @@ public:
             const std::optional<ControlEvent>&, MessageExchange&);
 
     template <typename StateType, typename... Args> BasePointerType create_state(Args&&... args) {
-        return std::make_unique<StateType>(*this, std::forward<Args>(args)...);
+        static_assert(sizeof(StateType) <= StatePool::SLOT_SIZE, "State doesn't fit into a slot of the state pool");
+        static_assert(alignof(StateType) <= alignof(std::max_align_t), "State needs a stricter alignment than a slot");
+
+        const auto memory = state_pool.allocate(sizeof(StateType));
+        try {
+            return BasePointerType(new (memory) StateType(*this, std::forward<Args>(args)...),
+                                   StateDeleter{&state_pool, memory});
+        } catch (...) {
+            state_pool.deallocate(memory);
+            throw;
+        }
     }
 
-    std::unique_ptr<message_20::Variant> pull_request();
+    const message_20::Variant& pull_request();
     message_20::Type peek_request_type() const;
 
+    // build the response in place, instead of filling a response type, and pass the builder to respond()
+    template <typename BuilderType> BuilderType build_response() {
+        return message_exchange.build_response<BuilderType>();
+    }
+
     template <typename MessageType> void respond(const MessageType& msg) {
         message_exchange.set_response(msg);
     }
@@ -105,6 +189,8 @@ public:
 private:
     const std::optional<ControlEvent>& current_control_event;
     MessageExchange& message_exchange;
+
+    StatePool state_pool;
 };
 
 } // namespace iso15118::d20
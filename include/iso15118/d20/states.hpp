@@ -13,6 +13,11 @@ enum class Event {
     V2GTP_MESSAGE,
     CONTROL_MESSAGE,
 
+    // timeouts
+    SEQUENCE_TIMEOUT,
+    PERFORMANCE_TIMEOUT,
+    IDLE_TIMEOUT,
+
     // internal events
     FAILED,
 };
@@ -3,18 +3,20 @@
 #pragma once
 
 #include <stdexcept>
+#include <string_view>
 
 #include <cbv2g/common/exi_bitstream.h>
 
 #include <iso15118/io/stream_view.hpp>
 
-#define CB2CPP_STRING(property) (std::string(property.characters, property.charactersLen))
+// the strings of the messages are either std::string or bounded strings, both convert from and to std::string_view
+#define CB2CPP_STRING(property) (std::string_view(property.characters, property.charactersLen))
 #define CPP2CB_STRING(in, out)                                                                                         \
-    if (in.length() > sizeof(out.characters)) {                                                                        \
+    if (std::string_view(in).length() > sizeof(out.characters)) {                                                      \
         throw std::runtime_error("String too long");                                                                   \
     }                                                                                                                  \
-    in.copy(out.characters, in.length());                                                                              \
-    out.charactersLen = in.length()
+    std::string_view(in).copy(out.characters, std::string_view(in).length());                                          \
+    out.charactersLen = std::string_view(in).length()
 
 #define CPP2CB_BYTES(in, out)                                                                                          \
     if (in.size() > sizeof(out.bytes)) {                                                                               \
@@ -16,6 +16,9 @@ template <typename Response, typename ResponseCode> Response& response_with_code
 }
 
 bool validate_and_setup_header(message_20::Header&, const Session&, const decltype(message_20::Header::session_id)&);
+// for the session id of a request view, which refers into the decoded message
+bool validate_and_setup_header(message_20::Header&, const Session&,
+                               const uint8_t (&)[message_20::datatypes::SESSION_ID_LENGTH]);
 
 void setup_header(message_20::Header&, const Session&);
 
@@ -17,10 +17,13 @@
 
 namespace iso15118::d20::state {
 
-message_20::DC_ChargeLoopResponse handle_request(const message_20::DC_ChargeLoopRequest& req,
-                                                 const d20::Session& session, const float present_voltage,
-                                                 const float present_current, const bool stop,
-                                                 const DcTransferLimits& dc_limits,
-                                                 const UpdateDynamicModeParameters& dynamic_parameters);
+// writes the response into the document of the builder and returns its response code, instantiated for
+// DC_ChargeLoopRequest and DC_ChargeLoopRequestView
+template <typename RequestType>
+message_20::datatypes::ResponseCode
+handle_charge_loop_request(const RequestType& req, const d20::Session& session, const float present_voltage,
+                           const float present_current, const bool stop, const DcTransferLimits& dc_limits,
+                           const UpdateDynamicModeParameters& dynamic_parameters,
+                           message_20::DC_ChargeLoopResponseBuilder& res);
 
 } // namespace iso15118::d20::state
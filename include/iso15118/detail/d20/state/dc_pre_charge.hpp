@@ -15,4 +15,7 @@ namespace iso15118::d20::state {
 message_20::DC_PreChargeResponse handle_request(const message_20::DC_PreChargeRequest& req, const d20::Session& session,
                                                 const float present_voltage);
 
+message_20::DC_PreChargeResponse handle_request(const message_20::DC_PreChargeRequestView& req,
+                                                const d20::Session& session, const float present_voltage);
+
 } // namespace iso15118::d20::state
@@ -10,4 +10,7 @@ namespace iso15118::d20::state {
 message_20::PowerDeliveryResponse handle_request(const message_20::PowerDeliveryRequest& req,
                                                  const d20::Session& session);
 
+message_20::PowerDeliveryResponse handle_request(const message_20::PowerDeliveryRequestView& req,
+                                                 const d20::Session& session);
+
 } // namespace iso15118::d20::state
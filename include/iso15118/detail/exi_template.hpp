@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cb_exi.hpp"
+
+namespace iso15118::message_20 {
+
+// how the cbv2g encoder writes a patchable field (see EXI 1.0, 7.1.5 - 7.1.9)
+enum class ExiPatchEncoding {
+    UnsignedInteger, // e.g. xs:unsignedLong, groups of 7 bits, least significant first
+    Integer,         // e.g. xs:short, sign bit followed by the unsigned magnitude
+    Byte,            // xs:byte, 8 bit n-bit unsigned integer of the value + 128
+    Bytes,           // content of a fixed length xs:hexBinary (e.g. the session id), up to 8 bytes as they are
+};
+
+// a member of a cbv2g message, whose new value can be patched into the encoded message
+struct ExiPatchField {
+    ExiPatchEncoding encoding;
+    std::size_t offset; // of the member in the cbv2g message
+    std::size_t size;   // of the member in bytes (for bytes, the length of the content has to be part of the message)
+};
+
+#define EXI_PATCH_FIELD(message_type, member, encoding)                                                                \
+    ExiPatchField {                                                                                                    \
+        ExiPatchEncoding::encoding, offsetof(message_type, member),                                                    \
+            sizeof(static_cast<message_type*>(nullptr)->member)                                                        \
+    }
+
+#define EXI_PATCH_RATIONAL_NUMBER(message_type, member)                                                                \
+    EXI_PATCH_FIELD(message_type, member.Value, Integer), EXI_PATCH_FIELD(message_type, member.Exponent, Byte)
+
+// Encoded message, which is reused as long as only its patchable fields (e.g. the timestamp or the present voltage)
+// change.  The new values are written into the encoded bits in place, if their encoding has the same length as the
+// one of the previous values.  Otherwise the message is encoded again and taken as the new template.
+//
+// The bit positions of the patchable fields are found by encoding the message once more per field, with the field
+// changed to a value of the same encoding length, and looking for the first bit which differs.  If they can't be
+// found, the message is encoded plainly until its key (the rest of the message and the encoding lengths of the
+// fields) changes.
+class ExiTemplate {
+public:
+    using EncodeFunction = int (*)(exi_bitstream_t*, void* document);
+
+    // the message has to be part of the document, all of its padding and unused members need to be zeroed, so that
+    // equal content compares equal
+    size_t serialize(void* document, void* message, std::size_t message_size, const ExiPatchField* fields,
+                     std::size_t field_count, EncodeFunction encode, const io::StreamOutputView& out);
+
+    auto get_patch_count() const {
+        return patch_count;
+    }
+
+    // including the encodes to find the bit positions
+    auto get_encode_count() const {
+        return encode_count;
+    }
+
+private:
+    struct Slot {
+        std::size_t bit_offset;
+        uint8_t bit_count;
+    };
+
+    size_t patch(const uint8_t* message, const ExiPatchField* fields, std::size_t field_count,
+                 const io::StreamOutputView& out);
+    size_t record(void* document, uint8_t* message, const ExiPatchField* fields, std::size_t field_count,
+                  EncodeFunction encode, const io::StreamOutputView& out);
+    size_t encode_plain(void* document, EncodeFunction encode, const io::StreamOutputView& out);
+
+    // the message with all patchable fields set to 0, followed by the encoding lengths of their values
+    std::vector<uint8_t> key;
+    std::vector<uint8_t> encoded;
+    std::vector<Slot> slots;
+    bool patchable{false};
+
+    std::vector<uint8_t> scratch;
+    std::vector<uint8_t> probe;
+
+    std::size_t patch_count{0};
+    std::size_t encode_count{0};
+};
+
+template <auto Encode, typename DocumentType, typename MessageType, std::size_t N>
+size_t serialize_with_template(ExiTemplate& exi_template, DocumentType& document, MessageType& message,
+                               const std::array<ExiPatchField, N>& fields, const io::StreamOutputView& out) {
+    const auto encode = [](exi_bitstream_t* stream, void* document) {
+        return Encode(stream, static_cast<DocumentType*>(document));
+    };
+
+    return exi_template.serialize(&document, &message, sizeof(message), fields.data(), fields.size(), encode, out);
+}
+
+} // namespace iso15118::message_20
@@ -8,4 +8,7 @@ namespace iso15118::io {
 
 void log_and_raise_openssl_error(const std::string& error_msg);
 
+// logs the message together with (and clears) the openssl error queue, for errors which are handled
+void log_openssl_error(const std::string& error_msg);
+
 } // namespace iso15118::io
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+
+struct nlmsghdr;
+
+namespace iso15118::io {
+
+// Cache of the network interfaces and their ipv6 addresses.  It is filled once from getifaddrs and then updated
+// incrementally from rtnetlink link and address notifications, so lookups don't walk the whole interface list.
+// NOTE: the notifications are only read by handle_events(), so whoever owns the event loop needs to poll get_fd()
+class InterfaceRegistry {
+public:
+    // the process wide instance
+    static InterfaceRegistry& get_instance();
+
+    InterfaceRegistry();
+    ~InterfaceRegistry();
+
+    InterfaceRegistry(const InterfaceRegistry&) = delete;
+    InterfaceRegistry& operator=(const InterfaceRegistry&) = delete;
+
+    // readable as soon as notifications are pending, -1 if rtnetlink is not available
+    auto get_fd() const {
+        return netlink_fd;
+    }
+
+    // reads all pending notifications, returns true if any interface or address changed
+    bool handle_events();
+
+    // applies a buffer of rtnetlink link and address messages (as read from get_fd()), returns true if any interface
+    // or address changed
+    bool handle_messages(const void* buffer, std::size_t length);
+
+    // first link local address of the interface (any address for the loopback interface), "auto" picks the first
+    // interface with a link local address
+    std::optional<sockaddr_in6> get_address(const std::string& interface_name);
+
+    // 0 if the interface is unknown
+    unsigned int get_index(const std::string& interface_name);
+
+    // name of the first interface with a link local address, empty if there is none
+    std::string find_first_link_local_interface();
+
+private:
+    struct Interface {
+        std::string name;
+        unsigned int index;
+        std::vector<sockaddr_in6> addresses;
+    };
+
+    void load();
+    bool apply_messages(const void* buffer, std::size_t length);
+    bool handle_link_message(const nlmsghdr*);
+    bool handle_address_message(const nlmsghdr*);
+    Interface* find(unsigned int index);
+    Interface* find(const std::string& name);
+    std::optional<sockaddr_in6> get_preferred_address(const Interface&) const;
+
+    std::mutex mutex;
+    std::vector<Interface> interfaces;
+
+    int netlink_fd{-1};
+};
+
+} // namespace iso15118::io
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <openssl/ssl.h>
+
+#include <iso15118/config.hpp>
+
+namespace iso15118::io {
+
+// Cache of server SSL_CTX objects per SSLConfig.  Building a context reads and parses the certificates and keys from
+// disk, so it is done once and not for every incoming connection.  The configured files are watched with inotify, after
+// one of them changed, the context gets rebuilt on the next lookup and swapped in.  Connections, which are already
+// established, keep using the previous context.
+class SSLContextCache {
+public:
+    // the config passed to the builder lives as long as the cache, so the context might keep references into it
+    using Builder = std::function<SSL_CTX*(const config::SSLConfig&)>;
+
+    // the process wide instance, shared by all connections
+    static SSLContextCache& get_instance();
+
+    SSLContextCache();
+    ~SSLContextCache();
+
+    SSLContextCache(const SSLContextCache&) = delete;
+    SSLContextCache& operator=(const SSLContextCache&) = delete;
+
+    // thread safe, throws if the context needs to be built for the first time and the builder fails
+    std::shared_ptr<SSL_CTX> get(const config::SSLConfig&, const Builder&);
+
+private:
+    struct Entry {
+        config::SSLConfig config;
+        std::shared_ptr<SSL_CTX> ctx;
+        std::vector<std::filesystem::path> files;
+        bool outdated{false};
+    };
+
+    void watch_files(Entry&);
+    void handle_file_events();
+
+    std::mutex mutex;
+    std::list<Entry> entries;
+
+    int inotify_fd{-1};
+    std::unordered_map<int, std::filesystem::path> watched_directories;
+};
+
+} // namespace iso15118::io
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace iso15118::io {
+
+class TlsKeyLoggingServer;
+
+// Sink for the NSS key log lines, which OpenSSL hands out during the handshake.  The handshake only copies the line
+// into a lock free queue, a background thread appends the queued lines to the (kept open) key log files, sends them
+// to the key logging servers and flushes the files once per batch.
+class TlsKeyLogWriter {
+public:
+    // the longest line is a label, a 32 byte client random and a 48 byte secret, all hex encoded
+    static constexpr std::size_t MAX_LINE_LENGTH = 256;
+    // needs to be a power of two
+    static constexpr std::size_t QUEUE_SIZE = 256;
+    static constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(100);
+
+    // the process wide instance, shared by all connections
+    static TlsKeyLogWriter& get_instance();
+
+    TlsKeyLogWriter();
+    // writes out all lines, which are still queued
+    ~TlsKeyLogWriter();
+
+    TlsKeyLogWriter(const TlsKeyLogWriter&) = delete;
+    TlsKeyLogWriter& operator=(const TlsKeyLogWriter&) = delete;
+
+    // thread safe and lock free, the line is dropped (and false returned) if it is too long or the queue is full
+    // NOTE: the directory needs to outlive the writer, the server is optional
+    bool push(const char* line, const std::filesystem::path& directory, std::shared_ptr<TlsKeyLoggingServer> server);
+
+    auto get_dropped_lines() const {
+        return dropped_lines.load();
+    }
+
+private:
+    struct Line {
+        char text[MAX_LINE_LENGTH];
+        std::size_t length{0};
+        const std::filesystem::path* directory{nullptr};
+        std::shared_ptr<TlsKeyLoggingServer> server;
+    };
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        Line line;
+    };
+
+    bool pop(Line&);
+    void run();
+
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<std::size_t> enqueue_position{0};
+    // only used by the writer thread
+    alignas(64) std::size_t dequeue_position{0};
+
+    std::atomic<uint64_t> dropped_lines{0};
+
+    std::mutex mutex;
+    std::condition_variable stop_condition;
+    bool stop{false};
+    std::thread thread;
+};
+
+} // namespace iso15118::io
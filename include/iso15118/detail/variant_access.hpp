@@ -3,6 +3,7 @@
 #pragma once
 
 #include <cassert>
+#include <cstdio>
 
 #include <iso15118/message/variant.hpp>
 
@@ -15,22 +16,52 @@ struct VariantAccess {
     exi_bitstream_t input_stream;
 
     // output
-    void*& data;
+    iso15118::message_20::Variant::Storage& storage;
     iso15118::message_20::Type& type;
-    iso15118::message_20::Variant::CustomDeleter& custom_deleter;
-    std::string& error;
+    iso15118::message_20::Variant::ErrorMessage& error;
+    // the lists of the messages, which are not stored in place, are allocated from it
+    std::pmr::memory_resource* resource;
 
     template <typename MessageType, typename CbExiMessageType> void insert_type(const CbExiMessageType& in) {
-        assert(data == nullptr);
+        convert(in, emplace_type<MessageType>());
+    };
 
-        data = new MessageType;
-        type = iso15118::message_20::TypeTrait<MessageType>::type;
-        custom_deleter = [](void* ptr) { delete static_cast<MessageType*>(ptr); };
+    // for messages with lists, which are not stored in place
+    template <typename MessageType, typename CbExiMessageType>
+    void insert_type_with_resource(const CbExiMessageType& in) {
+        convert(in, emplace_type<MessageType>(), resource);
+    };
 
-        convert(in, *static_cast<MessageType*>(data));
+    // the view reads from the decoded cbv2g message, which is kept by the variant until its next decode
+    template <typename ViewType, typename CbExiMessageType> void insert_view(const CbExiMessageType& in) {
+        assert(type == iso15118::message_20::Type::None);
+
+        storage.emplace<ViewType>(in);
+        type = iso15118::message_20::TypeTrait<ViewType>::type;
     };
+
+    template <typename MessageType> MessageType& emplace_type() {
+        assert(type == iso15118::message_20::Type::None);
+
+        // constructed in place, the previous message has already been destroyed by Variant::reset()
+        auto& data = storage.emplace<MessageType>();
+        type = iso15118::message_20::TypeTrait<MessageType>::type;
+        return data;
+    }
+
+    void set_error(const char* reason, int status = 0) {
+        if (status != 0) {
+            std::snprintf(error.data(), error.size(), "%s failed with %d", reason, status);
+        } else {
+            std::snprintf(error.data(), error.size(), "%s", reason);
+        }
+    }
 };
 
 template <typename CbExiMessageType> void insert_type(VariantAccess& va, const CbExiMessageType&);
 
+// message type of an encoded document, told from the event code of its root element without decoding it
+// NOTE: Type::None if the message type is not handled (or can't be told without decoding)
+Type peek_type(io::v2gtp::PayloadType, const io::StreamInputView&);
+
 } // namespace iso15118::message_20
@@ -21,6 +21,9 @@ enum class ConnectionEvent {
 
 using ConnectionEventCallback = std::function<void(ConnectionEvent)>;
 
+// max. time to wait for the peer to close its side of the connection, after we closed ours [V2G20-1643]
+static constexpr auto CONNECTION_LINGER_TIMEOUT_MS = 5000;
+
 struct ReadResult {
     bool would_block{true};
     size_t bytes_read{0};
@@ -34,6 +37,7 @@ struct IConnection {
     virtual void write(const uint8_t* buf, size_t len) = 0;
     virtual ReadResult read(uint8_t* buf, size_t len) = 0;
 
+    // starts a graceful close, CLOSED is signalled as soon as the peer closed its side or the linger timeout expired
     virtual void close() = 0;
 
     virtual std::optional<sha512_hash_t> get_vehicle_cert_hash() const = 0;
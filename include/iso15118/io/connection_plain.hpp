@@ -4,13 +4,21 @@
 
 #include "connection_abstract.hpp"
 
+#include <memory>
+#include <string>
+
 #include <iso15118/config.hpp>
+#include <iso15118/io/listener.hpp>
+#include <iso15118/io/output_queue.hpp>
 #include <iso15118/io/poll_manager.hpp>
 
 namespace iso15118::io {
 
 class ConnectionPlain : public IConnection {
 public:
+    // waits for the EV on a listener, which outlives the connection
+    ConnectionPlain(PollManager&, Listener&);
+    // opens its own listener on the default port, which is closed as soon as the EV connected
     ConnectionPlain(PollManager&, const std::string& interface_name);
 
     void set_event_callback(const ConnectionEventCallback&) final;
@@ -30,15 +38,35 @@ public:
 private:
     PollManager& poll_manager;
 
+    // only set while waiting for the EV to connect
+    Listener* listener{nullptr};
+    std::unique_ptr<Listener> owned_listener;
+
     Ipv6EndPoint end_point;
 
     int fd{-1};
 
     bool connection_open{false};
+    bool closing{false};
+
+    OutputQueue output_queue;
+    bool pollout_enabled{false};
+
+    std::optional<TimerId> linger_timer{std::nullopt};
 
     ConnectionEventCallback event_callback{nullptr};
 
+    void wait_for_connect(Listener&);
     void handle_connect();
+    void handle_events(short revents);
     void handle_data();
+    void flush_output();
+    void set_want_write(bool);
+    void half_close();
+    void handle_linger();
+    void handle_connection_loss();
+    void finish_close();
+    // returns false, if closing the socket failed
+    bool release_socket();
 };
 } // namespace iso15118::io
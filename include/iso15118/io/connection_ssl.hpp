@@ -3,10 +3,14 @@
 #pragma once
 #include "connection_abstract.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
 
 #include <iso15118/config.hpp>
+#include <iso15118/io/listener.hpp>
+#include <iso15118/io/output_queue.hpp>
 #include <iso15118/io/poll_manager.hpp>
 #include <iso15118/io/sha_hash.hpp>
 
@@ -14,10 +18,22 @@ namespace iso15118::io {
 
 // forward declaration
 struct SSLContext;
+
+// counted over all TLS connections of the process
+struct TlsSessionResumptionStats {
+    uint64_t hits{0};   // resumed handshakes
+    uint64_t misses{0}; // full handshakes
+};
+
 class ConnectionSSL : public IConnection {
 public:
+    // waits for the EV on a listener, which outlives the connection
+    ConnectionSSL(PollManager&, Listener&, const config::SSLConfig&);
+    // opens its own listener on the default port, which is closed as soon as the EV connected
     ConnectionSSL(PollManager&, const std::string& interface_name, const config::SSLConfig&);
 
+    static TlsSessionResumptionStats get_session_resumption_stats();
+
     void set_event_callback(const ConnectionEventCallback&) final;
     Ipv6EndPoint get_public_endpoint() const final;
 
@@ -28,19 +44,48 @@ public:
 
     std::optional<sha512_hash_t> get_vehicle_cert_hash() const final;
 
+    // true, if the records are encrypted (send) or decrypted (receive) by the kernel
+    bool is_ktls_send_enabled() const {
+        return ktls_send;
+    }
+    bool is_ktls_receive_enabled() const {
+        return ktls_receive;
+    }
+
     ~ConnectionSSL();
 
 private:
     PollManager& poll_manager;
     std::unique_ptr<SSLContext> ssl;
 
+    // only set while waiting for the EV to connect
+    Listener* listener{nullptr};
+    std::unique_ptr<Listener> owned_listener;
+
     Ipv6EndPoint end_point;
 
     ConnectionEventCallback event_callback{nullptr};
 
     bool handshake_complete{false};
+    bool ktls_send{false};
+    bool ktls_receive{false};
+    bool closing{false};
+    bool close_notify_sent{false};
+
+    OutputQueue output_queue;
+    bool pollout_enabled{false};
+
+    std::optional<TimerId> linger_timer{std::nullopt};
 
+    void setup(Listener&, const config::SSLConfig&);
     void handle_connect();
+    void handle_events(short revents);
     void handle_data();
+    void flush_output();
+    void set_want_write(bool);
+    void shutdown_tls();
+    void handle_linger();
+    void handle_connection_loss();
+    void finish_close();
 };
 } // namespace iso15118::io
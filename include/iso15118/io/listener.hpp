@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <netinet/in.h>
+
+#include "ipv6_endpoint.hpp"
+
+namespace iso15118::io {
+
+// default ports of the listeners, which are offered by SDP
+static constexpr uint16_t TCP_LISTENER_PORT = 50000;
+static constexpr uint16_t TLS_LISTENER_PORT = 50001;
+
+// Long-lived listening TCP socket on the link local address of an interface.  It is opened once (e.g. when the
+// controller starts), so the endpoint offered by SDP is already listening, connections only register its fd while they
+// wait for the EV to connect.
+class Listener {
+public:
+    Listener(const std::string& interface_name, uint16_t port);
+    ~Listener();
+
+    Listener(const Listener&) = delete;
+    Listener& operator=(const Listener&) = delete;
+
+    // returns the accepted, non-blocking socket with the socket option profile applied or -1, if no connection is
+    // pending (throws on any other failure)
+    int accept(sockaddr_in6& peer_address);
+
+    auto get_fd() const {
+        return fd;
+    }
+
+    const auto& get_interface_name() const {
+        return interface_name;
+    }
+
+    Ipv6EndPoint get_end_point() const {
+        return end_point;
+    }
+
+private:
+    std::string interface_name;
+    Ipv6EndPoint end_point;
+    int fd{-1};
+};
+
+} // namespace iso15118::io
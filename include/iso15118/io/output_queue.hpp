@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace iso15118::io {
+
+// bytes, which have been written by the session, but not yet been accepted by the socket
+class OutputQueue {
+public:
+    // the peer decides, how fast the queue drains, so a peer which stops reading must not let it grow unbounded
+    static constexpr size_t MAX_SIZE = 256 * 1024;
+
+    // returns false (and queues nothing), if the queue would exceed MAX_SIZE
+    [[nodiscard]] bool push(const uint8_t* buf, size_t len) {
+        if (len > MAX_SIZE - size()) {
+            return false;
+        }
+        if (offset > 0 and offset == buffer.size()) {
+            clear();
+        }
+        buffer.insert(buffer.end(), buf, buf + len);
+        return true;
+    }
+
+    // marks len bytes from the front as sent
+    void pop(size_t len) {
+        offset += len;
+        if (offset >= buffer.size()) {
+            clear();
+        }
+    }
+
+    const uint8_t* data() const {
+        return buffer.data() + offset;
+    }
+
+    size_t size() const {
+        return buffer.size() - offset;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    void clear() {
+        buffer.clear();
+        offset = 0;
+    }
+
+private:
+    std::vector<uint8_t> buffer;
+    size_t offset{0};
+};
+
+} // namespace iso15118::io
@@ -2,34 +2,82 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
-#include <map>
-#include <vector>
+#include <unordered_map>
 
 #include <poll.h>
+#include <sys/epoll.h>
+
+#include <iso15118/io/timer_wheel.hpp>
+
 namespace iso15118::io {
 
 using PollCallback = const std::function<void()>;
-struct PollSet {
-    std::vector<struct pollfd> fds;
-    std::vector<PollCallback*> callbacks;
+
+// NOTE: revents contains the poll(2) style flags (POLLIN, POLLOUT, POLLERR, POLLHUP) which were signalled
+using PollEventCallback = const std::function<void(short revents)>;
+
+enum class PollTrigger {
+    LEVEL,
+    EDGE,
 };
 
 class PollManager {
 public:
     PollManager();
+    ~PollManager();
 
+    PollManager(const PollManager&) = delete;
+    PollManager& operator=(const PollManager&) = delete;
+
+    // level triggered, only interested in POLLIN
     void register_fd(int fd, PollCallback& poll_callback);
+    void register_fd(int fd, PollEventCallback& poll_callback, short events,
+                     PollTrigger trigger = PollTrigger::LEVEL);
+
+    // change the event mask (POLLIN / POLLOUT) of an already registered fd
+    void modify_fd(int fd, short events);
     void unregister_fd(int fd);
 
+    // one-shot timers, called from within poll()
+    TimerId add_timer(int32_t timeout_ms, const TimerCallback&);
+    void cancel_timer(TimerId);
+
+    // waits at most timeout_ms (-1 for no limit), but never longer than until the next timer is due
     void poll(int timeout_ms);
+
+    // wakes up a (concurrently) blocking poll() call, thread safe
     void abort();
 
 private:
-    std::map<int, PollCallback> registered_fds;
+    static constexpr auto MAX_READY_EVENTS = 64;
+
+    struct Registration {
+        std::function<void(short)> callback;
+        short events;
+        PollTrigger trigger;
+        uint32_t generation;
+    };
+
+    void dispatch_ready_list(int ready_count);
+
+    std::unordered_map<int, Registration> registered_fds;
+
+    // used to detect stale ready events of fds, which got unregistered (and
+    // possibly re-registered) while dispatching the current ready list
+    uint32_t next_generation{0};
+
+    std::array<struct epoll_event, MAX_READY_EVENTS> ready_list;
+
+    const std::chrono::steady_clock::time_point start_time{std::chrono::steady_clock::now()};
+    uint64_t get_ticks() const;
 
-    PollSet poll_set;
+    TimerWheel timer_wheel{0};
 
+    int epoll_fd{-1};
     int event_fd{-1};
 };
 
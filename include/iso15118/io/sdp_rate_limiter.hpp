@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <netinet/in.h>
+
+#include <iso15118/io/time.hpp>
+
+namespace iso15118::io {
+
+// Token bucket per peer address, so a chatty or broken EV can't keep the SDP server (and the controller, which sets
+// up a listener for every request) busy.  Each request takes a token, a token is added every refill interval, up to
+// the burst size.
+class SdpRateLimiter {
+public:
+    // the least recently seen peer is forgotten, if more peers show up
+    static constexpr std::size_t MAX_TRACKED_PEERS = 16;
+
+    SdpRateLimiter(uint32_t burst, std::chrono::milliseconds refill_interval);
+
+    // takes a token of the peer, returns false if there is none left
+    bool allow(const sockaddr_in6& peer, const TimePoint& now);
+
+private:
+    struct Bucket {
+        in6_addr address;
+        uint32_t scope_id;
+        uint32_t tokens;
+        TimePoint last_refill;
+        TimePoint last_seen;
+    };
+
+    Bucket& get_bucket(const sockaddr_in6& peer, const TimePoint& now);
+
+    const uint32_t burst;
+    const std::chrono::milliseconds refill_interval;
+
+    std::vector<Bucket> buckets;
+};
+
+} // namespace iso15118::io
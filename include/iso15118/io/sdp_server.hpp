@@ -2,13 +2,17 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include <netinet/in.h>
 
 #include "ipv6_endpoint.hpp"
 #include "sdp.hpp"
+#include "sdp_rate_limiter.hpp"
 
 namespace iso15118::io {
 
@@ -17,6 +21,7 @@ struct PeerRequestContext {
     v2gtp::Security security;
     v2gtp::TransportProtocol transport_protocol;
     struct sockaddr_in6 address;
+    unsigned int interface_index{0}; // the interface, the request was received on
 
     operator bool() const {
         return valid;
@@ -28,18 +33,51 @@ private:
 
 class SdpServer {
 public:
+    // datagrams read with a single recvmmsg call
+    static constexpr std::size_t BATCH_SIZE = 16;
+    // an SDP request is 10 bytes, anything longer than this gets dropped
+    static constexpr std::size_t MAX_DATAGRAM_SIZE = 64;
+    // EVs retry the SDP request every 250 ms, so allow that rate and some burst
+    static constexpr uint32_t RATE_LIMIT_BURST = 5;
+    static constexpr auto RATE_LIMIT_INTERVAL = std::chrono::milliseconds(250);
+
+    // a single socket serves all interfaces, the requests tell on which one they were received
+    explicit SdpServer(const std::vector<std::string>& interface_names);
     explicit SdpServer(const std::string& interface_name);
     ~SdpServer();
-    PeerRequestContext get_peer_request();
+
+    // drains the socket, returns the valid requests of peers, which are not rate limited (valid until the next call)
+    const std::vector<PeerRequestContext>& get_peer_requests();
     void send_response(const PeerRequestContext&, const Ipv6EndPoint&);
 
+    // looks up the interfaces again and joins ff02::1 on the ones with a new index (e.g. a re-plugged PLC modem),
+    // requests of interfaces, which are gone, are dropped from now on
+    void refresh();
+
     auto get_fd() const {
         return fd;
     }
 
 private:
+    // bounds the time spent in a single call, the (level triggered) poll manager will call again
+    static constexpr auto MAX_BATCHES_PER_CALL = 4;
+
+    PeerRequestContext parse_request(const uint8_t* datagram, std::size_t length, int flags,
+                                     const sockaddr_in6& peer_address);
+    bool is_served_interface(unsigned int interface_index) const;
+    bool join_multicast_group(unsigned int interface_index);
+
     int fd{-1};
-    uint8_t udp_buffer[2048];
+    std::vector<std::string> interface_names;
+    std::vector<unsigned int> interface_indices;
+
+    uint8_t udp_buffers[BATCH_SIZE][MAX_DATAGRAM_SIZE];
+    sockaddr_in6 peer_addresses[BATCH_SIZE];
+    // receives the IPV6_PKTINFO of each datagram
+    alignas(cmsghdr) uint8_t control_buffers[BATCH_SIZE][CMSG_SPACE(sizeof(in6_pktinfo))];
+
+    SdpRateLimiter rate_limiter{RATE_LIMIT_BURST, RATE_LIMIT_INTERVAL};
+    std::vector<PeerRequestContext> requests;
 };
 
 class TlsKeyLoggingServer {
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+
+namespace iso15118::io {
+
+using TimerCallback = std::function<void()>;
+using TimerId = uint64_t;
+
+// Hierarchical timer wheel with a resolution of one tick (the PollManager uses 1 ms)
+//
+// Each of the WHEEL_COUNT wheels has 64 slots and a bitmap of the occupied slots, so that advancing the time and
+// finding the next slot to process only needs a few bit operations per wheel, independent of the amount of elapsed
+// ticks. Timers on higher wheels get cascaded down when their slot is reached. The algorithm follows the one of
+// William Ahern's timeout.c (https://25thandclement.com/~william/projects/timeout.c.html).
+class TimerWheel {
+public:
+    explicit TimerWheel(uint64_t now = 0);
+
+    // schedule a timer expiring at the absolute tick 'expires'
+    TimerId add(uint64_t expires, const TimerCallback&);
+
+    // returns false, if the timer was not pending (anymore)
+    bool cancel(TimerId);
+
+    // advance the current time, timers which expired will be called by the next call to expire()
+    void update(uint64_t now);
+
+    // call (and remove) all expired timers, returns the number of called timers
+    std::size_t expire();
+
+    // ticks until the wheel needs to be updated at the latest, std::nullopt if there are no timers
+    // NOTE: this might be earlier than the next expiring timer, if only timers on higher wheels are pending
+    std::optional<uint64_t> get_timeout() const;
+
+    auto get_current_time() const {
+        return current_time;
+    }
+
+    bool empty() const {
+        return timers.empty();
+    }
+
+private:
+    static constexpr auto WHEEL_BITS = 6;
+    static constexpr auto WHEEL_LENGTH = 1 << WHEEL_BITS;
+    static constexpr uint64_t WHEEL_MASK = WHEEL_LENGTH - 1;
+    static constexpr auto WHEEL_COUNT = 4;
+    static constexpr uint64_t MAX_TIMEOUT = (uint64_t(1) << (WHEEL_BITS * WHEEL_COUNT)) - 1;
+
+    struct Timer {
+        TimerId id;
+        uint64_t expires;
+        TimerCallback callback;
+    };
+
+    using TimerList = std::list<Timer>;
+
+    struct TimerLocation {
+        TimerList* list;
+        TimerList::iterator it;
+        // wheel and slot are only valid, if the timer is not on the expired list
+        int wheel{0};
+        int slot{0};
+    };
+
+    void schedule(TimerList& from, TimerList::iterator it);
+
+    std::array<std::array<TimerList, WHEEL_LENGTH>, WHEEL_COUNT> wheels;
+    std::array<uint64_t, WHEEL_COUNT> pending_slots{};
+
+    TimerList expired;
+
+    std::unordered_map<TimerId, TimerLocation> timers;
+
+    uint64_t current_time;
+    TimerId next_id{1};
+};
+
+} // namespace iso15118::io
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "connection_abstract.hpp"
+#include "sdp.hpp"
+
+namespace iso15118::io {
+
+struct V2gtpFrame {
+    v2gtp::PayloadType payload_type;
+    uint8_t const* payload;
+    size_t payload_length;
+};
+
+// Splits the byte stream of a connection into V2GTP frames.  Each call to read() fetches as much as is available
+// with a single IConnection::read, complete frames are then handed out in place by next_frame().
+class V2gtpFramer {
+public:
+    // max. size of a frame, including the V2GTP header
+    static constexpr size_t MAX_FRAME_SIZE = 2048;
+
+    // NOTE: next_frame() needs to be called until it returns std::nullopt, before calling read() again
+    ReadResult read(IConnection&);
+
+    // the frame points into the internal buffer and is only valid until the next call to read()
+    // throws, if the stream contains an invalid V2GTP header
+    std::optional<V2gtpFrame> next_frame();
+
+    // number of buffered bytes, which are not yet handed out as a frame
+    size_t get_buffered_bytes() const {
+        return end - begin;
+    }
+
+private:
+    uint8_t buffer[4 * MAX_FRAME_SIZE];
+    size_t begin{0};
+    size_t end{0};
+};
+
+} // namespace iso15118::io
@@ -2,11 +2,11 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
-#include <string>
 #include <variant>
-#include <vector>
 
 #include "common_types.hpp"
+#include "response_builder.hpp"
+#include "response_template.hpp"
 
 namespace iso15118::message_20 {
 
@@ -21,7 +21,7 @@ enum class AuthStatus {
 struct EIM_ASReqAuthorizationMode {};
 
 struct PnC_ASReqAuthorizationMode {
-    std::string id;
+    datatypes::Identifier id;
     GenChallenge gen_challenge;
     ContractCertificateChain contract_certificate_chain;
 };
@@ -40,4 +40,27 @@ struct AuthorizationResponse {
     datatypes::Processing evse_processing{datatypes::Processing::Finished};
 };
 
+// Writes a AuthorizationRes directly into the cbv2g document, which is encoded
+struct AuthorizationResponseBuilder {
+    using DocumentType = iso20_exiDocument;
+
+    // starts a new AuthorizationRes, previous content of the document is dropped
+    explicit AuthorizationResponseBuilder(iso20_exiDocument& document_);
+
+    AuthorizationResponseBuilder& set(const AuthorizationResponse&);
+
+    iso20_exiDocument& get_document() const {
+        return *document;
+    }
+
+private:
+    iso20_exiDocument* document;
+};
+
+template <> struct ResponseBuilderTrait<AuthorizationResponse> {
+    using type = AuthorizationResponseBuilder;
+};
+
+template <> size_t serialize(const AuthorizationResponseBuilder&, ResponseTemplates&, const io::StreamOutputView&);
+
 } // namespace iso15118::message_20
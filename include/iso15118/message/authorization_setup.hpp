@@ -4,7 +4,6 @@
 
 #include <array>
 #include <optional>
-#include <string>
 #include <variant>
 #include <vector>
 
@@ -31,7 +30,7 @@ struct AuthorizationSetupResponse {
     Header header;
     datatypes::ResponseCode response_code;
 
-    std::vector<datatypes::Authorization> authorization_services{datatypes::Authorization::EIM};
+    BoundedVector<datatypes::Authorization, 2> authorization_services{datatypes::Authorization::EIM};
     bool certificate_installation_service{false};
     std::variant<datatypes::EIM_ASResAuthorizationMode, datatypes::PnC_ASResAuthorizationMode> authorization_mode =
         datatypes::EIM_ASResAuthorizationMode();
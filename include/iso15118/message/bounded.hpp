@@ -0,0 +1,440 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace iso15118::message_20 {
+
+// String with the maximum length of its schema type, stored inline, so that decoding or building a message doesn't
+// allocate.  Exceeding the maximum length throws.
+template <std::size_t MaxLength> class BoundedString {
+public:
+    BoundedString() = default;
+
+    BoundedString(const char* value) {
+        assign(std::string_view(value));
+    }
+
+    BoundedString(std::string_view value) {
+        assign(value);
+    }
+
+    BoundedString(const std::string& value) {
+        assign(std::string_view(value));
+    }
+
+    BoundedString& operator=(const char* value) {
+        assign(std::string_view(value));
+        return *this;
+    }
+
+    BoundedString& operator=(std::string_view value) {
+        assign(value);
+        return *this;
+    }
+
+    BoundedString& operator=(const std::string& value) {
+        assign(std::string_view(value));
+        return *this;
+    }
+
+    void assign(std::string_view value) {
+        if (value.size() > MaxLength) {
+            throw std::runtime_error("String too long");
+        }
+
+        std::copy(value.begin(), value.end(), characters.begin());
+        characters[value.size()] = '\0';
+        length_ = value.size();
+    }
+
+    operator std::string_view() const {
+        return {characters.data(), length_};
+    }
+
+    explicit operator std::string() const {
+        return {characters.data(), length_};
+    }
+
+    const char* c_str() const {
+        return characters.data();
+    }
+
+    const char* data() const {
+        return characters.data();
+    }
+
+    std::size_t size() const {
+        return length_;
+    }
+
+    std::size_t length() const {
+        return length_;
+    }
+
+    bool empty() const {
+        return length_ == 0;
+    }
+
+    static constexpr std::size_t max_size() {
+        return MaxLength;
+    }
+
+    const char* begin() const {
+        return characters.data();
+    }
+
+    const char* end() const {
+        return characters.data() + length_;
+    }
+
+    int compare(std::string_view other) const {
+        return std::string_view(*this).compare(other);
+    }
+
+private:
+    std::array<char, MaxLength + 1> characters{};
+    std::size_t length_{0};
+};
+
+template <std::size_t MaxLength, std::size_t OtherMaxLength>
+bool operator==(const BoundedString<MaxLength>& lhs, const BoundedString<OtherMaxLength>& rhs) {
+    return std::string_view(lhs) == std::string_view(rhs);
+}
+
+template <std::size_t MaxLength, std::size_t OtherMaxLength>
+bool operator!=(const BoundedString<MaxLength>& lhs, const BoundedString<OtherMaxLength>& rhs) {
+    return not(lhs == rhs);
+}
+
+template <std::size_t MaxLength> bool operator==(const BoundedString<MaxLength>& lhs, std::string_view rhs) {
+    return std::string_view(lhs) == rhs;
+}
+
+template <std::size_t MaxLength> bool operator==(std::string_view lhs, const BoundedString<MaxLength>& rhs) {
+    return lhs == std::string_view(rhs);
+}
+
+template <std::size_t MaxLength> bool operator!=(const BoundedString<MaxLength>& lhs, std::string_view rhs) {
+    return not(lhs == rhs);
+}
+
+template <std::size_t MaxLength> bool operator!=(std::string_view lhs, const BoundedString<MaxLength>& rhs) {
+    return not(lhs == rhs);
+}
+
+// Vector with the maximum number of elements of its schema type, stored inline.  Only meant for short lists of small
+// elements, long lists (e.g. the 1024 price rule stacks of a price schedule) are a BoundedHeapVector.  Exceeding the
+// maximum size throws.
+template <typename T, std::size_t MaxSize> class BoundedVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    BoundedVector() = default;
+
+    BoundedVector(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+    }
+
+    template <typename InputIt> void assign(InputIt first, InputIt last) {
+        clear();
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    void push_back(const T& value) {
+        emplace_back() = value;
+    }
+
+    void push_back(T&& value) {
+        emplace_back() = std::move(value);
+    }
+
+    template <typename... Args> T& emplace_back(Args&&... args) {
+        if (count == MaxSize) {
+            throw std::runtime_error("List too long");
+        }
+
+        auto& element = elements[count++];
+        element = T{std::forward<Args>(args)...};
+        return element;
+    }
+
+    void pop_back() {
+        --count;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    void resize(std::size_t size) {
+        if (size > MaxSize) {
+            throw std::runtime_error("List too long");
+        }
+
+        std::fill(elements.begin() + count, elements.begin() + std::max(size, count), T{});
+        count = size;
+    }
+
+    // nothing to allocate, only checks the bound
+    void reserve(std::size_t size) const {
+        if (size > MaxSize) {
+            throw std::runtime_error("List too long");
+        }
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    static constexpr std::size_t max_size() {
+        return MaxSize;
+    }
+
+    static constexpr std::size_t capacity() {
+        return MaxSize;
+    }
+
+    T& operator[](std::size_t index) {
+        return elements[index];
+    }
+
+    const T& operator[](std::size_t index) const {
+        return elements[index];
+    }
+
+    T& at(std::size_t index) {
+        if (index >= count) {
+            throw std::out_of_range("Index out of range");
+        }
+        return elements[index];
+    }
+
+    const T& at(std::size_t index) const {
+        if (index >= count) {
+            throw std::out_of_range("Index out of range");
+        }
+        return elements[index];
+    }
+
+    T& front() {
+        return elements[0];
+    }
+
+    const T& front() const {
+        return elements[0];
+    }
+
+    T& back() {
+        return elements[count - 1];
+    }
+
+    const T& back() const {
+        return elements[count - 1];
+    }
+
+    T* data() {
+        return elements.data();
+    }
+
+    const T* data() const {
+        return elements.data();
+    }
+
+    iterator begin() {
+        return elements.data();
+    }
+
+    iterator end() {
+        return elements.data() + count;
+    }
+
+    const_iterator begin() const {
+        return elements.data();
+    }
+
+    const_iterator end() const {
+        return elements.data() + count;
+    }
+
+private:
+    std::array<T, MaxSize> elements{};
+    std::size_t count{0};
+};
+
+template <typename T, std::size_t MaxSize>
+bool operator==(const BoundedVector<T, MaxSize>& lhs, const BoundedVector<T, MaxSize>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t MaxSize>
+bool operator!=(const BoundedVector<T, MaxSize>& lhs, const BoundedVector<T, MaxSize>& rhs) {
+    return not(lhs == rhs);
+}
+
+// Vector with the maximum number of elements of its schema type, like BoundedVector, but the elements are allocated on
+// the heap and take only the memory of the actual content.  Meant for long lists of large elements, which are mostly
+// short in practice.  Exceeding the maximum size throws.
+template <typename T, std::size_t MaxSize> class BoundedHeapVector {
+public:
+    using value_type = T;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    BoundedHeapVector() = default;
+
+    BoundedHeapVector(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+    }
+
+    template <typename InputIt> void assign(InputIt first, InputIt last) {
+        clear();
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    void push_back(const T& value) {
+        check_size(elements.size() + 1);
+        elements.push_back(value);
+    }
+
+    void push_back(T&& value) {
+        check_size(elements.size() + 1);
+        elements.push_back(std::move(value));
+    }
+
+    template <typename... Args> T& emplace_back(Args&&... args) {
+        check_size(elements.size() + 1);
+        elements.push_back(T{std::forward<Args>(args)...});
+        return elements.back();
+    }
+
+    void pop_back() {
+        elements.pop_back();
+    }
+
+    void clear() {
+        elements.clear();
+    }
+
+    void resize(std::size_t size) {
+        check_size(size);
+        elements.resize(size);
+    }
+
+    void reserve(std::size_t size) {
+        check_size(size);
+        elements.reserve(size);
+    }
+
+    std::size_t size() const {
+        return elements.size();
+    }
+
+    bool empty() const {
+        return elements.empty();
+    }
+
+    static constexpr std::size_t max_size() {
+        return MaxSize;
+    }
+
+    std::size_t capacity() const {
+        return elements.capacity();
+    }
+
+    T& operator[](std::size_t index) {
+        return elements[index];
+    }
+
+    const T& operator[](std::size_t index) const {
+        return elements[index];
+    }
+
+    T& at(std::size_t index) {
+        return elements.at(index);
+    }
+
+    const T& at(std::size_t index) const {
+        return elements.at(index);
+    }
+
+    T& front() {
+        return elements.front();
+    }
+
+    const T& front() const {
+        return elements.front();
+    }
+
+    T& back() {
+        return elements.back();
+    }
+
+    const T& back() const {
+        return elements.back();
+    }
+
+    T* data() {
+        return elements.data();
+    }
+
+    const T* data() const {
+        return elements.data();
+    }
+
+    iterator begin() {
+        return elements.begin();
+    }
+
+    iterator end() {
+        return elements.end();
+    }
+
+    const_iterator begin() const {
+        return elements.begin();
+    }
+
+    const_iterator end() const {
+        return elements.end();
+    }
+
+private:
+    static void check_size(std::size_t size) {
+        if (size > MaxSize) {
+            throw std::runtime_error("List too long");
+        }
+    }
+
+    std::vector<T> elements;
+};
+
+template <typename T, std::size_t MaxSize>
+bool operator==(const BoundedHeapVector<T, MaxSize>& lhs, const BoundedHeapVector<T, MaxSize>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t MaxSize>
+bool operator!=(const BoundedHeapVector<T, MaxSize>& lhs, const BoundedHeapVector<T, MaxSize>& rhs) {
+    return not(lhs == rhs);
+}
+
+} // namespace iso15118::message_20
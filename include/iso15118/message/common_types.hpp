@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 
+#include "bounded.hpp"
+
 namespace iso15118::message_20 {
 
 template <typename InType, typename OutType> void convert(const InType&, OutType&);
@@ -16,21 +18,21 @@ namespace datatypes {
 
 using PercentValue = uint8_t;    // [0 - 100]
 using NumericId = uint32_t;      // [1 - 4294967295]
-using Identifier = std::string;  // MaxLength: 255
-using Name = std::string;        // MaxLength: 80
-using Description = std::string; // MaxLength: 160
+using Identifier = BoundedString<255>;
+using Name = BoundedString<80>;
+using Description = BoundedString<160>;
 
 static constexpr auto SESSION_ID_LENGTH = 8;
 using SessionId = std::array<uint8_t, SESSION_ID_LENGTH>;
 
-using MeterId = std::string;        // MaxLength: 32
-using MeterSignature = std::string; // Base64 encoded, MaxLength: 64
+using MeterId = BoundedString<32>;
+using MeterSignature = BoundedString<64>; // Base64 encoded
 
 static constexpr auto GEN_CHALLENGE_LENGTH = 16;
 using GenChallenge = std::array<uint8_t, GEN_CHALLENGE_LENGTH>; // Base64 encoded, MaxLength: 16
 
-using Certificate = std::string;                 // Base64 encoded, MaxLength: 1600
-using SubCertificate = std::vector<Certificate>; // Max: 3
+using Certificate = BoundedString<1600>; // Base64 encoded
+using SubCertificate = BoundedVector<Certificate, 3>;
 
 enum class ResponseCode {
     OK = 0,
@@ -291,7 +293,7 @@ struct Receipt {
     std::optional<DetailedCost> occupany_costs;
     std::optional<DetailedCost> additional_service_costs;
     std::optional<DetailedCost> overstay_costs;
-    std::vector<DetailedTax> tax_costs; // 0 to 10 elements! // FIXME(sl): optional?
+    BoundedVector<DetailedTax, 10> tax_costs; // FIXME(sl): optional?
 };
 
 struct X509IssuerSerial {
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "response_builder.hpp"
+#include "response_template.hpp"
 
 namespace iso15118::message_20 {
 
@@ -17,4 +19,27 @@ struct DC_CableCheckResponse {
     datatypes::Processing processing{datatypes::Processing::Ongoing};
 };
 
+// Writes a DC_CableCheckRes directly into the cbv2g document, which is encoded
+struct DC_CableCheckResponseBuilder {
+    using DocumentType = iso20_dc_exiDocument;
+
+    // starts a new DC_CableCheckRes, previous content of the document is dropped
+    explicit DC_CableCheckResponseBuilder(iso20_dc_exiDocument& document_);
+
+    DC_CableCheckResponseBuilder& set(const DC_CableCheckResponse&);
+
+    iso20_dc_exiDocument& get_document() const {
+        return *document;
+    }
+
+private:
+    iso20_dc_exiDocument* document;
+};
+
+template <> struct ResponseBuilderTrait<DC_CableCheckResponse> {
+    using type = DC_CableCheckResponseBuilder;
+};
+
+template <> size_t serialize(const DC_CableCheckResponseBuilder&, ResponseTemplates&, const io::StreamOutputView&);
+
 } // namespace iso15118::message_20
@@ -6,6 +6,11 @@
 #include <vector>
 
 #include "common_types.hpp"
+#include "response_builder.hpp"
+#include "response_template.hpp"
+
+// decoded cbv2g message, read by the view
+struct iso20_dc_DC_ChargeLoopReqType;
 
 namespace iso15118::message_20 {
 
@@ -87,6 +92,42 @@ struct DC_ChargeLoopRequest {
         control_mode;
 };
 
+// Read-only view of a decoded DC_ChargeLoopReq, the fields are read from the decoded cbv2g message on access instead
+// of converting the whole message up front.
+// NOTE: only valid until the variant, which decoded the message, decodes the next one
+struct DC_ChargeLoopRequestView {
+    using ControlMode = decltype(DC_ChargeLoopRequest::control_mode);
+    using SessionIdBytes = uint8_t[datatypes::SESSION_ID_LENGTH];
+
+    explicit DC_ChargeLoopRequestView(const iso20_dc_DC_ChargeLoopReqType& message_) : message(&message_) {
+    }
+
+    // refers into the decoded message
+    const SessionIdBytes& get_session_id() const;
+    uint64_t get_timestamp() const;
+    bool get_meter_info_requested() const;
+    datatypes::RationalNumber get_present_voltage() const;
+
+    // cheaper than get_control_mode(), if only the kind of control mode is of interest
+    template <typename ControlModeType> bool holds_control_mode() const;
+
+    // converted on every call, only meant for the feedback of the request
+    std::optional<datatypes::DisplayParameters> get_display_parameters() const;
+    ControlMode get_control_mode() const;
+
+private:
+    const iso20_dc_DC_ChargeLoopReqType* message;
+};
+
+template <>
+bool DC_ChargeLoopRequestView::holds_control_mode<datatypes::Scheduled_DC_CLReqControlMode>() const;
+template <>
+bool DC_ChargeLoopRequestView::holds_control_mode<datatypes::BPT_Scheduled_DC_CLReqControlMode>() const;
+template <>
+bool DC_ChargeLoopRequestView::holds_control_mode<datatypes::Dynamic_DC_CLReqControlMode>() const;
+template <>
+bool DC_ChargeLoopRequestView::holds_control_mode<datatypes::BPT_Dynamic_DC_CLReqControlMode>() const;
+
 struct DC_ChargeLoopResponse {
     Header header;
     datatypes::ResponseCode response_code;
@@ -107,4 +148,50 @@ struct DC_ChargeLoopResponse {
         control_mode = datatypes::Scheduled_DC_CLResControlMode();
 };
 
+// Writes a DC_ChargeLoopRes directly into the cbv2g document, which is encoded.  The defaults are the same as the ones
+// of DC_ChargeLoopResponse.
+struct DC_ChargeLoopResponseBuilder {
+    using DocumentType = iso20_dc_exiDocument;
+
+    // starts a new DC_ChargeLoopRes, previous content of the document is dropped
+    explicit DC_ChargeLoopResponseBuilder(iso20_dc_exiDocument& document_);
+
+    DC_ChargeLoopResponseBuilder& header(const Header&);
+    DC_ChargeLoopResponseBuilder& response_code(datatypes::ResponseCode);
+
+    DC_ChargeLoopResponseBuilder& status(const datatypes::EvseStatus&);
+    DC_ChargeLoopResponseBuilder& meter_info(const datatypes::MeterInfo&);
+    DC_ChargeLoopResponseBuilder& receipt(const datatypes::Receipt&);
+
+    DC_ChargeLoopResponseBuilder& present_current(const datatypes::RationalNumber&);
+    DC_ChargeLoopResponseBuilder& present_voltage(const datatypes::RationalNumber&);
+    DC_ChargeLoopResponseBuilder& power_limit_achieved(bool);
+    DC_ChargeLoopResponseBuilder& current_limit_achieved(bool);
+    DC_ChargeLoopResponseBuilder& voltage_limit_achieved(bool);
+
+    // replaces the previously set control mode
+    DC_ChargeLoopResponseBuilder& control_mode(const datatypes::Scheduled_DC_CLResControlMode&);
+    DC_ChargeLoopResponseBuilder& control_mode(const datatypes::BPT_Scheduled_DC_CLResControlMode&);
+    DC_ChargeLoopResponseBuilder& control_mode(const datatypes::Dynamic_DC_CLResControlMode&);
+    DC_ChargeLoopResponseBuilder& control_mode(const datatypes::BPT_Dynamic_DC_CLResControlMode&);
+
+    // all fields at once
+    DC_ChargeLoopResponseBuilder& set(const DC_ChargeLoopResponse&);
+    // reads all fields back from the document
+    DC_ChargeLoopResponse get() const;
+
+    iso20_dc_exiDocument& get_document() const {
+        return *document;
+    }
+
+private:
+    iso20_dc_exiDocument* document;
+};
+
+template <> struct ResponseBuilderTrait<DC_ChargeLoopResponse> {
+    using type = DC_ChargeLoopResponseBuilder;
+};
+
+template <> size_t serialize(const DC_ChargeLoopResponseBuilder&, ResponseTemplates&, const io::StreamOutputView&);
+
 } // namespace iso15118::message_20
@@ -3,6 +3,11 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "response_builder.hpp"
+#include "response_template.hpp"
+
+// decoded cbv2g message, read by the view
+struct iso20_dc_DC_PreChargeReqType;
 
 namespace iso15118::message_20 {
 
@@ -14,6 +19,21 @@ struct DC_PreChargeRequest {
     datatypes::RationalNumber target_voltage;
 };
 
+// Read-only view of a decoded DC_PreChargeReq, the fields are read from the decoded cbv2g message on access
+// NOTE: only valid until the variant, which decoded the message, decodes the next one
+struct DC_PreChargeRequestView {
+    explicit DC_PreChargeRequestView(const iso20_dc_DC_PreChargeReqType& message_) : message(&message_) {
+    }
+
+    Header get_header() const;
+    datatypes::Processing get_processing() const;
+    datatypes::RationalNumber get_present_voltage() const;
+    datatypes::RationalNumber get_target_voltage() const;
+
+private:
+    const iso20_dc_DC_PreChargeReqType* message;
+};
+
 struct DC_PreChargeResponse {
     Header header;
     datatypes::ResponseCode response_code;
@@ -21,4 +41,27 @@ struct DC_PreChargeResponse {
     datatypes::RationalNumber present_voltage;
 };
 
+// Writes a DC_PreChargeRes directly into the cbv2g document, which is encoded
+struct DC_PreChargeResponseBuilder {
+    using DocumentType = iso20_dc_exiDocument;
+
+    // starts a new DC_PreChargeRes, previous content of the document is dropped
+    explicit DC_PreChargeResponseBuilder(iso20_dc_exiDocument& document_);
+
+    DC_PreChargeResponseBuilder& set(const DC_PreChargeResponse&);
+
+    iso20_dc_exiDocument& get_document() const {
+        return *document;
+    }
+
+private:
+    iso20_dc_exiDocument* document;
+};
+
+template <> struct ResponseBuilderTrait<DC_PreChargeResponse> {
+    using type = DC_PreChargeResponseBuilder;
+};
+
+template <> size_t serialize(const DC_PreChargeResponseBuilder&, ResponseTemplates&, const io::StreamOutputView&);
+
 } // namespace iso15118::message_20
@@ -2,12 +2,17 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
+#include <cstddef>
+#include <memory_resource>
 #include <optional>
 #include <variant>
 #include <vector>
 
 #include "common_types.hpp"
 
+// decoded cbv2g message, read by the view
+struct iso20_PowerDeliveryReqType;
+
 namespace iso15118::message_20 {
 
 namespace datatypes {
@@ -34,9 +39,13 @@ struct Scheduled_EVPPTControlMode {
 };
 
 struct PowerProfile {
+    PowerProfile() = default;
+    explicit PowerProfile(std::pmr::memory_resource* resource) : entries(resource) {
+    }
+
     uint64_t time_anchor;
     std::variant<Dynamic_EVPPTControlMode, Scheduled_EVPPTControlMode> control_mode;
-    std::vector<PowerScheduleEntry> entries; // maximum 2048
+    std::pmr::vector<PowerScheduleEntry> entries; // maximum 2048, allocated from the resource of the variant
 };
 
 enum class ChannelSelection : uint8_t {
@@ -56,6 +65,30 @@ struct PowerDeliveryRequest {
     std::optional<datatypes::ChannelSelection> channel_selection;
 };
 
+// Read-only view of a decoded PowerDeliveryReq, the fields are read from the decoded cbv2g message on access.  The
+// entries of the power profile (up to 2048) can be read one by one, so they don't need to be copied into a vector.
+// NOTE: only valid until the variant, which decoded the message, decodes the next one
+struct PowerDeliveryRequestView {
+    explicit PowerDeliveryRequestView(const iso20_PowerDeliveryReqType& message_) : message(&message_) {
+    }
+
+    Header get_header() const;
+    datatypes::Processing get_processing() const;
+    datatypes::Progress get_charge_progress() const;
+
+    // the entries are allocated from the given resource
+    std::optional<datatypes::PowerProfile>
+    get_power_profile(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+    // 0 if there is no power profile
+    std::size_t get_power_profile_entry_count() const;
+    datatypes::PowerScheduleEntry get_power_profile_entry(std::size_t index) const;
+
+    std::optional<datatypes::ChannelSelection> get_channel_selection() const;
+
+private:
+    const iso20_PowerDeliveryReqType* message;
+};
+
 struct PowerDeliveryResponse {
     Header header;
     datatypes::ResponseCode response_code;
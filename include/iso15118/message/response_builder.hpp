@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <memory>
+
+// cbv2g documents, the builders write into
+struct appHand_exiDocument;
+struct iso20_exiDocument;
+struct iso20_dc_exiDocument;
+struct iso20_ac_exiDocument;
+
+namespace iso15118::message_20 {
+
+// Maps a response type to its builder (if there is one).  A builder writes the response directly into the cbv2g
+// document, which is encoded afterwards, instead of filling the response type first and converting it field by field
+// on serialization.  Each builder can also be filled from its response type, so both can be used to respond.
+template <typename ResponseType> struct ResponseBuilderTrait {
+    using type = void;
+};
+
+// The cbv2g documents of the builders.  Only one response is built at a time, so all schemas share one allocation,
+// which is made on first use and then reused for every response.
+class ResponseDocuments {
+public:
+    ResponseDocuments();
+    ~ResponseDocuments();
+
+    ResponseDocuments(const ResponseDocuments&) = delete;
+    ResponseDocuments& operator=(const ResponseDocuments&) = delete;
+
+    // the builder is valid until the next one is created
+    template <typename BuilderType> BuilderType create_builder() {
+        return BuilderType(get<typename BuilderType::DocumentType>());
+    }
+
+private:
+    template <typename DocumentType> DocumentType& get();
+
+    union Storage;
+    std::unique_ptr<Storage> storage;
+};
+
+template <> appHand_exiDocument& ResponseDocuments::get();
+template <> iso20_exiDocument& ResponseDocuments::get();
+template <> iso20_dc_exiDocument& ResponseDocuments::get();
+template <> iso20_ac_exiDocument& ResponseDocuments::get();
+
+} // namespace iso15118::message_20
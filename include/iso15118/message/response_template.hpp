@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "type.hpp"
+
+namespace iso15118::message_20 {
+
+class ExiTemplate;
+
+// The encoded responses of an exchange, one per response type.  Responses, which hardly change from one cycle to the
+// next (like DC_ChargeLoopRes), are patched into their previous encoding instead of being encoded again (see
+// detail/exi_template.hpp).
+//
+// The responses of the session setup, which only depend on the configuration of the EVSE and the request (like
+// ServiceDiscoveryRes), can be taken from templates shared by all sessions of the same configuration.  Apart from the
+// first session, only their header is patched.
+class ResponseTemplates {
+public:
+    ResponseTemplates();
+    explicit ResponseTemplates(std::shared_ptr<ResponseTemplates> shared_templates);
+    ~ResponseTemplates();
+
+    ResponseTemplates(const ResponseTemplates&) = delete;
+    ResponseTemplates& operator=(const ResponseTemplates&) = delete;
+
+    // created on first use, the variant tells apart responses of the same type, which usually differ (e.g. the
+    // ServiceDetailRes per service)
+    ExiTemplate& get(Type, uint16_t variant = 0);
+
+private:
+    struct Entry {
+        Type type;
+        uint16_t variant;
+        std::unique_ptr<ExiTemplate> exi_template;
+    };
+
+    std::vector<Entry> templates;
+    std::shared_ptr<ResponseTemplates> shared;
+};
+
+// encodes by patching the template of the response, if there is a specialization for the message type, otherwise
+// it is encoded as usual
+template <typename MessageType>
+size_t serialize(const MessageType& msg, ResponseTemplates&, const io::StreamOutputView& out) {
+    return serialize(msg, out);
+}
+
+} // namespace iso15118::message_20
@@ -2,12 +2,13 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
-#include <array>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <variant>
 #include <vector>
 
+#include "bounded.hpp"
 #include "common_types.hpp"
 
 namespace iso15118::message_20 {
@@ -24,8 +25,8 @@ static constexpr auto SCHEDULED_POWER_DURATION_S = 86400;
 
 using MaxSupportingPointsScheduleTuple = uint16_t; // needs to be [12 - 1024]
 
-using Curreny = std::string;  // MaxLength: 3
-using Language = std::string; // MaxLength: 3
+using Curreny = BoundedString<3>;
+using Language = BoundedString<3>;
 
 struct TaxRule {
     NumericId tax_rule_id;
@@ -49,7 +50,7 @@ struct PriceRule {
 
 struct PriceRuleStack {
     uint32_t duration;
-    std::array<PriceRule, PRICE_RULE_LENGTH> price_rule;
+    BoundedVector<PriceRule, PRICE_RULE_LENGTH> price_rule;
 };
 
 struct AdditionalService {
@@ -57,9 +58,10 @@ struct AdditionalService {
     RationalNumber service_fee;
 };
 
-using TaxRuleList = std::array<TaxRule, TAX_RULE_LENGTH>;
-using PriceRuleStackList = std::array<PriceRuleStack, PRICE_RULE_STACK_LENGTH>;
-using AdditionalServiceList = std::array<AdditionalService, ADDITIONAL_SERVICE_LENGTH>;
+// sized to their content
+using TaxRuleList = BoundedHeapVector<TaxRule, TAX_RULE_LENGTH>;
+using PriceRuleStackList = BoundedHeapVector<PriceRuleStack, PRICE_RULE_STACK_LENGTH>;
+using AdditionalServiceList = BoundedHeapVector<AdditionalService, ADDITIONAL_SERVICE_LENGTH>;
 
 struct Dynamic_SEReqControlMode {
     uint32_t departure_time;
@@ -77,9 +79,14 @@ struct EVPowerScheduleEntry {
     RationalNumber power;
 };
 
+// the lists of the requests are allocated from the memory resource of the variant they are decoded into
 struct EVPowerSchedule {
+    EVPowerSchedule() = default;
+    explicit EVPowerSchedule(std::pmr::memory_resource* resource) : entries(resource) {
+    }
+
     uint64_t time_anchor;
-    std::vector<EVPowerScheduleEntry> entries; // max 1024
+    std::pmr::vector<EVPowerScheduleEntry> entries; // max 1024
 };
 
 struct EVPriceRule {
@@ -89,17 +96,26 @@ struct EVPriceRule {
 
 struct EVPriceRuleStack {
     uint32_t duration;
-    std::vector<EVPriceRule> price_rules; // max 8
+    BoundedVector<EVPriceRule, PRICE_RULE_LENGTH> price_rules;
 };
 
 struct EVAbsolutePriceSchedule {
+    EVAbsolutePriceSchedule() = default;
+    explicit EVAbsolutePriceSchedule(std::pmr::memory_resource* resource) : price_rule_stacks(resource) {
+    }
+
     uint64_t time_anchor;
     Curreny currency;
     Identifier price_algorithm;
-    std::vector<EVPriceRuleStack> price_rule_stacks; // max 1024
+    std::pmr::vector<EVPriceRuleStack> price_rule_stacks; // max 1024
 };
 
 struct EVEnergyOffer {
+    EVEnergyOffer() = default;
+    explicit EVEnergyOffer(std::pmr::memory_resource* resource) :
+        power_schedule(resource), absolute_price_schedule(resource) {
+    }
+
     EVPowerSchedule power_schedule;
     EVAbsolutePriceSchedule absolute_price_schedule;
 };
@@ -122,7 +138,7 @@ struct OverstayRule {
 struct OverstayRulesList {
     std::optional<uint32_t> overstay_time_threshold;
     std::optional<RationalNumber> overstay_power_threshold;
-    std::vector<OverstayRule> overstay_rule;
+    BoundedHeapVector<OverstayRule, OVERSTAY_RULE_LENGTH> overstay_rule;
 };
 
 struct AbsolutePriceSchedule {
@@ -152,7 +168,7 @@ struct PriceLevelSchedule {
     NumericId price_schedule_id;
     std::optional<Description> price_schedule_description;
     uint8_t number_of_price_levels;
-    std::vector<PriceLevelScheduleEntry> price_level_schedule_entries;
+    BoundedHeapVector<PriceLevelScheduleEntry, PRICE_LEVEL_SCHEDULE_LENGTH> price_level_schedule_entries;
 };
 
 struct Dynamic_SEResControlMode {
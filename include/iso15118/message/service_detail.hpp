@@ -2,11 +2,12 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
-#include <string>
 #include <variant>
 #include <vector>
 
 #include "common_types.hpp"
+#include "response_builder.hpp"
+#include "response_template.hpp"
 
 namespace iso15118::message_20 {
 
@@ -19,7 +20,7 @@ struct Parameter {
 
 struct ParameterSet {
     uint16_t id;
-    std::vector<Parameter> parameter;
+    BoundedVector<Parameter, 16> parameter;
 
     ParameterSet();
     ParameterSet(uint16_t _id, const DcParameterList& list);
@@ -44,4 +45,27 @@ struct ServiceDetailResponse {
     datatypes::ServiceParameterList service_parameter_list = {datatypes::ParameterSet()};
 };
 
+// Writes a ServiceDetailRes directly into the cbv2g document, which is encoded
+struct ServiceDetailResponseBuilder {
+    using DocumentType = iso20_exiDocument;
+
+    // starts a new ServiceDetailRes, previous content of the document is dropped
+    explicit ServiceDetailResponseBuilder(iso20_exiDocument& document_);
+
+    ServiceDetailResponseBuilder& set(const ServiceDetailResponse&);
+
+    iso20_exiDocument& get_document() const {
+        return *document;
+    }
+
+private:
+    iso20_exiDocument* document;
+};
+
+template <> struct ResponseBuilderTrait<ServiceDetailResponse> {
+    using type = ServiceDetailResponseBuilder;
+};
+
+template <> size_t serialize(const ServiceDetailResponseBuilder&, ResponseTemplates&, const io::StreamOutputView&);
+
 } // namespace iso15118::message_20
@@ -3,20 +3,21 @@
 #pragma once
 
 #include <optional>
-#include <vector>
 
 #include "common_types.hpp"
+#include "response_builder.hpp"
+#include "response_template.hpp"
 
 namespace iso15118::message_20 {
 
 namespace datatypes {
-using ServiceIdList = std::vector<std::uint16_t>; //
+using ServiceIdList = BoundedVector<std::uint16_t, 16>;
 
 struct Service {
     ServiceCategory service_id;
     bool free_service;
 };
-using ServiceList = std::vector<Service>; // max: 8
+using ServiceList = BoundedVector<Service, 8>;
 
 } // namespace datatypes
 
@@ -37,4 +38,27 @@ struct ServiceDiscoveryResponse {
     std::optional<datatypes::ServiceList> vas_list;
 };
 
+// Writes a ServiceDiscoveryRes directly into the cbv2g document, which is encoded
+struct ServiceDiscoveryResponseBuilder {
+    using DocumentType = iso20_exiDocument;
+
+    // starts a new ServiceDiscoveryRes, previous content of the document is dropped
+    explicit ServiceDiscoveryResponseBuilder(iso20_exiDocument& document_);
+
+    ServiceDiscoveryResponseBuilder& set(const ServiceDiscoveryResponse&);
+
+    iso20_exiDocument& get_document() const {
+        return *document;
+    }
+
+private:
+    iso20_exiDocument* document;
+};
+
+template <> struct ResponseBuilderTrait<ServiceDiscoveryResponse> {
+    using type = ServiceDiscoveryResponseBuilder;
+};
+
+template <> size_t serialize(const ServiceDiscoveryResponseBuilder&, ResponseTemplates&, const io::StreamOutputView&);
+
 } // namespace iso15118::message_20
@@ -3,7 +3,6 @@
 #pragma once
 
 #include <optional>
-#include <vector>
 
 #include "common_types.hpp"
 
@@ -16,7 +15,7 @@ struct SelectedService {
     uint16_t parameter_set_id;
 };
 
-using SelectedServiceList = std::vector<SelectedService>; // Max: 16
+using SelectedServiceList = BoundedVector<SelectedService, 16>;
 
 } // namespace datatypes
 
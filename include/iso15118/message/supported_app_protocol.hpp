@@ -4,23 +4,25 @@
 
 #include <cstddef>
 #include <optional>
-#include <string>
-#include <vector>
 
 #include <iso15118/io/stream_view.hpp>
 
+#include "bounded.hpp"
+#include "response_builder.hpp"
+#include "response_template.hpp"
+
 namespace iso15118::message_20 {
 
 struct SupportedAppProtocolRequest {
     struct SupportedAppProtocol {
-        std::string protocol_namespace;
+        BoundedString<100> protocol_namespace;
         uint32_t version_number_major;
         uint32_t version_number_minor;
         uint8_t schema_id;
         uint8_t priority;
     };
 
-    std::vector<SupportedAppProtocol> app_protocol;
+    BoundedVector<SupportedAppProtocol, 20> app_protocol;
 };
 
 struct SupportedAppProtocolResponse {
@@ -36,4 +38,28 @@ struct SupportedAppProtocolResponse {
 
 size_t encode_supported_app_protocol_response(const io::StreamOutputView&, const SupportedAppProtocolResponse&);
 
+// Writes a supportedAppProtocolRes directly into the cbv2g document, which is encoded
+struct SupportedAppProtocolResponseBuilder {
+    using DocumentType = appHand_exiDocument;
+
+    // starts a new supportedAppProtocolRes, previous content of the document is dropped
+    explicit SupportedAppProtocolResponseBuilder(appHand_exiDocument& document_);
+
+    SupportedAppProtocolResponseBuilder& set(const SupportedAppProtocolResponse&);
+
+    appHand_exiDocument& get_document() const {
+        return *document;
+    }
+
+private:
+    appHand_exiDocument* document;
+};
+
+template <> struct ResponseBuilderTrait<SupportedAppProtocolResponse> {
+    using type = SupportedAppProtocolResponseBuilder;
+};
+
+template <>
+size_t serialize(const SupportedAppProtocolResponseBuilder&, ResponseTemplates&, const io::StreamOutputView&);
+
 } // namespace iso15118::message_20
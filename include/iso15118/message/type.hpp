@@ -2,6 +2,11 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+
+#include <iso15118/io/sdp.hpp>
 #include <iso15118/io/stream_view.hpp>
 
 namespace iso15118::message_20 {
@@ -44,66 +49,130 @@ enum class Type {
     AC_ChargeLoopRes,
 };
 
-template <typename T> struct TypeTrait {
-    static const Type type = Type::None;
-};
+// number of message types (including None)
+static constexpr auto TYPE_COUNT = static_cast<std::size_t>(Type::AC_ChargeLoopRes) + 1;
 
 template <typename InType, typename OutType> void convert(const InType&, OutType&);
+// for messages with lists, which are allocated from the given resource
+template <typename InType, typename OutType> void convert(const InType&, OutType&, std::pmr::memory_resource*);
 
 template <typename MessageType> size_t serialize(const MessageType&, const io::StreamOutputView&);
 
+namespace detail {
+template <typename... Types> struct TypeList {};
+} // namespace detail
+
+// A request, its response and the payload type both are sent with
+template <typename RequestType, Type request_type_, typename ResponseType, Type response_type_,
+          io::v2gtp::PayloadType payload_type_>
+struct MessageExchangeEntry {
+    using Request = RequestType;
+    using Response = ResponseType;
+    static constexpr Type request_type = request_type_;
+    static constexpr Type response_type = response_type_;
+    static constexpr io::v2gtp::PayloadType payload_type = payload_type_;
+
+    template <typename T> static constexpr bool contains = std::is_same_v<T, Request> or std::is_same_v<T, Response>;
+};
+
+// A type standing for a message, e.g. the read-only view of a decoded request or the builder of a response
+template <typename AliasType, typename MessageType> struct MessageAliasEntry {
+    using Alias = AliasType;
+    using Message = MessageType;
+};
+
 //
-// definitions of type traits
+// registry of all messages
+//
+// The type traits below, the decoder tables and the sequence error responses are derived from it, so a new message
+// only needs to be added here (the struct keyword forward declares the message types).
 //
-#ifdef CREATE_TYPE_TRAIT
-#define CREATE_TYPE_TRAIT_PUSHED CREATE_TYPE_TRAIT
-#endif
-
-#define CREATE_TYPE_TRAIT(struct_name, enum_name)                                                                      \
-    struct struct_name;                                                                                                \
-    template <> struct TypeTrait<struct_name> {                                                                        \
-        static const Type type = Type::enum_name;                                                                      \
+#define MESSAGE_EXCHANGE(name, payload_type)                                                                           \
+    MessageExchangeEntry<struct name##Request, Type::name##Req, struct name##Response, Type::name##Res,                \
+                         io::v2gtp::PayloadType::payload_type>
+
+#define MESSAGE_ALIAS(alias, message) MessageAliasEntry<struct alias, message>
+
+using MessageExchanges = detail::TypeList<MESSAGE_EXCHANGE(SupportedAppProtocol, SAP),
+                                          MESSAGE_EXCHANGE(SessionSetup, Part20Main),
+                                          MESSAGE_EXCHANGE(AuthorizationSetup, Part20Main),
+                                          MESSAGE_EXCHANGE(Authorization, Part20Main),
+                                          MESSAGE_EXCHANGE(ServiceDiscovery, Part20Main),
+                                          MESSAGE_EXCHANGE(ServiceDetail, Part20Main),
+                                          MESSAGE_EXCHANGE(ServiceSelection, Part20Main),
+                                          MESSAGE_EXCHANGE(DC_ChargeParameterDiscovery, Part20DC),
+                                          MESSAGE_EXCHANGE(ScheduleExchange, Part20Main),
+                                          MESSAGE_EXCHANGE(DC_CableCheck, Part20DC),
+                                          MESSAGE_EXCHANGE(DC_PreCharge, Part20DC),
+                                          MESSAGE_EXCHANGE(PowerDelivery, Part20Main),
+                                          MESSAGE_EXCHANGE(DC_ChargeLoop, Part20DC),
+                                          MESSAGE_EXCHANGE(DC_WeldingDetection, Part20DC),
+                                          MESSAGE_EXCHANGE(SessionStop, Part20Main),
+                                          MESSAGE_EXCHANGE(AC_ChargeParameterDiscovery, Part20AC),
+                                          MESSAGE_EXCHANGE(AC_ChargeLoop, Part20AC)>;
+
+using MessageAliases = detail::TypeList<
+    // read-only views of decoded messages
+    MESSAGE_ALIAS(DC_PreChargeRequestView, DC_PreChargeRequest),
+    MESSAGE_ALIAS(PowerDeliveryRequestView, PowerDeliveryRequest),
+    MESSAGE_ALIAS(DC_ChargeLoopRequestView, DC_ChargeLoopRequest),
+    // builders of responses
+    MESSAGE_ALIAS(SupportedAppProtocolResponseBuilder, SupportedAppProtocolResponse),
+    MESSAGE_ALIAS(AuthorizationResponseBuilder, AuthorizationResponse),
+    MESSAGE_ALIAS(ServiceDiscoveryResponseBuilder, ServiceDiscoveryResponse),
+    MESSAGE_ALIAS(ServiceDetailResponseBuilder, ServiceDetailResponse),
+    MESSAGE_ALIAS(DC_CableCheckResponseBuilder, DC_CableCheckResponse),
+    MESSAGE_ALIAS(DC_PreChargeResponseBuilder, DC_PreChargeResponse),
+    MESSAGE_ALIAS(DC_ChargeLoopResponseBuilder, DC_ChargeLoopResponse)>;
+
+#undef MESSAGE_EXCHANGE
+#undef MESSAGE_ALIAS
+
+namespace detail {
+
+template <typename T, typename Aliases> struct ResolveAlias {
+    using type = T;
+};
+
+template <typename T, typename First, typename... Rest> struct ResolveAlias<T, TypeList<First, Rest...>> {
+    using type = std::conditional_t<std::is_same_v<T, typename First::Alias>, typename First::Message,
+                                    typename ResolveAlias<T, TypeList<Rest...>>::type>;
+};
+
+template <typename T, typename Exchanges> struct FindExchange {
+    using type = void;
+};
+
+template <typename T, typename First, typename... Rest> struct FindExchange<T, TypeList<First, Rest...>> {
+    using type = std::conditional_t<First::template contains<T>, First,
+                                    typename FindExchange<T, TypeList<Rest...>>::type>;
+};
+
+template <typename Exchange, typename T> constexpr Type get_type() {
+    if constexpr (std::is_void_v<Exchange>) {
+        return Type::None;
+    } else if constexpr (std::is_same_v<T, typename Exchange::Request>) {
+        return Exchange::request_type;
+    } else {
+        return Exchange::response_type;
     }
+}
+
+} // namespace detail
 
-CREATE_TYPE_TRAIT(SupportedAppProtocolRequest, SupportedAppProtocolReq);
-CREATE_TYPE_TRAIT(SupportedAppProtocolResponse, SupportedAppProtocolRes);
-CREATE_TYPE_TRAIT(SessionSetupRequest, SessionSetupReq);
-CREATE_TYPE_TRAIT(SessionSetupResponse, SessionSetupRes);
-CREATE_TYPE_TRAIT(AuthorizationSetupRequest, AuthorizationSetupReq);
-CREATE_TYPE_TRAIT(AuthorizationSetupResponse, AuthorizationSetupRes);
-CREATE_TYPE_TRAIT(AuthorizationRequest, AuthorizationReq);
-CREATE_TYPE_TRAIT(AuthorizationResponse, AuthorizationRes);
-CREATE_TYPE_TRAIT(ServiceDiscoveryRequest, ServiceDiscoveryReq);
-CREATE_TYPE_TRAIT(ServiceDiscoveryResponse, ServiceDiscoveryRes);
-CREATE_TYPE_TRAIT(ServiceDetailRequest, ServiceDetailReq);
-CREATE_TYPE_TRAIT(ServiceDetailResponse, ServiceDetailRes);
-CREATE_TYPE_TRAIT(ServiceSelectionRequest, ServiceSelectionReq);
-CREATE_TYPE_TRAIT(ServiceSelectionResponse, ServiceSelectionRes);
-CREATE_TYPE_TRAIT(DC_ChargeParameterDiscoveryRequest, DC_ChargeParameterDiscoveryReq);
-CREATE_TYPE_TRAIT(DC_ChargeParameterDiscoveryResponse, DC_ChargeParameterDiscoveryRes);
-CREATE_TYPE_TRAIT(ScheduleExchangeRequest, ScheduleExchangeReq);
-CREATE_TYPE_TRAIT(ScheduleExchangeResponse, ScheduleExchangeRes);
-CREATE_TYPE_TRAIT(DC_CableCheckRequest, DC_CableCheckReq);
-CREATE_TYPE_TRAIT(DC_CableCheckResponse, DC_CableCheckRes);
-CREATE_TYPE_TRAIT(DC_PreChargeRequest, DC_PreChargeReq);
-CREATE_TYPE_TRAIT(DC_PreChargeResponse, DC_PreChargeRes);
-CREATE_TYPE_TRAIT(PowerDeliveryRequest, PowerDeliveryReq);
-CREATE_TYPE_TRAIT(PowerDeliveryResponse, PowerDeliveryRes);
-CREATE_TYPE_TRAIT(DC_ChargeLoopRequest, DC_ChargeLoopReq);
-CREATE_TYPE_TRAIT(DC_ChargeLoopResponse, DC_ChargeLoopRes);
-CREATE_TYPE_TRAIT(DC_WeldingDetectionRequest, DC_WeldingDetectionReq);
-CREATE_TYPE_TRAIT(DC_WeldingDetectionResponse, DC_WeldingDetectionRes);
-CREATE_TYPE_TRAIT(SessionStopRequest, SessionStopReq);
-CREATE_TYPE_TRAIT(SessionStopResponse, SessionStopRes);
-CREATE_TYPE_TRAIT(AC_ChargeParameterDiscoveryRequest, AC_ChargeParameterDiscoveryReq);
-CREATE_TYPE_TRAIT(AC_ChargeParameterDiscoveryResponse, AC_ChargeParameterDiscoveryRes);
-CREATE_TYPE_TRAIT(AC_ChargeLoopRequest, AC_ChargeLoopReq);
-CREATE_TYPE_TRAIT(AC_ChargeLoopResponse, AC_ChargeLoopRes);
-
-#ifdef CREATE_TYPE_TRAIT_PUSHED
-#define CREATE_TYPE_TRAIT CREATE_TYPE_TRAIT_PUSHED
-#else
-#undef CREATE_TYPE_TRAIT
-#endif
+// the message itself (or the one an alias stands for)
+template <typename T> using MessageOf = typename detail::ResolveAlias<T, MessageAliases>::type;
+
+// the exchange of a message (or of an alias), void if the message is not registered
+template <typename T> using MessageExchangeOf = typename detail::FindExchange<MessageOf<T>, MessageExchanges>::type;
+
+template <typename Request> using ResponseOf = typename MessageExchangeOf<Request>::Response;
+
+//
+// definitions of type traits
+//
+template <typename T> struct TypeTrait {
+    static constexpr Type type = detail::get_type<MessageExchangeOf<T>, MessageOf<T>>();
+};
 
 } // namespace iso15118::message_20
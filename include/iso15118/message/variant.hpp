@@ -2,52 +2,144 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <stdexcept>
-#include <string>
+#include <type_traits>
+#include <variant>
 
 // FIXME (aw): we only need the payload types from sdp.hpp, this could be shared in a separate header file
 #include <iso15118/io/sdp.hpp>
 #include <iso15118/io/stream_view.hpp>
 
+#include "ac_charge_loop.hpp"
+#include "ac_charge_parameter_discovery.hpp"
+#include "authorization.hpp"
+#include "authorization_setup.hpp"
+#include "dc_cable_check.hpp"
+#include "dc_charge_loop.hpp"
+#include "dc_charge_parameter_discovery.hpp"
+#include "dc_pre_charge.hpp"
+#include "dc_welding_detection.hpp"
+#include "power_delivery.hpp"
+#include "schedule_exchange.hpp"
+#include "service_detail.hpp"
+#include "service_discovery.hpp"
+#include "service_selection.hpp"
+#include "session_setup.hpp"
+#include "session_stop.hpp"
+#include "supported_app_protocol.hpp"
 #include "type.hpp"
 
 namespace iso15118::message_20 {
 
+// messages, which are decoded into a read-only view of the decoded cbv2g message.  Their owning type is only converted
+// from the view, if it is accessed
+template <typename T> struct ViewTrait {
+    using type = void;
+};
+
+template <> struct ViewTrait<DC_PreChargeRequest> {
+    using type = DC_PreChargeRequestView;
+};
+
+template <> struct ViewTrait<PowerDeliveryRequest> {
+    using type = PowerDeliveryRequestView;
+};
+
+template <> struct ViewTrait<DC_ChargeLoopRequest> {
+    using type = DC_ChargeLoopRequestView;
+};
+
+// storage of the decoded cbv2g documents
+union DocumentScratch;
+
+// Holds one decoded message in place.  The storage is large enough for every message that can be decoded, so
+// decoding into an existing variant (as done by the MessageExchange for every request) doesn't allocate.  The lists of
+// the messages, which are too long to be stored in place, are std::pmr containers and allocated from the memory
+// resource of the variant.
 class Variant {
 public:
-    using CustomDeleter = void (*)(void*);
+    using Storage =
+        std::variant<std::monostate, SupportedAppProtocolRequest, SessionSetupRequest, SessionSetupResponse,
+                     AuthorizationSetupRequest, AuthorizationSetupResponse, AuthorizationRequest, AuthorizationResponse,
+                     ServiceDiscoveryRequest, ServiceDiscoveryResponse, ServiceDetailRequest, ServiceDetailResponse,
+                     ServiceSelectionRequest, ServiceSelectionResponse, DC_ChargeParameterDiscoveryRequest,
+                     ScheduleExchangeRequest, DC_CableCheckRequest, DC_PreChargeRequestView, PowerDeliveryRequestView,
+                     DC_ChargeLoopRequestView, DC_WeldingDetectionRequest, SessionStopRequest,
+                     AC_ChargeParameterDiscoveryRequest, AC_ChargeLoopRequest>;
+
+    static constexpr std::size_t MAX_ERROR_LENGTH = 64;
+    using ErrorMessage = std::array<char, MAX_ERROR_LENGTH>;
+
+    Variant();
+    // the resource has to outlive the decoded message (until the next decode, reset or destruction of the variant)
+    explicit Variant(std::pmr::memory_resource*);
     Variant(io::v2gtp::PayloadType, const io::StreamInputView&);
     ~Variant();
 
+    Variant(const Variant&) = delete;
+    Variant& operator=(const Variant&) = delete;
+
+    // replaces the current message, on failure the variant is left empty (Type::None)
+    void decode(io::v2gtp::PayloadType, const io::StreamInputView&);
+
+    void reset();
+
     Type get_type() const;
 
-    const std::string& get_error() const;
+    const char* get_error() const;
 
     template <typename T> const T& get() const {
-        static_assert(TypeTrait<T>::type != Type::None, "Unhandled type!");
-        if (TypeTrait<T>::type != type) {
+        const auto data = get_if<T>();
+        if (data == nullptr) {
             throw std::runtime_error("Illegal message type access");
         }
 
-        return *static_cast<T*>(data);
+        return *data;
     }
 
+    // T can either be the owning type or (if there is one) the view type of a message
     template <typename T> T const* get_if() const {
         static_assert(TypeTrait<T>::type != Type::None, "Unhandled type!");
-        if (TypeTrait<T>::type != type) {
-            return nullptr;
-        }
 
-        return static_cast<T*>(data);
+        using ViewType = typename ViewTrait<T>::type;
+        if constexpr (std::is_void_v<ViewType>) {
+            return std::get_if<T>(&storage);
+        } else {
+            const auto view = std::get_if<ViewType>(&storage);
+            if (view == nullptr) {
+                return nullptr;
+            }
+
+            return &get_converted<T>(*view);
+        }
     }
 
 private:
-    CustomDeleter custom_deleter{nullptr};
-    void* data{nullptr};
+    template <typename T, typename ViewType> const T& get_converted(const ViewType& view) const {
+        if (const auto data = std::get_if<T>(&converted)) {
+            return *data;
+        }
+
+        auto& data = converted.template emplace<T>();
+        convert(view, data, resource);
+        return data;
+    }
+
+    Storage storage;
     Type type{Type::None};
-    std::string error;
+    ErrorMessage error{};
+
+    // owning types of the messages, which have been decoded into a view
+    mutable std::variant<std::monostate, DC_PreChargeRequest, PowerDeliveryRequest, DC_ChargeLoopRequest> converted;
+
+    // allocated on the first decode
+    std::unique_ptr<DocumentScratch> scratch;
+
+    std::pmr::memory_resource* resource{std::pmr::new_delete_resource()};
 };
 } // namespace iso15118::message_20
@@ -17,6 +17,7 @@
 #include <iso15118/io/poll_manager.hpp>
 #include <iso15118/io/sdp_packet.hpp>
 #include <iso15118/io/time.hpp>
+#include <iso15118/io/v2gtp_framer.hpp>
 
 #include <iso15118/session/feedback.hpp>
 #include <iso15118/session/logger.hpp>
@@ -24,36 +25,54 @@
 namespace iso15118 {
 
 struct SessionState {
+    bool accepted{false}; // the EV connected to the offered endpoint
     bool connected{false};
     bool new_data{false};
     bool fsm_needs_call{false};
+    std::optional<d20::Event> timeout{std::nullopt};
+    std::optional<session::feedback::Signal> close_signal{std::nullopt}; // set while the connection is closing
+};
+
+struct SessionTimers {
+    std::optional<io::TimerId> idle;
+    std::optional<io::TimerId> sequence;
+    std::optional<io::TimerId> performance;
 };
 
 class Session {
 public:
-    Session(std::unique_ptr<io::IConnection>, d20::SessionConfig, const session::feedback::Callbacks&);
+    // the shared response templates (if any) need to belong to the same configuration
+    Session(io::PollManager&, std::unique_ptr<io::IConnection>, d20::SessionConfig,
+            const session::feedback::Callbacks&, std::shared_ptr<message_20::ResponseTemplates> = nullptr);
     ~Session();
 
+    // returns the time point, the session needs to be polled again at the latest (TimePoint::max() if it only
+    // waits for io or timer events)
     TimePoint const& poll();
     void push_control_event(const d20::ControlEvent&);
 
     bool is_finished() const {
-        return ctx.session_stopped;
+        return ctx.session_stopped and not state.connected;
+    }
+
+    // true until the EV connected to the endpoint, which was offered by SDP
+    bool is_waiting_for_connection() const {
+        return not state.accepted and not ctx.session_stopped;
     }
 
 private:
+    io::PollManager& poll_manager;
     std::unique_ptr<io::IConnection> connection;
     session::SessionLogger log;
 
     SessionState state;
     // input buffer
-    io::SdpPacket packet;
+    io::V2gtpFramer framer;
 
     // output buffer
     uint8_t response_buffer[1028];
 
-    d20::MessageExchange message_exchange{{response_buffer + io::SdpPacket::V2GTP_HEADER_SIZE,
-                                           sizeof(response_buffer) - io::SdpPacket::V2GTP_HEADER_SIZE}};
+    d20::MessageExchange message_exchange;
 
     // control event buffer
     d20::ControlEventQueue control_event_queue;
@@ -65,6 +84,14 @@ private:
 
     TimePoint next_session_event;
 
+    SessionTimers timers;
+
+    void start_timer(std::optional<io::TimerId>&, int32_t timeout_ms, d20::Event);
+    void stop_timer(std::optional<io::TimerId>&);
+    void handle_timeout(d20::Event);
+    void close_connection(session::feedback::Signal);
+    void send_pending_response();
+
     void handle_connection_event(io::ConnectionEvent event);
 };
 
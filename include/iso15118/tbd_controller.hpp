@@ -2,8 +2,11 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -11,9 +14,11 @@
 #include <iso15118/d20/config.hpp>
 #include <iso15118/d20/control_event.hpp>
 #include <iso15118/d20/limits.hpp>
+#include <iso15118/io/listener.hpp>
 #include <iso15118/io/poll_manager.hpp>
 #include <iso15118/io/sdp_server.hpp>
 #include <iso15118/message/common_types.hpp>
+#include <iso15118/message/response_template.hpp>
 #include <iso15118/session/feedback.hpp>
 #include <iso15118/session/iso.hpp>
 
@@ -21,38 +26,112 @@ namespace iso15118 {
 
 struct TbdConfig {
     config::SSLConfig ssl{config::CertificateBackend::EVEREST_LAYOUT, {}, {}, {}, {}, {}, {}};
+    // only used by the single connector constructor
     std::string interface_name;
     config::TlsNegotiationStrategy tls_negotiation_strategy{config::TlsNegotiationStrategy::ACCEPT_CLIENT_OFFER};
     bool enable_sdp_server{true};
 };
 
+// one connector (outlet) is served on exactly one (PLC) interface
+struct TbdConnectorConfig {
+    std::string interface_name;
+    session::feedback::Callbacks callbacks;
+    d20::EvseSetupConfig evse_setup;
+};
+
+// index into the connector list, the controller was constructed with
+using ConnectorId = std::size_t;
+
 class TbdController {
 public:
     TbdController(TbdConfig, session::feedback::Callbacks, d20::EvseSetupConfig);
+    TbdController(TbdConfig, std::vector<TbdConnectorConfig>);
 
+    // returns after stop() has been called
     void loop();
 
+    // thread safe
+    void stop();
+
+    // NOTE: the following functions are thread safe, the changes are applied by the event loop
+    // NOTE: the overloads without a connector id address the first connector
     void send_control_event(const d20::ControlEvent&);
+    void send_control_event(ConnectorId, const d20::ControlEvent&);
 
     void update_authorization_services(const std::vector<message_20::datatypes::Authorization>& services,
                                        bool cert_install_service);
+    void update_authorization_services(ConnectorId,
+                                       const std::vector<message_20::datatypes::Authorization>& services,
+                                       bool cert_install_service);
+
     void update_dc_limits(const d20::DcTransferLimits&);
+    void update_dc_limits(ConnectorId, const d20::DcTransferLimits&);
+
+    auto get_connector_count() const {
+        return connectors.size();
+    }
 
 private:
+    // the endpoint, which was offered to an EV by SDP, retries of this EV get the same answer
+    struct SdpOffer {
+        sockaddr_in6 peer_address;
+        io::v2gtp::Security security;
+        io::Ipv6EndPoint end_point;
+    };
+
+    // changes made by the caller's thread, which are applied by the event loop (guarded by update_mutex)
+    struct PendingUpdates {
+        // the caller's view of the evse setup, copied to the connector, if changed
+        d20::EvseSetupConfig evse_setup;
+        bool evse_setup_changed{false};
+        bool templates_changed{false};
+        std::vector<d20::ControlEvent> control_events;
+    };
+
+    struct Connector {
+        std::string interface_name;
+        session::feedback::Callbacks callbacks;
+        d20::EvseSetupConfig evse_setup;
+        PendingUpdates pending;
+
+        // encoded session setup responses, shared by all sessions of the current evse setup (version)
+        std::shared_ptr<message_20::ResponseTemplates> response_templates;
+
+        // opened once, the sessions accept their connection from these
+        std::unique_ptr<io::Listener> tcp_listener;
+        std::unique_ptr<io::Listener> tls_listener;
+        // the address (and scope) the listeners are bound to, std::nullopt if there are no listeners
+        std::optional<sockaddr_in6> listener_address;
+
+        std::optional<SdpOffer> sdp_offer;
+        std::unique_ptr<Session> session;
+    };
+
     io::PollManager poll_manager;
+    std::atomic_bool stop_requested{false};
+
+    std::vector<Connector> connectors;
+    std::mutex update_mutex;
+
+    // serves all connectors, the requests are routed by their ingress interface
     std::unique_ptr<io::SdpServer> sdp_server;
 
-    std::unique_ptr<Session> session;
+    Connector& get_connector(ConnectorId);
+    void apply_pending_updates();
+    void open_listeners(Connector&);
+    // reopens the listeners of connectors, whose interface got a new address or index (e.g. a re-plugged PLC modem)
+    void handle_interface_change();
+    void start_session_without_sdp(Connector&);
+    // drops the session of a connector after an error, without affecting the other connectors
+    void abort_session(Connector&);
 
     // callbacks for sdp server
     void handle_sdp_server_input();
+    Connector* find_connector_by_interface(unsigned int interface_index);
+    void handle_sdp_request(Connector&, io::PeerRequestContext&);
+    static bool is_retry_of_pending_offer(const Connector&, const io::PeerRequestContext&);
 
     const TbdConfig config;
-    const session::feedback::Callbacks callbacks;
-
-    d20::EvseSetupConfig evse_setup;
-
-    std::string interface_name;
 };
 
 } // namespace iso15118
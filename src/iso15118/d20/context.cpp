@@ -4,6 +4,7 @@
 
 #include <stdexcept>
 
+#include <iso15118/d20/states.hpp>
 #include <iso15118/detail/helper.hpp>
 
 namespace iso15118::d20 {
@@ -16,21 +17,29 @@ std::unique_ptr<MessageExchange> create_message_exchange(uint8_t* buf, const siz
 MessageExchange::MessageExchange(io::StreamOutputView output_) : response(std::move(output_)) {
 }
 
-void MessageExchange::set_request(std::unique_ptr<message_20::Variant> new_request) {
-    if (request) {
+MessageExchange::MessageExchange(io::StreamOutputView output_,
+                                 std::shared_ptr<message_20::ResponseTemplates> shared_templates) :
+    response_templates(std::move(shared_templates)), response(std::move(output_)) {
+}
+
+void MessageExchange::set_request(io::v2gtp::PayloadType payload_type, const io::StreamInputView& payload) {
+    if (request_available) {
         // FIXME (aw): we might want to have a stack here?
         throw std::runtime_error("Previous V2G message has not been handled yet");
     }
 
-    request = std::move(new_request);
+    release_request();
+    request.decode(payload_type, payload);
+    request_available = true;
 }
 
-std::unique_ptr<message_20::Variant> MessageExchange::pull_request() {
-    if (not request) {
+const message_20::Variant& MessageExchange::pull_request() {
+    if (not request_available) {
         throw std::runtime_error("Tried to access V2G message, but there is none");
     }
 
-    return std::move(request);
+    request_available = false;
+    return request;
 }
 
 std::tuple<bool, size_t, io::v2gtp::PayloadType, message_20::Type> MessageExchange::check_and_clear_response() {
@@ -40,15 +49,57 @@ std::tuple<bool, size_t, io::v2gtp::PayloadType, message_20::Type> MessageExchan
     response_size = 0;
     response_type = message_20::Type::None;
 
+    if (not request_available) {
+        release_request();
+    }
+
     return retval;
 }
 
+void MessageExchange::release_request() {
+    // the decoded message has to go first, its lists point into the arena
+    request.reset();
+    arena.release();
+}
+
 message_20::Type MessageExchange::peek_request_type() const {
-    if (not request) {
+    if (not request_available) {
         logf_warning("Tried to access V2G message, but there is none");
         return message_20::Type::None;
     }
-    return request->get_type();
+    return request.get_type();
+}
+
+void* StatePool::allocate(std::size_t size) {
+    for (auto& slot : slots) {
+        if (not slot.used) {
+            slot.used = true;
+            return slot.data.data();
+        }
+    }
+
+    return ::operator new(size);
+}
+
+void StatePool::deallocate(void* memory) {
+    for (auto& slot : slots) {
+        if (memory == slot.data.data()) {
+            slot.used = false;
+            return;
+        }
+    }
+
+    ::operator delete(memory);
+}
+
+void StateDeleter::operator()(StateBase* state) const {
+    if (pool == nullptr) {
+        delete state;
+        return;
+    }
+
+    state->~StateBase();
+    pool->deallocate(memory);
 }
 
 Context::Context(session::feedback::Callbacks feedback_callbacks, session::SessionLogger& logger,
@@ -61,7 +112,7 @@ Context::Context(session::feedback::Callbacks feedback_callbacks, session::Sessi
     message_exchange(message_exchange_) {
 }
 
-std::unique_ptr<message_20::Variant> Context::pull_request() {
+const message_20::Variant& Context::pull_request() {
     return message_exchange.pull_request();
 }
 
@@ -1,10 +1,16 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <ctime>
+#include <type_traits>
 
 #include <iso15118/detail/d20/context_helper.hpp>
 #include <iso15118/detail/helper.hpp>
 
+#include <iso15118/message/ac_charge_loop.hpp>
+#include <iso15118/message/ac_charge_parameter_discovery.hpp>
 #include <iso15118/message/authorization.hpp>
 #include <iso15118/message/authorization_setup.hpp>
 #include <iso15118/message/dc_cable_check.hpp>
@@ -19,6 +25,7 @@
 #include <iso15118/message/service_selection.hpp>
 #include <iso15118/message/session_setup.hpp>
 #include <iso15118/message/session_stop.hpp>
+#include <iso15118/message/supported_app_protocol.hpp>
 
 namespace iso15118::d20 {
 
@@ -34,6 +41,15 @@ bool validate_and_setup_header(message_20::Header& header, const Session& cur_se
     return (cur_session.get_id() == req_session_id);
 }
 
+bool validate_and_setup_header(message_20::Header& header, const Session& cur_session,
+                               const uint8_t (&req_session_id)[message_20::datatypes::SESSION_ID_LENGTH]) {
+
+    setup_header(header, cur_session);
+
+    const auto& session_id = cur_session.get_id();
+    return std::equal(session_id.begin(), session_id.end(), std::begin(req_session_id));
+}
+
 void setup_header(message_20::Header& header, const Session& cur_session) {
     header.session_id = cur_session.get_id();
     setup_timestamp(header);
@@ -45,54 +61,48 @@ template <typename Response> Response handle_sequence_error(const d20::Session&
     return response_with_code(res, message_20::datatypes::ResponseCode::FAILED_SequenceError);
 }
 
+namespace {
+
+using SequenceErrorHandler = void (*)(d20::Context&);
+
+template <typename Response> void respond_sequence_error(d20::Context& ctx) {
+    const auto res = handle_sequence_error<Response>(ctx.session);
+    ctx.respond(res);
+}
+
+// only the -20 messages (i.e. not the supportedAppProtocol) have a response code for sequence errors
+template <typename Response> constexpr SequenceErrorHandler get_sequence_error_handler() {
+    if constexpr (std::is_same_v<decltype(Response::response_code), message_20::datatypes::ResponseCode>) {
+        return &respond_sequence_error<Response>;
+    } else {
+        return nullptr;
+    }
+}
+
+template <typename... Exchanges>
+constexpr auto make_sequence_error_handlers(message_20::detail::TypeList<Exchanges...>) {
+    std::array<SequenceErrorHandler, message_20::TYPE_COUNT> handlers{};
+    ((handlers[static_cast<std::size_t>(Exchanges::request_type)] =
+          get_sequence_error_handler<typename Exchanges::Response>()),
+     ...);
+    return handlers;
+}
+
+// indexed by the type of the request
+constexpr auto SEQUENCE_ERROR_HANDLERS = make_sequence_error_handlers(message_20::MessageExchanges{});
+
+} // namespace
+
 // Todo(sl): Not happy at all. Need refactoring. Only ctx.respond and Session is needed. Not the whole Context.
 void send_sequence_error(const message_20::Type req_type, d20::Context& ctx) {
+    const auto index = static_cast<std::size_t>(req_type);
 
-    if (req_type == message_20::Type::SessionSetupReq) {
-        const auto res = handle_sequence_error<message_20::SessionSetupResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::AuthorizationSetupReq) {
-        const auto res = handle_sequence_error<message_20::AuthorizationSetupResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::AuthorizationReq) {
-        const auto res = handle_sequence_error<message_20::AuthorizationResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::ServiceDiscoveryReq) {
-        const auto res = handle_sequence_error<message_20::ServiceDiscoveryResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::ServiceDetailReq) {
-        const auto res = handle_sequence_error<message_20::ServiceDetailResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::ServiceSelectionReq) {
-        const auto res = handle_sequence_error<message_20::ServiceSelectionResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::DC_ChargeParameterDiscoveryReq) {
-        const auto res = handle_sequence_error<message_20::DC_ChargeParameterDiscoveryResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::ScheduleExchangeReq) {
-        const auto res = handle_sequence_error<message_20::ScheduleExchangeResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::DC_CableCheckReq) {
-        const auto res = handle_sequence_error<message_20::DC_CableCheckResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::PowerDeliveryReq) {
-        const auto res = handle_sequence_error<message_20::PowerDeliveryResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::DC_PreChargeReq) {
-        const auto res = handle_sequence_error<message_20::DC_PreChargeResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::DC_ChargeLoopReq) {
-        const auto res = handle_sequence_error<message_20::DC_ChargeLoopResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::DC_WeldingDetectionReq) {
-        const auto res = handle_sequence_error<message_20::DC_WeldingDetectionResponse>(ctx.session);
-        ctx.respond(res);
-    } else if (req_type == message_20::Type::SessionStopReq) {
-        const auto res = handle_sequence_error<message_20::SessionStopResponse>(ctx.session);
-        ctx.respond(res);
-    } else {
+    if (index >= SEQUENCE_ERROR_HANDLERS.size() or SEQUENCE_ERROR_HANDLERS[index] == nullptr) {
         logf_warning("Unknown code type id: %d ", req_type);
+        return;
     }
+
+    SEQUENCE_ERROR_HANDLERS[index](ctx);
 }
 
 } // namespace iso15118::d20
@@ -97,9 +97,9 @@ Result Authorization::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::AuthorizationRequest>()) {
+    if (const auto req = variant.get_if<message_20::AuthorizationRequest>()) {
         const auto res = handle_request(*req, m_ctx.session, authorization_status);
 
         m_ctx.respond(res);
@@ -115,17 +115,17 @@ Result Authorization::feed(Event ev) {
         } else {
             return {};
         }
-    } else if (const auto req = variant->get_if<message_20::SessionStopRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::SessionStopRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
         m_ctx.respond(res);
 
         m_ctx.session_stopped = true;
         return {};
     } else {
-        m_ctx.log("expected AuthorizationReq! But code type id: %d", variant->get_type());
+        m_ctx.log("expected AuthorizationReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
@@ -31,10 +31,10 @@ message_20::AuthorizationSetupResponse handle_request(const message_20::Authoriz
         logf_warning("authorization_services was not set. Setting EIM as auth_mode");
         res.authorization_services = {dt::Authorization::EIM};
     } else {
-        res.authorization_services = authorization_services;
+        res.authorization_services.assign(authorization_services.begin(), authorization_services.end());
     }
 
-    session.offered_services.auth_services = res.authorization_services;
+    session.offered_services.auth_services.assign(res.authorization_services.begin(), res.authorization_services.end());
 
     if (res.authorization_services.size() == 1 && res.authorization_services[0] == dt::Authorization::EIM) {
         res.authorization_mode.emplace<dt::EIM_ASResAuthorizationMode>();
@@ -63,9 +63,9 @@ Result AuthorizationSetup::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::AuthorizationSetupRequest>()) {
+    if (const auto req = variant.get_if<message_20::AuthorizationSetupRequest>()) {
         const auto res = handle_request(*req, m_ctx.session, m_ctx.session_config.cert_install_service,
                                         m_ctx.session_config.authorization_services);
 
@@ -82,7 +82,7 @@ Result AuthorizationSetup::feed(Event ev) {
         m_ctx.feedback.signal(session::feedback::Signal::REQUIRE_AUTH_EIM);
 
         return m_ctx.create_state<Authorization>();
-    } else if (const auto req = variant->get_if<message_20::SessionStopRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::SessionStopRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -90,10 +90,10 @@ Result AuthorizationSetup::feed(Event ev) {
 
         return {};
     } else {
-        m_ctx.log("expected AuthorizationSetupReq! But code type id: %d", variant->get_type());
+        m_ctx.log("expected AuthorizationSetupReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
@@ -52,9 +52,9 @@ Result DC_CableCheck::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::DC_CableCheckRequest>()) {
+    if (const auto req = variant.get_if<message_20::DC_CableCheckRequest>()) {
         if (not cable_check_initiated) {
             m_ctx.feedback.signal(session::feedback::Signal::START_CABLE_CHECK);
             cable_check_initiated = true;
@@ -74,7 +74,7 @@ Result DC_CableCheck::feed(Event ev) {
         } else {
             return {};
         }
-    } else if (const auto req = variant->get_if<message_20::SessionStopRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::SessionStopRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -82,10 +82,10 @@ Result DC_CableCheck::feed(Event ev) {
 
         return {};
     } else {
-        m_ctx.log("expected DC_CableCheckReq! But code type id: %d", variant->get_type());
+        m_ctx.log("expected DC_CableCheckReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
@@ -84,16 +84,39 @@ void set_dynamic_parameters_in_res(T& res_mode, const UpdateDynamicModeParameter
 }
 } // namespace
 
-message_20::DC_ChargeLoopResponse handle_request(const message_20::DC_ChargeLoopRequest& req,
-                                                 const d20::Session& session, const float present_voltage,
-                                                 const float present_current, const bool stop,
-                                                 const DcTransferLimits& dc_limits,
-                                                 const UpdateDynamicModeParameters& dynamic_parameters) {
+namespace {
+template <typename ControlModeType> bool holds_control_mode(const message_20::DC_ChargeLoopRequest& req) {
+    return std::holds_alternative<ControlModeType>(req.control_mode);
+}
+
+template <typename ControlModeType> bool holds_control_mode(const message_20::DC_ChargeLoopRequestView& req) {
+    return req.holds_control_mode<ControlModeType>();
+}
+
+const dt::SessionId& get_session_id(const message_20::DC_ChargeLoopRequest& req) {
+    return req.header.session_id;
+}
+
+const message_20::DC_ChargeLoopRequestView::SessionIdBytes&
+get_session_id(const message_20::DC_ChargeLoopRequestView& req) {
+    return req.get_session_id();
+}
+} // namespace
 
-    message_20::DC_ChargeLoopResponse res;
+template <typename RequestType>
+dt::ResponseCode handle_charge_loop_request(const RequestType& req, const d20::Session& session,
+                                            const float present_voltage, const float present_current,
+                                            const bool stop, const DcTransferLimits& dc_limits,
+                                            const UpdateDynamicModeParameters& dynamic_parameters,
+                                            message_20::DC_ChargeLoopResponseBuilder& res) {
 
-    if (validate_and_setup_header(res.header, session, req.header.session_id) == false) {
-        return response_with_code(res, dt::ResponseCode::FAILED_UnknownSession);
+    message_20::Header header;
+    const auto header_valid = validate_and_setup_header(header, session, get_session_id(req));
+    res.header(header);
+
+    if (header_valid == false) {
+        res.response_code(dt::ResponseCode::FAILED_UnknownSession);
+        return dt::ResponseCode::FAILED_UnknownSession;
     }
 
     const auto selected_services = session.get_selected_services();
@@ -101,83 +124,104 @@ message_20::DC_ChargeLoopResponse handle_request(const message_20::DC_ChargeLoop
     const auto selected_energy_service = selected_services.selected_energy_service;
     const auto selected_mobility_needs_mode = selected_services.selected_mobility_needs_mode;
 
-    if (std::holds_alternative<Scheduled_DC_Req>(req.control_mode)) {
+    if (holds_control_mode<Scheduled_DC_Req>(req)) {
 
         // If the ev sends a false control mode or a false energy service other than the previous selected ones, then
         // the charger should terminate the session
         if (selected_control_mode != dt::ControlMode::Scheduled or selected_energy_service != dt::ServiceCategory::DC) {
-            return response_with_code(res, dt::ResponseCode::FAILED);
+            res.response_code(dt::ResponseCode::FAILED);
+            return dt::ResponseCode::FAILED;
         }
 
-        auto& res_mode = res.control_mode.emplace<Scheduled_DC_Res>();
+        Scheduled_DC_Res res_mode{};
         convert(res_mode, dc_limits);
+        res.control_mode(res_mode);
 
-    } else if (std::holds_alternative<Scheduled_BPT_DC_Req>(req.control_mode)) {
+    } else if (holds_control_mode<Scheduled_BPT_DC_Req>(req)) {
 
         // If the ev sends a false control mode or a false energy service other than the previous selected ones, then
         // the charger should terminate the session
         if (selected_control_mode != dt::ControlMode::Scheduled or
             selected_energy_service != dt::ServiceCategory::DC_BPT) {
-            return response_with_code(res, dt::ResponseCode::FAILED);
+            res.response_code(dt::ResponseCode::FAILED);
+            return dt::ResponseCode::FAILED;
         }
 
         if (not dc_limits.discharge_limits.has_value()) {
             logf_error("Transfer mode is BPT, but only dc limits without discharge limits are provided!");
-            return response_with_code(res, dt::ResponseCode::FAILED);
+            res.response_code(dt::ResponseCode::FAILED);
+            return dt::ResponseCode::FAILED;
         }
 
-        auto& res_mode = res.control_mode.emplace<Scheduled_BPT_DC_Res>();
+        Scheduled_BPT_DC_Res res_mode{};
         convert(res_mode, dc_limits);
+        res.control_mode(res_mode);
 
-    } else if (std::holds_alternative<Dynamic_DC_Req>(req.control_mode)) {
+    } else if (holds_control_mode<Dynamic_DC_Req>(req)) {
 
         // If the ev sends a false control mode or a false energy service other than the previous selected ones, then
         // the charger should terminate the session
         if (selected_control_mode != dt::ControlMode::Dynamic or selected_energy_service != dt::ServiceCategory::DC) {
-            return response_with_code(res, dt::ResponseCode::FAILED);
+            res.response_code(dt::ResponseCode::FAILED);
+            return dt::ResponseCode::FAILED;
         }
 
-        auto& res_mode = res.control_mode.emplace<Dynamic_DC_Res>();
+        Dynamic_DC_Res res_mode{};
         convert(res_mode, dc_limits);
 
         if (selected_mobility_needs_mode == dt::MobilityNeedsMode::ProvidedBySecc) {
-            set_dynamic_parameters_in_res(res_mode, dynamic_parameters, res.header.timestamp);
+            set_dynamic_parameters_in_res(res_mode, dynamic_parameters, header.timestamp);
         }
 
-    } else if (std::holds_alternative<Dynamic_BPT_DC_Req>(req.control_mode)) {
+        res.control_mode(res_mode);
+
+    } else if (holds_control_mode<Dynamic_BPT_DC_Req>(req)) {
 
         // If the ev sends a false control mode or a false energy service other than the previous selected ones, then
         // the charger should terminate the session
         if (selected_control_mode != dt::ControlMode::Dynamic or
             selected_energy_service != dt::ServiceCategory::DC_BPT) {
-            return response_with_code(res, dt::ResponseCode::FAILED);
+            res.response_code(dt::ResponseCode::FAILED);
+            return dt::ResponseCode::FAILED;
         }
 
         if (not dc_limits.discharge_limits.has_value()) {
             logf_error("Transfer mode is BPT, but only dc limits without discharge limits are provided!");
-            return response_with_code(res, dt::ResponseCode::FAILED);
+            res.response_code(dt::ResponseCode::FAILED);
+            return dt::ResponseCode::FAILED;
         }
 
-        auto& res_mode = res.control_mode.emplace<Dynamic_BPT_DC_Res>();
+        Dynamic_BPT_DC_Res res_mode{};
         convert(res_mode, dc_limits);
 
         if (selected_mobility_needs_mode == dt::MobilityNeedsMode::ProvidedBySecc) {
-            set_dynamic_parameters_in_res(res_mode, dynamic_parameters, res.header.timestamp);
+            set_dynamic_parameters_in_res(res_mode, dynamic_parameters, header.timestamp);
         }
+
+        res.control_mode(res_mode);
     }
 
-    res.present_voltage = dt::from_float(present_voltage);
-    res.present_current = dt::from_float(present_current);
+    res.present_voltage(dt::from_float(present_voltage)).present_current(dt::from_float(present_current));
 
     // TODO(sl): Setting EvseStatus, MeterInfo, Receipt, *_limit_achieved
 
     if (stop) {
-        res.status = {0, dt::EvseNotification::Terminate};
+        res.status({0, dt::EvseNotification::Terminate});
     }
 
-    return response_with_code(res, dt::ResponseCode::OK);
+    res.response_code(dt::ResponseCode::OK);
+    return dt::ResponseCode::OK;
 }
 
+template dt::ResponseCode handle_charge_loop_request(const message_20::DC_ChargeLoopRequest&, const d20::Session&,
+                                                     float, float, bool, const DcTransferLimits&,
+                                                     const UpdateDynamicModeParameters&,
+                                                     message_20::DC_ChargeLoopResponseBuilder&);
+template dt::ResponseCode handle_charge_loop_request(const message_20::DC_ChargeLoopRequestView&, const d20::Session&,
+                                                     float, float, bool, const DcTransferLimits&,
+                                                     const UpdateDynamicModeParameters&,
+                                                     message_20::DC_ChargeLoopResponseBuilder&);
+
 void DC_ChargeLoop::enter() {
     m_ctx.log.enter_state("DC_ChargeLoop");
 }
@@ -203,9 +247,9 @@ Result DC_ChargeLoop::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::PowerDeliveryRequest>()) {
+    if (const auto req = variant.get_if<message_20::PowerDeliveryRequestView>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -219,42 +263,44 @@ Result DC_ChargeLoop::feed(Event ev) {
         first_entry_in_charge_loop = true;
 
         // Todo(sl): React properly to Start, Stop, Standby and ScheduleRenegotiation
-        if (req->charge_progress == dt::Progress::Stop) {
+        if (req->get_charge_progress() == dt::Progress::Stop) {
             m_ctx.feedback.signal(session::feedback::Signal::CHARGE_LOOP_FINISHED);
             m_ctx.feedback.signal(session::feedback::Signal::DC_OPEN_CONTACTOR);
             return m_ctx.create_state<DC_WeldingDetection>();
         }
 
         return {};
-    } else if (const auto req = variant->get_if<message_20::DC_ChargeLoopRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::DC_ChargeLoopRequestView>()) {
         if (first_entry_in_charge_loop) {
             m_ctx.feedback.signal(session::feedback::Signal::CHARGE_LOOP_STARTED);
             first_entry_in_charge_loop = false;
         }
 
-        const auto res = handle_request(*req, m_ctx.session, present_voltage, present_current, stop,
-                                        m_ctx.session_config.dc_limits, dynamic_parameters);
+        auto res = m_ctx.build_response<message_20::DC_ChargeLoopResponseBuilder>();
+        const auto response_code =
+            handle_charge_loop_request(*req, m_ctx.session, present_voltage, present_current, stop,
+                                       m_ctx.session_config.dc_limits, dynamic_parameters, res);
 
         m_ctx.respond(res);
 
-        if (res.response_code >= dt::ResponseCode::FAILED) {
+        if (response_code >= dt::ResponseCode::FAILED) {
             m_ctx.session_stopped = true;
             return {};
         }
 
-        m_ctx.feedback.dc_charge_loop_req(req->control_mode);
-        m_ctx.feedback.dc_charge_loop_req(req->present_voltage);
-        m_ctx.feedback.dc_charge_loop_req(req->meter_info_requested);
-        if (req->display_parameters) {
-            m_ctx.feedback.dc_charge_loop_req(*req->display_parameters);
+        m_ctx.feedback.dc_charge_loop_req(req->get_control_mode());
+        m_ctx.feedback.dc_charge_loop_req(req->get_present_voltage());
+        m_ctx.feedback.dc_charge_loop_req(req->get_meter_info_requested());
+        if (const auto display_parameters = req->get_display_parameters()) {
+            m_ctx.feedback.dc_charge_loop_req(*display_parameters);
         }
 
         return {};
     } else {
-        m_ctx.log("Expected PowerDeliveryReq or DC_ChargeLoopReq! But code type id: %d", variant->get_type());
+        m_ctx.log("Expected PowerDeliveryReq or DC_ChargeLoopReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
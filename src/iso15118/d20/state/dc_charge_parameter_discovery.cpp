@@ -93,9 +93,9 @@ Result DC_ChargeParameterDiscovery::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::DC_ChargeParameterDiscoveryRequest>()) {
+    if (const auto req = variant.get_if<message_20::DC_ChargeParameterDiscoveryRequest>()) {
 
         auto dc_max_limits = session::feedback::DcMaximumLimits{};
 
@@ -132,7 +132,7 @@ Result DC_ChargeParameterDiscovery::feed(Event ev) {
         }
 
         return m_ctx.create_state<ScheduleExchange>();
-    } else if (const auto req = variant->get_if<message_20::SessionStopRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::SessionStopRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -140,11 +140,11 @@ Result DC_ChargeParameterDiscovery::feed(Event ev) {
 
         return {};
     } else {
-        m_ctx.log("expected DC_ChargeParameterDiscovery! But code type id: %d", variant->get_type());
+        m_ctx.log("expected DC_ChargeParameterDiscovery! But code type id: %d", variant.get_type());
         m_ctx.session_stopped = true;
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         return {};
@@ -12,12 +12,13 @@ namespace iso15118::d20::state {
 
 namespace dt = message_20::datatypes;
 
-message_20::DC_PreChargeResponse handle_request(const message_20::DC_PreChargeRequest& req, const d20::Session& session,
-                                                const float present_voltage) {
+namespace {
+message_20::DC_PreChargeResponse handle_pre_charge_request(const dt::SessionId& session_id,
+                                                           const d20::Session& session, const float present_voltage) {
 
     message_20::DC_PreChargeResponse res;
 
-    if (validate_and_setup_header(res.header, session, req.header.session_id) == false) {
+    if (validate_and_setup_header(res.header, session, session_id) == false) {
         return response_with_code(res, dt::ResponseCode::FAILED_UnknownSession);
     }
 
@@ -25,6 +26,17 @@ message_20::DC_PreChargeResponse handle_request(const message_20::DC_PreChargeRe
 
     return response_with_code(res, dt::ResponseCode::OK);
 }
+} // namespace
+
+message_20::DC_PreChargeResponse handle_request(const message_20::DC_PreChargeRequest& req, const d20::Session& session,
+                                                const float present_voltage) {
+    return handle_pre_charge_request(req.header.session_id, session, present_voltage);
+}
+
+message_20::DC_PreChargeResponse handle_request(const message_20::DC_PreChargeRequestView& req,
+                                                const d20::Session& session, const float present_voltage) {
+    return handle_pre_charge_request(req.get_header().session_id, session, present_voltage);
+}
 
 void DC_PreCharge::enter() {
     m_ctx.log.enter_state("DC_PreCharge");
@@ -48,16 +60,17 @@ Result DC_PreCharge::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::DC_PreChargeRequest>()) {
+    if (const auto req = variant.get_if<message_20::DC_PreChargeRequestView>()) {
         if (not pre_charge_initiated) {
             m_ctx.feedback.signal(session::feedback::Signal::PRE_CHARGE_STARTED);
             pre_charge_initiated = true;
         }
         const auto res = handle_request(*req, m_ctx.session, present_voltage);
 
-        m_ctx.feedback.dc_pre_charge_target_voltage(message_20::datatypes::from_RationalNumber(req->target_voltage));
+        m_ctx.feedback.dc_pre_charge_target_voltage(
+            message_20::datatypes::from_RationalNumber(req->get_target_voltage()));
 
         m_ctx.respond(res);
 
@@ -68,7 +81,7 @@ Result DC_PreCharge::feed(Event ev) {
 
         return m_ctx.create_state<PowerDelivery>();
 
-    } else if (const auto req = variant->get_if<message_20::SessionStopRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::SessionStopRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -76,10 +89,10 @@ Result DC_PreCharge::feed(Event ev) {
 
         return {};
     } else {
-        m_ctx.log("expected DC_PreChargeReq! But code type id: %d", variant->get_type());
+        m_ctx.log("expected DC_PreChargeReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
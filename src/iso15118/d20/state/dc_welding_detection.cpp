@@ -46,9 +46,9 @@ Result DC_WeldingDetection::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::DC_WeldingDetectionRequest>()) {
+    if (const auto req = variant.get_if<message_20::DC_WeldingDetectionRequest>()) {
         const auto res = handle_request(*req, m_ctx.session, present_voltage);
 
         m_ctx.respond(res);
@@ -64,10 +64,10 @@ Result DC_WeldingDetection::feed(Event ev) {
 
         return m_ctx.create_state<SessionStop>();
     } else {
-        m_ctx.log("expected DC_WeldingDetection! But code type id: %d", variant->get_type());
+        m_ctx.log("expected DC_WeldingDetection! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
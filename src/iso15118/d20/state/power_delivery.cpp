@@ -13,24 +13,37 @@ namespace iso15118::d20::state {
 
 namespace dt = message_20::datatypes;
 
-message_20::PowerDeliveryResponse handle_request(const message_20::PowerDeliveryRequest& req,
-                                                 const d20::Session& session) {
+namespace {
+message_20::PowerDeliveryResponse handle_power_delivery_request(const dt::SessionId& session_id,
+                                                                const dt::Progress charge_progress,
+                                                                const d20::Session& session) {
 
     message_20::PowerDeliveryResponse res;
 
-    if (validate_and_setup_header(res.header, session, req.header.session_id) == false) {
+    if (validate_and_setup_header(res.header, session, session_id) == false) {
         return response_with_code(res, dt::ResponseCode::FAILED_UnknownSession);
     }
 
     // TODO(sl): Check Req PowerProfile & ChannelSelection
 
     // Todo(sl): Add standby feature and define as everest module config
-    if (req.charge_progress == dt::Progress::Standby) {
+    if (charge_progress == dt::Progress::Standby) {
         return response_with_code(res, dt::ResponseCode::WARNING_StandbyNotAllowed);
     }
 
     return response_with_code(res, dt::ResponseCode::OK);
 }
+} // namespace
+
+message_20::PowerDeliveryResponse handle_request(const message_20::PowerDeliveryRequest& req,
+                                                 const d20::Session& session) {
+    return handle_power_delivery_request(req.header.session_id, req.charge_progress, session);
+}
+
+message_20::PowerDeliveryResponse handle_request(const message_20::PowerDeliveryRequestView& req,
+                                                 const d20::Session& session) {
+    return handle_power_delivery_request(req.get_header().session_id, req.get_charge_progress(), session);
+}
 
 void PowerDelivery::enter() {
     m_ctx.log.enter_state("PowerDelivery");
@@ -54,12 +67,12 @@ Result PowerDelivery::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::DC_PreChargeRequest>()) {
+    if (const auto req = variant.get_if<message_20::DC_PreChargeRequestView>()) {
         const auto res = handle_request(*req, m_ctx.session, present_voltage);
 
-        m_ctx.feedback.dc_pre_charge_target_voltage(dt::from_RationalNumber(req->target_voltage));
+        m_ctx.feedback.dc_pre_charge_target_voltage(dt::from_RationalNumber(req->get_target_voltage()));
 
         m_ctx.respond(res);
 
@@ -69,8 +82,8 @@ Result PowerDelivery::feed(Event ev) {
         }
 
         return {};
-    } else if (const auto req = variant->get_if<message_20::PowerDeliveryRequest>()) {
-        if (req->charge_progress == dt::Progress::Start) {
+    } else if (const auto req = variant.get_if<message_20::PowerDeliveryRequestView>()) {
+        if (req->get_charge_progress() == dt::Progress::Start) {
             m_ctx.feedback.signal(session::feedback::Signal::SETUP_FINISHED);
         }
 
@@ -85,10 +98,10 @@ Result PowerDelivery::feed(Event ev) {
 
         return m_ctx.create_state<DC_ChargeLoop>();
     } else {
-        m_ctx.log("Expected DC_PreChargeReq or PowerDeliveryReq! But code type id: %d", variant->get_type());
+        m_ctx.log("Expected DC_PreChargeReq or PowerDeliveryReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
@@ -122,9 +122,9 @@ Result ScheduleExchange::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::ScheduleExchangeRequest>()) {
+    if (const auto req = variant.get_if<message_20::ScheduleExchangeRequest>()) {
 
         dt::RationalNumber max_charge_power = {0, 0};
 
@@ -168,7 +168,7 @@ Result ScheduleExchange::feed(Event ev) {
         }
 
         return m_ctx.create_state<DC_CableCheck>();
-    } else if (const auto req = variant->get_if<message_20::SessionStopRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::SessionStopRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -176,10 +176,10 @@ Result ScheduleExchange::feed(Event ev) {
 
         return {};
     } else {
-        m_ctx.log("expected ScheduleExchangeReq! But code type id: %d", variant->get_type());
+        m_ctx.log("expected ScheduleExchangeReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
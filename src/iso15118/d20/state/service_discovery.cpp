@@ -15,7 +15,7 @@ namespace iso15118::d20::state {
 
 namespace dt = message_20::datatypes;
 
-static bool find_service_id(const std::vector<uint16_t>& req_service_ids, const uint16_t service) {
+static bool find_service_id(const dt::ServiceIdList& req_service_ids, const uint16_t service) {
     return std::find(req_service_ids.begin(), req_service_ids.end(), service) != req_service_ids.end();
 }
 
@@ -89,9 +89,9 @@ Result ServiceDiscovery::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::ServiceDiscoveryRequest>()) {
+    if (const auto req = variant.get_if<message_20::ServiceDiscoveryRequest>()) {
         if (req->supported_service_ids) {
             logf_info("Possible ids");
             for (auto id : req->supported_service_ids.value()) {
@@ -110,7 +110,7 @@ Result ServiceDiscovery::feed(Event ev) {
         }
 
         return m_ctx.create_state<ServiceDetail>();
-    } else if (const auto req = variant->get_if<message_20::SessionStopRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::SessionStopRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -118,10 +118,10 @@ Result ServiceDiscovery::feed(Event ev) {
 
         return {};
     } else {
-        m_ctx.log("expected ServiceDiscoveryReq! But code type id: %d", variant->get_type());
+        m_ctx.log("expected ServiceDiscoveryReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
@@ -87,9 +87,9 @@ Result ServiceSelection::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::ServiceDetailRequest>()) {
+    if (const auto req = variant.get_if<message_20::ServiceDetailRequest>()) {
         logf_info("Requested info about ServiceID: %d", req->service);
 
         const auto res = handle_request(*req, m_ctx.session, m_ctx.session_config);
@@ -102,7 +102,7 @@ Result ServiceSelection::feed(Event ev) {
         }
 
         return {};
-    } else if (const auto req = variant->get_if<message_20::ServiceSelectionRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::ServiceSelectionRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -113,7 +113,7 @@ Result ServiceSelection::feed(Event ev) {
         }
 
         return m_ctx.create_state<DC_ChargeParameterDiscovery>();
-    } else if (const auto req = variant->get_if<message_20::SessionStopRequest>()) {
+    } else if (const auto req = variant.get_if<message_20::SessionStopRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -121,10 +121,10 @@ Result ServiceSelection::feed(Event ev) {
 
         return {};
     } else {
-        m_ctx.log("expected ServiceDetailReq! But code type id: %d", variant->get_type());
+        m_ctx.log("expected ServiceDetailReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
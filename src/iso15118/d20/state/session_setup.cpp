@@ -44,12 +44,12 @@ Result SessionSetup::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::SessionSetupRequest>()) {
+    if (const auto req = variant.get_if<message_20::SessionSetupRequest>()) {
 
         logf_info("Received session setup with evccid: %s", req->evccid.c_str());
-        m_ctx.feedback.evcc_id(req->evccid);
+        m_ctx.feedback.evcc_id(std::string(req->evccid));
 
         bool new_session{true};
 
@@ -72,10 +72,10 @@ Result SessionSetup::feed(Event ev) {
         // Todo(sl): Going straight to ChargeParameterDiscovery?
 
     } else {
-        m_ctx.log("expected SessionSetupReq! But code type id: %d", variant->get_type());
+        m_ctx.log("expected SessionSetupReq! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
@@ -45,9 +45,9 @@ Result SessionStop::feed(Event ev) {
         return {};
     }
 
-    const auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::SessionStopRequest>()) {
+    if (const auto req = variant.get_if<message_20::SessionStopRequest>()) {
         const auto res = handle_request(*req, m_ctx.session);
 
         m_ctx.respond(res);
@@ -57,10 +57,10 @@ Result SessionStop::feed(Event ev) {
 
         return {};
     } else {
-        m_ctx.log("expected SessionStop! But code type id: %d", variant->get_type());
+        m_ctx.log("expected SessionStop! But code type id: %d", variant.get_type());
 
         // Sequence Error
-        const message_20::Type req_type = variant->get_type();
+        const message_20::Type req_type = variant.get_type();
         send_sequence_error(req_type, m_ctx);
 
         m_ctx.session_stopped = true;
@@ -41,9 +41,9 @@ Result SupportedAppProtocol::feed(Event ev) {
         return {};
     }
 
-    auto variant = m_ctx.pull_request();
+    const auto& variant = m_ctx.pull_request();
 
-    if (const auto req = variant->get_if<message_20::SupportedAppProtocolRequest>()) {
+    if (const auto req = variant.get_if<message_20::SupportedAppProtocolRequest>()) {
 
         const auto [res, selected_protocol] = handle_request(*req);
         m_ctx.respond(res);
@@ -57,7 +57,7 @@ Result SupportedAppProtocol::feed(Event ev) {
                   req->app_protocol.size() ? req->app_protocol[0].protocol_namespace.c_str() : "unknown");
         return {};
     } else {
-        m_ctx.log("expected SupportedAppProtocolReq! But code type id: %d", variant->get_type());
+        m_ctx.log("expected SupportedAppProtocolReq! But code type id: %d", variant.get_type());
 
         m_ctx.session_stopped = true;
         return {};
@@ -3,12 +3,10 @@
 #include <iso15118/io/connection_plain.hpp>
 
 #include <cassert>
-#include <chrono>
 #include <cinttypes>
 #include <cstring>
-#include <thread>
 
-#include <endian.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include <iso15118/detail/helper.hpp>
@@ -16,55 +14,30 @@
 
 namespace iso15118::io {
 
-static constexpr auto DEFAULT_SOCKET_BACKLOG = 4;
+ConnectionPlain::ConnectionPlain(PollManager& poll_manager_, Listener& listener_) : poll_manager(poll_manager_) {
+    wait_for_connect(listener_);
+}
 
 ConnectionPlain::ConnectionPlain(PollManager& poll_manager_, const std::string& interface_name) :
-    poll_manager(poll_manager_) {
-    sockaddr_in6 address;
-    if (not get_first_sockaddr_in6_for_interface(interface_name, address)) {
-        const auto msg = "Failed to get ipv6 socket address for interface " + interface_name;
-        log_and_throw(msg.c_str());
-    }
-
-    // setup end point information
-    end_point.port = 50000;
-    memcpy(&end_point.address, &address.sin6_addr, sizeof(address.sin6_addr));
-
-    fd = socket(AF_INET6, SOCK_STREAM, 0);
-    if (fd == -1) {
-        log_and_throw("Failed to create an ipv6 socket");
-    }
-
-    // before bind, set the port
-    address.sin6_port = htobe16(end_point.port);
-
-    int optval_tmp{1};
-    const auto set_reuseaddr = setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval_tmp, sizeof(optval_tmp));
-    if (set_reuseaddr == -1) {
-        log_and_throw("setsockopt(SO_REUSEADDR) failed");
-    }
+    poll_manager(poll_manager_), owned_listener(std::make_unique<Listener>(interface_name, TCP_LISTENER_PORT)) {
+    wait_for_connect(*owned_listener);
+}
 
-    const auto set_reuseport = setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &optval_tmp, sizeof(optval_tmp));
-    if (set_reuseport == -1) {
-        log_and_throw("setsockopt(SO_REUSEPORT) failed");
+ConnectionPlain::~ConnectionPlain() {
+    if (linger_timer) {
+        poll_manager.cancel_timer(*linger_timer);
     }
 
-    const auto bind_result = bind(fd, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address));
-    if (bind_result == -1) {
-        const auto error = "Failed to bind ipv6 socket to interface " + interface_name;
-        log_and_throw(error.c_str());
+    if (listener) {
+        poll_manager.unregister_fd(listener->get_fd());
     }
 
-    const auto listen_result = listen(fd, DEFAULT_SOCKET_BACKLOG);
-    if (listen_result == -1) {
-        log_and_throw("Listen on socket failed");
+    if (fd != -1) {
+        poll_manager.unregister_fd(fd);
+        ::close(fd);
     }
-
-    poll_manager.register_fd(fd, [this]() { this->handle_connect(); });
 }
 
-ConnectionPlain::~ConnectionPlain() = default;
-
 void ConnectionPlain::set_event_callback(const ConnectionEventCallback& callback) {
     this->event_callback = callback;
 }
@@ -76,13 +49,13 @@ Ipv6EndPoint ConnectionPlain::get_public_endpoint() const {
 void ConnectionPlain::write(const uint8_t* buf, size_t len) {
     assert(connection_open);
 
-    const auto write_result = ::write(fd, buf, len);
-
-    if (write_result == -1) {
-        log_and_throw("Failed to write()");
-    } else if (not cmp_equal(write_result, len)) {
-        log_and_throw("Could not complete write");
+    if (not output_queue.push(buf, len)) {
+        logf_error("Output queue overflow, the peer does not read anymore");
+        handle_connection_loss();
+        return;
     }
+
+    flush_output();
 }
 
 ReadResult ConnectionPlain::read(uint8_t* buf, size_t len) {
@@ -91,39 +64,51 @@ ReadResult ConnectionPlain::read(uint8_t* buf, size_t len) {
     const auto read_result = ::read(fd, buf, len);
     const auto did_block = (len > 0) and (not cmp_equal(read_result, len));
 
-    if (read_result >= 0) {
+    if (read_result > 0 or (read_result == 0 and len == 0)) {
         return {did_block, static_cast<size_t>(read_result)};
     }
 
-    // should be an error
-    if (errno != EAGAIN) {
-        // in case the error is not due to blocking, log it
-        logf_error("ConnectionPlain::read failed with error code: %d", errno);
+    if (read_result == -1 and (errno == EAGAIN or errno == EWOULDBLOCK or errno == EINTR)) {
+        return {true, 0};
     }
 
-    return {did_block, 0};
+    // otherwise the fd would stay readable forever, so the loss needs to be reported
+    if (read_result == 0) {
+        logf_info("Client closed the TCP connection");
+    } else {
+        logf_warning("Failed to read(): %s", strerror(errno));
+    }
+
+    handle_connection_loss();
+
+    return {true, 0};
+}
+
+void ConnectionPlain::wait_for_connect(Listener& listener_) {
+    listener = &listener_;
+    end_point = listener->get_end_point();
+
+    poll_manager.register_fd(listener->get_fd(), [this]() { this->handle_connect(); });
 }
 
 void ConnectionPlain::handle_connect() {
 
     sockaddr_in6 address;
-    socklen_t address_len = sizeof(address);
-
-    const auto accept_fd = accept4(fd, reinterpret_cast<struct sockaddr*>(&address), &address_len, SOCK_NONBLOCK);
+    const auto accept_fd = listener->accept(address);
     if (accept_fd == -1) {
-        log_and_throw("Failed to accept4");
+        // the pending connection vanished meanwhile
+        return;
     }
 
     const auto address_name = sockaddr_in6_to_name(address);
 
-    if (not address_name) {
-        log_and_throw("Failed to determine string representation of ipv6 socket address");
-    }
+    logf_info("Incoming connection from [%s]:%" PRIu16, address_name ? address_name.get() : "?",
+              ntohs(address.sin6_port));
 
-    logf_info("Incoming connection from [%s]:%" PRIu16, address_name.get(), ntohs(address.sin6_port));
-
-    poll_manager.unregister_fd(fd);
-    ::close(fd);
+    // the listener stays open for the next connection, unless it is owned by this connection
+    poll_manager.unregister_fd(listener->get_fd());
+    listener = nullptr;
+    owned_listener.reset();
 
     call_if_available(event_callback, ConnectionEvent::ACCEPTED);
 
@@ -131,7 +116,25 @@ void ConnectionPlain::handle_connect() {
     call_if_available(event_callback, ConnectionEvent::OPEN);
 
     fd = accept_fd;
-    poll_manager.register_fd(fd, [this]() { this->handle_data(); });
+    poll_manager.register_fd(
+        fd, [this](short revents) { this->handle_events(revents); }, POLLIN);
+}
+
+void ConnectionPlain::handle_events(short revents) {
+    if (revents & POLLOUT) {
+        flush_output();
+    }
+
+    if ((fd == -1) or ((revents & (POLLIN | POLLERR | POLLHUP)) == 0)) {
+        // either closed meanwhile or nothing to read
+        return;
+    }
+
+    if (closing) {
+        handle_linger();
+    } else {
+        handle_data();
+    }
 }
 
 void ConnectionPlain::handle_data() {
@@ -140,32 +143,147 @@ void ConnectionPlain::handle_data() {
     call_if_available(event_callback, ConnectionEvent::NEW_DATA);
 }
 
+void ConnectionPlain::flush_output() {
+    while (not output_queue.empty()) {
+        const auto write_result = ::send(fd, output_queue.data(), output_queue.size(), MSG_NOSIGNAL);
+
+        if (write_result == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == EAGAIN or errno == EWOULDBLOCK) {
+                // socket buffer is full, continue as soon as it is writable again
+                set_want_write(true);
+                return;
+            }
+
+            // the peer is gone (EPIPE, ECONNRESET, ETIMEDOUT from TCP_USER_TIMEOUT, ...)
+            logf_warning("Failed to write(): %s", strerror(errno));
+            handle_connection_loss();
+            return;
+        }
+
+        output_queue.pop(write_result);
+    }
+
+    set_want_write(false);
+
+    if (closing) {
+        half_close();
+    }
+}
+
+void ConnectionPlain::set_want_write(bool want_write) {
+    if (want_write == pollout_enabled) {
+        return;
+    }
+
+    poll_manager.modify_fd(fd, want_write ? (POLLIN | POLLOUT) : POLLIN);
+    pollout_enabled = want_write;
+}
+
 void ConnectionPlain::close() {
+    if (fd == -1 or closing) {
+        // already closed (e.g. lost) or about to be closed
+        return;
+    }
 
     /* tear down TCP connection gracefully */
     logf_info("Closing TCP connection");
 
-    const auto shutdown_result = shutdown(fd, SHUT_RDWR);
+    connection_open = false;
+    closing = true;
+
+    // the linger timeout covers sending the remaining output as well as waiting for the FIN of the client
+    linger_timer = poll_manager.add_timer(CONNECTION_LINGER_TIMEOUT_MS, [this]() {
+        linger_timer.reset();
+        logf_info("Client did not close the TCP connection in time");
+        finish_close();
+    });
+
+    if (output_queue.empty()) {
+        half_close();
+    }
+    // otherwise, flush_output() will half-close as soon as everything has been sent
+}
+
+void ConnectionPlain::half_close() {
+    // half-close, so the client sees our FIN, and wait for its FIN without blocking the event loop
+    const auto shutdown_result = shutdown(fd, SHUT_WR);
 
     if (shutdown_result == -1) {
-        log_and_throw("shutdown() failed");
+        logf_warning("shutdown() failed with error code: %d", errno);
+        finish_close();
     }
+}
 
-    // Waiting for client closing the connection
-    std::this_thread::sleep_for(std::chrono::seconds(2));
+void ConnectionPlain::handle_linger() {
+    // discard anything the client still sends, until it closes its side
+    uint8_t discard_buffer[256];
 
-    poll_manager.unregister_fd(fd);
+    while (true) {
+        const auto read_result = ::read(fd, discard_buffer, sizeof(discard_buffer));
+
+        if (read_result > 0) {
+            continue;
+        }
 
-    const auto close_shutdown = ::close(fd);
+        if (read_result == -1 and (errno == EAGAIN or errno == EWOULDBLOCK or errno == EINTR)) {
+            return;
+        }
 
-    if (close_shutdown == -1) {
-        log_and_throw("close() failed");
+        // either the client closed the connection or it failed anyway
+        finish_close();
+        return;
     }
+}
 
-    logf_info("TCP connection closed gracefully");
+void ConnectionPlain::handle_connection_loss() {
+    if (fd == -1) {
+        return;
+    }
 
+    // nothing can be sent anymore, so there is no point in a graceful close
     connection_open = false;
+    release_socket();
+
+    call_if_available(event_callback, ConnectionEvent::CLOSED);
+}
+
+void ConnectionPlain::finish_close() {
+    if (fd == -1) {
+        return;
+    }
+
+    if (release_socket()) {
+        logf_info("TCP connection closed gracefully");
+    }
+
     call_if_available(event_callback, ConnectionEvent::CLOSED);
 }
 
+bool ConnectionPlain::release_socket() {
+    if (linger_timer) {
+        poll_manager.cancel_timer(*linger_timer);
+        linger_timer.reset();
+    }
+
+    poll_manager.unregister_fd(fd);
+
+    const auto close_result = ::close(fd);
+    fd = -1;
+
+    output_queue.clear();
+    closing = false;
+    pollout_enabled = false;
+
+    if (close_result == -1) {
+        logf_error("close() failed with error code: %d", errno);
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace iso15118::io
@@ -4,11 +4,13 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cinttypes>
 #include <cstring>
 #include <filesystem>
-#include <fstream>
+#include <mutex>
 #include <sstream>
 #include <unistd.h>
 #include <vector>
@@ -16,13 +18,17 @@
 #include <sys/socket.h>
 
 #include <openssl/bio.h>
+#include <openssl/core_names.h>
 #include <openssl/err.h>
 #include <openssl/evp.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 
 #include <iso15118/detail/helper.hpp>
 #include <iso15118/detail/io/helper_ssl.hpp>
 #include <iso15118/detail/io/socket_helper.hpp>
+#include <iso15118/detail/io/ssl_context_cache.hpp>
+#include <iso15118/detail/io/tls_key_log_writer.hpp>
 #include <iso15118/io/sdp_server.hpp>
 
 namespace std {
@@ -43,27 +49,104 @@ public:
 namespace iso15118::io {
 
 struct SSLContext {
-    std::unique_ptr<SSL_CTX> ssl_ctx;
+    std::shared_ptr<SSL_CTX> ssl_ctx;
     std::unique_ptr<SSL> ssl;
-    int fd{-1};
     int accept_fd{-1};
     std::string interface_name;
     bool enable_key_logging{false};
-    std::filesystem::path tls_key_log_file_path{};
-    std::unique_ptr<io::TlsKeyLoggingServer> key_server;
+    std::shared_ptr<io::TlsKeyLoggingServer> key_server;
     bool enforce_tls_1_3{false};
+    bool enable_ktls{false};
     std::optional<sha512_hash_t> vehicle_cert_hash{std::nullopt};
 };
 
 namespace {
 
-constexpr auto DEFAULT_SOCKET_BACKLOG = 4;
-constexpr auto TLS_PORT = 50000;
 constexpr auto NAME_LENGTH = 256;
 
 int ssl_keylog_server_index{-1};
 int ssl_keylog_file_index{-1};
 
+// lifetime of a resumable session
+constexpr auto SESSION_TIMEOUT = std::chrono::hours(2);
+// a ticket key is used to issue tickets for this long, afterwards it is only accepted (and the ticket gets renewed)
+constexpr auto TICKET_KEY_ROTATION_INTERVAL = std::chrono::hours(1);
+constexpr unsigned char SESSION_ID_CONTEXT[] = "iso15118";
+
+std::atomic<uint64_t> session_resumption_hits{0};
+std::atomic<uint64_t> session_resumption_misses{0};
+
+struct TicketKey {
+    std::array<unsigned char, 16> name;
+    std::array<unsigned char, 32> aes_key;
+    std::array<unsigned char, 32> hmac_key;
+    std::chrono::steady_clock::time_point created;
+};
+
+// Process wide keys for the session tickets, so tickets stay valid if the SSL_CTX gets rebuilt.  The keys are only
+// held in memory, so tickets of a previous process can't be decrypted.
+class TicketKeyRing {
+public:
+    // returns a copy of the key to issue new tickets with, rotates the keys if necessary, std::nullopt if a new key
+    // couldn't be generated
+    // NOTE: called from within the ticket callback of openssl, so it must not throw
+    std::optional<TicketKey> get_current() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (not current or now - current->created >= TICKET_KEY_ROTATION_INTERVAL) {
+            auto key = create_key(now);
+            if (not key) {
+                return std::nullopt;
+            }
+            previous = current;
+            current = key;
+        }
+
+        return current;
+    }
+
+    // looks up the key a ticket was issued with, is_current is false for keys which are rotated out already
+    std::optional<TicketKey> find(const unsigned char* name, bool& is_current) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const auto matches = [name](const std::optional<TicketKey>& key) {
+            return key and std::equal(key->name.begin(), key->name.end(), name);
+        };
+
+        if (matches(current)) {
+            is_current = true;
+            return current;
+        }
+
+        if (matches(previous)) {
+            is_current = false;
+            return previous;
+        }
+
+        return std::nullopt;
+    }
+
+private:
+    static std::optional<TicketKey> create_key(std::chrono::steady_clock::time_point now) {
+        TicketKey key;
+        if (RAND_bytes(key.name.data(), key.name.size()) != 1 or
+            RAND_priv_bytes(key.aes_key.data(), key.aes_key.size()) != 1 or
+            RAND_priv_bytes(key.hmac_key.data(), key.hmac_key.size()) != 1) {
+            log_openssl_error("Failed to generate the session ticket key");
+            return std::nullopt;
+        }
+        key.created = now;
+        return key;
+    }
+
+    std::mutex mutex;
+    std::optional<TicketKey> current;
+    std::optional<TicketKey> previous;
+};
+
+TicketKeyRing ticket_key_ring;
+
 std::string convert_ssl_tls_versions_to_string(uint16_t version) {
     switch (version) {
     case SSL3_VERSION:
@@ -176,30 +259,15 @@ int handle_certificate_cb(SSL* ssl, void* /* arg */) {
 }
 
 void keylog_callback(const SSL* ssl, const char* line) {
-    auto key_logging_server = static_cast<io::TlsKeyLoggingServer*>(SSL_get_ex_data(ssl, ssl_keylog_server_index));
-
-    std::string key_log_msg = "TLS Handshake keys on port ";
-    key_log_msg += std::to_string(key_logging_server->get_port()) + ": ";
-    key_log_msg += std::string(line);
-
-    logf_info(key_log_msg.c_str());
+    // called during the handshake, so the line is only queued, the writer thread does the actual (file) I/O
+    const auto key_logging_server =
+        static_cast<std::shared_ptr<io::TlsKeyLoggingServer>*>(SSL_get_ex_data(ssl, ssl_keylog_server_index));
+    const auto ssl_config =
+        static_cast<const config::SSLConfig*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), ssl_keylog_file_index));
 
-    if (key_logging_server->get_fd() != -1) {
-        const auto result = key_logging_server->send(line);
-        if (not cmp_equal(result, strlen(line))) {
-            const auto error_msg = adding_err_msg("key_logging_server send() failed");
-            logf_error(error_msg.c_str());
-        }
-    }
-
-    const auto keylog_file_path =
-        static_cast<std::filesystem::path*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), ssl_keylog_file_index));
-
-    if (not keylog_file_path->empty()) {
-        std::ofstream ofs;
-        ofs.open(keylog_file_path->string(), std::ofstream::out | std::ofstream::app);
-        ofs << line << std::endl;
-        ofs.close();
+    if (not TlsKeyLogWriter::get_instance().push(line, ssl_config->tls_key_logging_path,
+                                                 key_logging_server ? *key_logging_server : nullptr)) {
+        logf_warning("Dropped a TLS key log line");
     }
 }
 
@@ -215,6 +283,54 @@ int private_key_callback(char* buf, int size, [[maybe_unused]] int rwflag, void*
     return max_copy_chars;
 }
 
+int ticket_key_callback(SSL* /* ssl */, unsigned char key_name[16], unsigned char* iv, EVP_CIPHER_CTX* cipher_ctx,
+                        EVP_MAC_CTX* mac_ctx, int enc) {
+    const auto set_mac_key = [mac_ctx](TicketKey& key) {
+        char digest_name[] = "SHA256";
+        OSSL_PARAM params[] = {
+            OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmac_key.data(), key.hmac_key.size()),
+            OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest_name, 0),
+            OSSL_PARAM_construct_end(),
+        };
+        return EVP_MAC_CTX_set_params(mac_ctx, params) == 1;
+    };
+
+    if (enc) {
+        // issue a new ticket
+        auto key = ticket_key_ring.get_current();
+
+        if (not key or RAND_bytes(iv, EVP_CIPHER_get_iv_length(EVP_aes_256_cbc())) != 1) {
+            return -1;
+        }
+
+        std::memcpy(key_name, key->name.data(), key->name.size());
+
+        if (EVP_EncryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, key->aes_key.data(), iv) != 1 or
+            not set_mac_key(*key)) {
+            return -1;
+        }
+
+        return 1;
+    }
+
+    // decrypt a ticket of the client
+    bool is_current{false};
+    auto key = ticket_key_ring.find(key_name, is_current);
+
+    if (not key) {
+        // unknown or expired key, fall back to a full handshake
+        return 0;
+    }
+
+    if (EVP_DecryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, key->aes_key.data(), iv) != 1 or
+        not set_mac_key(*key)) {
+        return -1;
+    }
+
+    // a ticket of a rotated out key is accepted, but renewed
+    return is_current ? 1 : 2;
+}
+
 SSL_CTX* init_ssl(const config::SSLConfig& ssl_config) {
 
     // Note: openssl does not provide support for ECDH-ECDSA-AES128-SHA256 anymore
@@ -222,7 +338,10 @@ SSL_CTX* init_ssl(const config::SSLConfig& ssl_config) {
     static constexpr auto TLS1_3_CIPHERSUITES = "TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256";
 
     const SSL_METHOD* method = TLS_server_method();
-    const auto ctx = SSL_CTX_new(method);
+
+    // owned until it is complete, so it gets freed if one of the following steps throws
+    std::unique_ptr<SSL_CTX> ctx_owner(SSL_CTX_new(method));
+    const auto ctx = ctx_owner.get();
 
     if (ctx == nullptr) {
         log_and_raise_openssl_error("Failed in SSL_CTX_new()");
@@ -250,7 +369,8 @@ SSL_CTX* init_ssl(const config::SSLConfig& ssl_config) {
 
     // INFO: the password callback uses a non-const argument
     if (ssl_config.private_key_password.has_value()) {
-        // Lifetime of the password is important because using a callback we'll require a valid ref
+        // Lifetime of the password is important because using a callback we'll require a valid ref, the config is
+        // owned by the SSLContextCache
         SSL_CTX_set_default_passwd_cb_userdata(
             ctx, &const_cast<config::SSLConfig&>(ssl_config).private_key_password.value());
         SSL_CTX_set_default_passwd_cb(ctx, private_key_callback);
@@ -271,14 +391,40 @@ SSL_CTX* init_ssl(const config::SSLConfig& ssl_config) {
 
     SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
 
+    if (ssl_config.enable_ktls) {
+        // NOTE: openssl falls back to user space silently, if the kernel (tls module) or the negotiated ciphersuite
+        // doesn't support kTLS, e.g. the CBC ciphersuite of TLS 1.2
+        SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+    }
+
+    if (ssl_config.enable_session_resumption) {
+        // NOTE: resumption of sessions with a verified client certificate requires a session id context
+        SSL_CTX_set_session_id_context(ctx, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(ctx, ssl_config.session_cache_size);
+        SSL_CTX_set_timeout(ctx, std::chrono::duration_cast<std::chrono::seconds>(SESSION_TIMEOUT).count());
+
+        if (SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, ticket_key_callback) != 1) {
+            log_and_raise_openssl_error("Failed in SSL_CTX_set_tlsext_ticket_key_evp_cb()");
+        }
+    } else {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+        SSL_CTX_set_num_tickets(ctx, 0);
+    }
+
     SSL_CTX_set_client_hello_cb(ctx, &client_hello_cb, nullptr);
 
     // TODO(SL): Adding multi root support with certificate_authorities extension
     // SSL_CTX_set_cert_cb(ctx, &handle_certificate_cb, nullptr);
 
     if (ssl_config.enable_tls_key_logging) {
-        ssl_keylog_file_index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
-        ssl_keylog_server_index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        if (ssl_keylog_file_index == -1) {
+            ssl_keylog_file_index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        }
+        if (ssl_keylog_server_index == -1) {
+            ssl_keylog_server_index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        }
 
         if (ssl_keylog_file_index == -1 or ssl_keylog_server_index == -1) {
             auto error_msg = std::string("_get_ex_new_index failed: ssl_keylog_file_index: ");
@@ -286,83 +432,46 @@ SSL_CTX* init_ssl(const config::SSLConfig& ssl_config) {
             error_msg += ", ssl_keylog_server_index: " + std::to_string(ssl_keylog_server_index);
             logf_error(error_msg.c_str());
         } else {
+            SSL_CTX_set_ex_data(ctx, ssl_keylog_file_index, &const_cast<config::SSLConfig&>(ssl_config));
             SSL_CTX_set_keylog_callback(ctx, keylog_callback);
         }
     }
 
-    return ctx;
+    return ctx_owner.release();
 }
 } // namespace
 
-ConnectionSSL::ConnectionSSL(PollManager& poll_manager_, const std::string& interface_name_,
-                             const config::SSLConfig& ssl_config) :
+ConnectionSSL::ConnectionSSL(PollManager& poll_manager_, Listener& listener_, const config::SSLConfig& ssl_config) :
     poll_manager(poll_manager_), ssl(std::make_unique<SSLContext>()) {
+    setup(listener_, ssl_config);
+}
 
-    ssl->interface_name = interface_name_;
-    ssl->enable_key_logging = ssl_config.enable_tls_key_logging;
-    ssl->enforce_tls_1_3 = ssl_config.enforce_tls_1_3;
-
-    // Openssl stuff missing!
-    const auto ssl_ctx = init_ssl(ssl_config);
-    ssl->ssl_ctx = std::unique_ptr<SSL_CTX>(ssl_ctx);
-
-    if (ssl_keylog_file_index != -1) {
-        ssl->tls_key_log_file_path = ssl_config.tls_key_logging_path / "tls_session_keys.log";
-        SSL_CTX_set_ex_data(ssl->ssl_ctx.get(), ssl_keylog_file_index, &ssl->tls_key_log_file_path);
-    }
-    sockaddr_in6 address;
-    if (not get_first_sockaddr_in6_for_interface(interface_name_, address)) {
-        const auto msg = "Failed to get ipv6 socket address for interface " + interface_name_;
-        log_and_throw(msg.c_str());
-    }
-
-    end_point.port = TLS_PORT;
-    memcpy(&end_point.address, &address.sin6_addr, sizeof(address.sin6_addr));
-
-    const auto address_name = sockaddr_in6_to_name(address);
-
-    if (not address_name) {
-        const auto msg =
-            "Failed to determine string representation of ipv6 socket address for interface " + interface_name_;
-        log_and_throw(msg.c_str());
-    }
-
-    logf_info("Start TLS server [%s]:%" PRIu16, address_name.get(), end_point.port);
-
-    ssl->fd = socket(AF_INET6, SOCK_STREAM, 0);
-    if (ssl->fd == -1) {
-        log_and_throw("Failed to create an ipv6 socket");
-    }
-
-    // before bind, set the port
-    address.sin6_port = htobe16(end_point.port);
-
-    int optval_tmp{1};
-    const auto set_reuseaddr = setsockopt(ssl->fd, SOL_SOCKET, SO_REUSEADDR, &optval_tmp, sizeof(optval_tmp));
-    if (set_reuseaddr == -1) {
-        log_and_throw("setsockopt(SO_REUSEADDR) failed");
-    }
+ConnectionSSL::ConnectionSSL(PollManager& poll_manager_, const std::string& interface_name_,
+                             const config::SSLConfig& ssl_config) :
+    poll_manager(poll_manager_),
+    ssl(std::make_unique<SSLContext>()),
+    owned_listener(std::make_unique<Listener>(interface_name_, TLS_LISTENER_PORT)) {
+    setup(*owned_listener, ssl_config);
+}
 
-    const auto set_reuseport = setsockopt(ssl->fd, SOL_SOCKET, SO_REUSEPORT, &optval_tmp, sizeof(optval_tmp));
-    if (set_reuseport == -1) {
-        log_and_throw("setsockopt(SO_REUSEPORT) failed");
+ConnectionSSL::~ConnectionSSL() {
+    if (linger_timer) {
+        poll_manager.cancel_timer(*linger_timer);
     }
 
-    const auto bind_result = bind(ssl->fd, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address));
-    if (bind_result == -1) {
-        const auto error = "Failed to bind ipv6 socket to interface " + interface_name_;
-        log_and_throw(error.c_str());
+    if (listener) {
+        poll_manager.unregister_fd(listener->get_fd());
     }
 
-    const auto listen_result = listen(ssl->fd, DEFAULT_SOCKET_BACKLOG);
-    if (listen_result == -1) {
-        log_and_throw("Listen on socket failed");
+    if (ssl->accept_fd != -1) {
+        // NOTE: the accepted socket gets closed by the ssl object (BIO_CLOSE)
+        poll_manager.unregister_fd(ssl->accept_fd);
     }
-
-    poll_manager.register_fd(ssl->fd, [this]() { this->handle_connect(); });
 }
 
-ConnectionSSL::~ConnectionSSL() = default;
+TlsSessionResumptionStats ConnectionSSL::get_session_resumption_stats() {
+    return {session_resumption_hits.load(), session_resumption_misses.load()};
+}
 
 void ConnectionSSL::set_event_callback(const ConnectionEventCallback& callback) {
     event_callback = callback;
@@ -379,17 +488,13 @@ std::optional<sha512_hash_t> ConnectionSSL::get_vehicle_cert_hash() const {
 void ConnectionSSL::write(const uint8_t* buf, size_t len) {
     assert(handshake_complete); // TODO(sl): Adding states?
 
-    size_t writebytes = 0;
-    const auto ssl_ptr = ssl->ssl.get();
-
-    const auto ssl_write_result = SSL_write_ex(ssl_ptr, buf, len, &writebytes);
-
-    if (ssl_write_result <= 0) {
-        const auto ssl_err_raw = SSL_get_error(ssl_ptr, ssl_write_result);
-        log_and_raise_openssl_error("Failed to SSL_write_ex(): " + std::to_string(ssl_err_raw));
-    } else if (writebytes != len) {
-        log_and_throw("Didn't complete to write");
+    if (not output_queue.push(buf, len)) {
+        logf_error("Output queue overflow, the peer does not read anymore");
+        handle_connection_loss();
+        return;
     }
+
+    flush_output();
 }
 
 ReadResult ConnectionSSL::read(uint8_t* buf, size_t len) {
@@ -401,37 +506,70 @@ ReadResult ConnectionSSL::read(uint8_t* buf, size_t len) {
     const auto ssl_read_result = SSL_read_ex(ssl_ptr, buf, len, &readbytes);
 
     if (ssl_read_result > 0) {
-        const auto would_block = (readbytes < len);
+        // SSL_read_ex returns at most one record, further ones might already be buffered by ssl
+        const auto would_block = (readbytes < len) and (SSL_pending(ssl_ptr) == 0);
         return {would_block, readbytes};
     }
 
     const auto ssl_error = SSL_get_error(ssl_ptr, ssl_read_result);
 
-    if ((ssl_error == SSL_ERROR_WANT_READ) or (ssl_error == SSL_ERROR_WANT_WRITE)) {
+    if (ssl_error == SSL_ERROR_WANT_READ) {
         return {true, 0};
     }
 
-    log_and_raise_openssl_error("Failed to SSL_read_ex(): " + std::to_string(ssl_error));
+    if (ssl_error == SSL_ERROR_WANT_WRITE) {
+        // NEW_DATA will be signalled again, as soon as the socket is writable
+        set_want_write(true);
+        return {true, 0};
+    }
+
+    // the peer closed the connection (close_notify or EOF) or it failed, the fd would stay readable forever otherwise
+    if (ssl_error == SSL_ERROR_ZERO_RETURN) {
+        logf_info("Client closed the TLS connection");
+        // answer the close_notify, openssl drops the session from the resumption cache otherwise
+        SSL_shutdown(ssl_ptr);
+    } else {
+        log_openssl_error("Failed to SSL_read_ex(): " + std::to_string(ssl_error));
+    }
+
+    handle_connection_loss();
 
-    return {false, 0};
+    return {true, 0};
 }
 
-void ConnectionSSL::handle_connect() {
+void ConnectionSSL::setup(Listener& listener_, const config::SSLConfig& ssl_config) {
+    listener = &listener_;
+    end_point = listener->get_end_point();
+
+    ssl->interface_name = listener->get_interface_name();
+    ssl->enable_key_logging = ssl_config.enable_tls_key_logging;
+    ssl->enforce_tls_1_3 = ssl_config.enforce_tls_1_3;
+    ssl->enable_ktls = ssl_config.enable_ktls;
 
-    const auto peer = BIO_ADDR_new();
-    ssl->accept_fd = BIO_accept_ex(ssl->fd, peer, BIO_SOCK_NONBLOCK);
+    // NOTE: the context is only built once per config (and after the certificate files changed)
+    ssl->ssl_ctx = SSLContextCache::get_instance().get(ssl_config, init_ssl);
 
-    if (ssl->accept_fd < 0) {
-        log_and_raise_openssl_error("Failed to BIO_accept_ex");
+    poll_manager.register_fd(listener->get_fd(), [this]() { this->handle_connect(); });
+}
+
+void ConnectionSSL::handle_connect() {
+
+    sockaddr_in6 address;
+    ssl->accept_fd = listener->accept(address);
+    if (ssl->accept_fd == -1) {
+        // the pending connection vanished meanwhile
+        return;
     }
 
-    const auto ip = BIO_ADDR_hostname_string(peer, 1);
-    const auto service = BIO_ADDR_service_string(peer, 1);
+    const auto address_name = sockaddr_in6_to_name(address);
+    const auto peer_port = ntohs(address.sin6_port);
 
-    logf_info("Incoming connection from [%s]:%s", ip, service);
+    logf_info("Incoming connection from [%s]:%" PRIu16, address_name ? address_name.get() : "?", peer_port);
 
-    poll_manager.unregister_fd(ssl->fd);
-    ::close(ssl->fd);
+    // the listener stays open for the next connection, unless it is owned by this connection
+    poll_manager.unregister_fd(listener->get_fd());
+    listener = nullptr;
+    owned_listener.reset();
 
     call_if_available(event_callback, ConnectionEvent::ACCEPTED);
 
@@ -441,21 +579,83 @@ void ConnectionSSL::handle_connect() {
     const auto ssl_ptr = ssl->ssl.get();
 
     SSL_set_bio(ssl_ptr, socket_bio, socket_bio);
+    // allows to retry a blocked write with a grown output queue
+    SSL_set_mode(ssl_ptr, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
     SSL_set_accept_state(ssl_ptr);
     SSL_set_app_data(ssl_ptr, this);
 
     if (ssl->enable_key_logging) {
-        const auto port = std::stoul(service);
-        ssl->key_server = std::make_unique<io::TlsKeyLoggingServer>(ssl->interface_name, port);
-        SSL_set_ex_data(ssl_ptr, ssl_keylog_server_index, ssl->key_server.get());
+        ssl->key_server = std::make_shared<io::TlsKeyLoggingServer>(ssl->interface_name, peer_port);
+        SSL_set_ex_data(ssl_ptr, ssl_keylog_server_index, &ssl->key_server);
     }
 
-    poll_manager.register_fd(ssl->accept_fd, [this]() { this->handle_data(); });
+    poll_manager.register_fd(
+        ssl->accept_fd, [this](short revents) { this->handle_events(revents); }, POLLIN);
+}
+
+void ConnectionSSL::handle_events(short revents) {
+    if (closing) {
+        // finish the pending steps of the shutdown in order: output, close_notify and waiting for the client
+        if (not output_queue.empty()) {
+            flush_output();
+        } else if (not close_notify_sent) {
+            shutdown_tls();
+        } else {
+            handle_linger();
+        }
+        return;
+    }
 
-    OPENSSL_free(ip);
-    OPENSSL_free(service);
+    if (not output_queue.empty()) {
+        // the write might have been blocked on writability or, during a key update, on readability
+        flush_output();
+    }
 
-    BIO_ADDR_free(peer);
+    if (not handshake_complete or (revents & (POLLIN | POLLERR | POLLHUP)) or output_queue.empty()) {
+        // NOTE: a blocked read might have waited for writability, so this might signal new data spuriously
+        handle_data();
+    }
+}
+
+void ConnectionSSL::flush_output() {
+    const auto ssl_ptr = ssl->ssl.get();
+
+    while (not output_queue.empty()) {
+        size_t writebytes = 0;
+        const auto ssl_write_result = SSL_write_ex(ssl_ptr, output_queue.data(), output_queue.size(), &writebytes);
+
+        if (ssl_write_result <= 0) {
+            const auto ssl_error = SSL_get_error(ssl_ptr, ssl_write_result);
+
+            if ((ssl_error == SSL_ERROR_WANT_READ) or (ssl_error == SSL_ERROR_WANT_WRITE)) {
+                // continue as soon as the socket is ready again
+                set_want_write(ssl_error == SSL_ERROR_WANT_WRITE);
+                return;
+            }
+
+            // the peer is gone (reset, timeout, ...)
+            log_openssl_error("Failed to SSL_write_ex(): " + std::to_string(ssl_error));
+            handle_connection_loss();
+            return;
+        }
+
+        output_queue.pop(writebytes);
+    }
+
+    set_want_write(false);
+
+    if (closing) {
+        shutdown_tls();
+    }
+}
+
+void ConnectionSSL::set_want_write(bool want_write) {
+    if (want_write == pollout_enabled) {
+        return;
+    }
+
+    poll_manager.modify_fd(ssl->accept_fd, want_write ? (POLLIN | POLLOUT) : POLLIN);
+    pollout_enabled = want_write;
 }
 
 void ConnectionSSL::handle_data() {
@@ -469,11 +669,22 @@ void ConnectionSSL::handle_data() {
             const auto ssl_error = SSL_get_error(ssl_ptr, ssl_handshake_result);
 
             if ((ssl_error == SSL_ERROR_WANT_READ) or (ssl_error == SSL_ERROR_WANT_WRITE)) {
+                set_want_write(ssl_error == SSL_ERROR_WANT_WRITE);
                 return;
             }
-            log_and_raise_openssl_error("Failed to SSL_accept(): " + std::to_string(ssl_error));
+
+            // e.g. the EV aborted the handshake or doesn't speak TLS at all
+            log_openssl_error("Failed to SSL_accept(): " + std::to_string(ssl_error));
+            handle_connection_loss();
+            return;
         } else {
-            logf_info("Handshake complete!");
+            if (SSL_session_reused(ssl_ptr)) {
+                session_resumption_hits++;
+                logf_info("Handshake complete (resumed session)!");
+            } else {
+                session_resumption_misses++;
+                logf_info("Handshake complete!");
+            }
 
             const auto peer = SSL_get0_peer_certificate(ssl_ptr);
 
@@ -511,7 +722,20 @@ void ConnectionSSL::handle_data() {
                 }
             }
 
+            if (ssl->enable_ktls) {
+                ktls_send = BIO_get_ktls_send(SSL_get_wbio(ssl_ptr));
+                ktls_receive = BIO_get_ktls_recv(SSL_get_rbio(ssl_ptr));
+
+                if (ktls_send or ktls_receive) {
+                    logf_info("kTLS enabled for send: %s, receive: %s", ktls_send ? "yes" : "no",
+                              ktls_receive ? "yes" : "no");
+                } else {
+                    logf_info("kTLS not available, falling back to user space encryption");
+                }
+            }
+
             handshake_complete = true;
+            set_want_write(false);
             if (ssl->enable_key_logging) {
                 ssl->key_server.reset();
             }
@@ -529,23 +753,123 @@ void ConnectionSSL::close() {
     /* tear down TLS connection gracefully */
     logf_info("Closing TLS connection");
 
+    if (not handshake_complete) {
+        // no TLS session to shut down
+        finish_close();
+        return;
+    }
+
+    handshake_complete = false;
+    closing = true;
+
+    // the linger timeout covers sending the remaining output as well as waiting for the client to close
+    linger_timer = poll_manager.add_timer(CONNECTION_LINGER_TIMEOUT_MS, [this]() {
+        linger_timer.reset();
+        logf_info("Client did not close the TLS connection in time");
+        finish_close();
+    });
+
+    if (output_queue.empty()) {
+        shutdown_tls();
+    }
+    // otherwise, flush_output() will shut down as soon as everything has been sent
+}
+
+void ConnectionSSL::shutdown_tls() {
     const auto ssl_ptr = ssl->ssl.get();
 
-    const auto ssl_close_result = SSL_shutdown(ssl_ptr); // TODO(sl): Correct shutdown handling
+    // send our close_notify, the one of the client is awaited in handle_linger
+    const auto ssl_close_result = SSL_shutdown(ssl_ptr);
 
     if (ssl_close_result < 0) {
         const auto ssl_error = SSL_get_error(ssl_ptr, ssl_close_result);
-        if ((ssl_error != SSL_ERROR_WANT_READ) and (ssl_error != SSL_ERROR_WANT_WRITE)) {
-            log_and_raise_openssl_error("Failed to SSL_shutdown(): " + std::to_string(ssl_error));
+
+        if (ssl_error == SSL_ERROR_WANT_WRITE) {
+            set_want_write(true);
+            return;
+        }
+
+        if (ssl_error != SSL_ERROR_WANT_READ) {
+            logf_warning("Failed to SSL_shutdown(): %d", ssl_error);
+            finish_close();
+            return;
+        }
+    }
+
+    close_notify_sent = true;
+    set_want_write(false);
+
+    if (ssl_close_result == 1) {
+        finish_close();
+        return;
+    }
+
+    // half-close, so the client sees our FIN, and wait for its answer without blocking the event loop
+    shutdown(ssl->accept_fd, SHUT_WR);
+}
+
+void ConnectionSSL::handle_linger() {
+    const auto ssl_ptr = ssl->ssl.get();
+
+    // discard anything the client still sends, until its close_notify or FIN arrives
+    uint8_t discard_buffer[256];
+    size_t readbytes = 0;
+
+    while (true) {
+        const auto ssl_read_result = SSL_read_ex(ssl_ptr, discard_buffer, sizeof(discard_buffer), &readbytes);
+
+        if (ssl_read_result > 0) {
+            continue;
+        }
+
+        const auto ssl_error = SSL_get_error(ssl_ptr, ssl_read_result);
+
+        if ((ssl_error == SSL_ERROR_WANT_READ) or (ssl_error == SSL_ERROR_WANT_WRITE)) {
+            return;
         }
+
+        // either the client closed the connection or it failed anyway
+        finish_close();
+        return;
+    }
+}
+
+void ConnectionSSL::handle_connection_loss() {
+    if (ssl->accept_fd == -1) {
+        return;
     }
 
-    // TODO(sl): Test if correct
+    // nothing can be sent anymore, so there is no point in a graceful shutdown
+    logf_info("TLS connection lost");
+    finish_close();
+}
+
+void ConnectionSSL::finish_close() {
+    if (ssl->accept_fd == -1) {
+        // already closed
+        return;
+    }
+
+    if (linger_timer) {
+        poll_manager.cancel_timer(*linger_timer);
+        linger_timer.reset();
+    }
+
+    handshake_complete = false;
+    ktls_send = false;
+    ktls_receive = false;
+    closing = false;
+    close_notify_sent = false;
+    output_queue.clear();
+    pollout_enabled = false;
 
-    ::close(ssl->accept_fd);
     poll_manager.unregister_fd(ssl->accept_fd);
 
-    logf_info("TLS connection closed gracefully");
+    // NOTE: freeing the ssl object closes the socket (BIO_CLOSE)
+    ssl->ssl.reset();
+    ssl->accept_fd = -1;
+
+    logf_info("TLS connection closed");
 
     call_if_available(event_callback, ConnectionEvent::CLOSED);
 }
@@ -0,0 +1,338 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/detail/io/interface_registry.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <ifaddrs.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <iso15118/detail/helper.hpp>
+
+namespace iso15118::io {
+
+namespace {
+constexpr auto LOOPBACK_INTERFACE = "lo";
+
+bool is_same_address(const sockaddr_in6& a, const in6_addr& b) {
+    return std::memcmp(&a.sin6_addr, &b, sizeof(b)) == 0;
+}
+
+sockaddr_in6 make_address(const in6_addr& address, unsigned int index) {
+    sockaddr_in6 result{};
+    result.sin6_family = AF_INET6;
+    result.sin6_addr = address;
+    // as done by getifaddrs, only link local addresses are scoped
+    if (IN6_IS_ADDR_LINKLOCAL(&address)) {
+        result.sin6_scope_id = index;
+    }
+    return result;
+}
+
+int open_netlink_socket() {
+    const auto fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd == -1) {
+        return -1;
+    }
+
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV6_IFADDR;
+
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+} // namespace
+
+InterfaceRegistry& InterfaceRegistry::get_instance() {
+    static InterfaceRegistry instance;
+    return instance;
+}
+
+InterfaceRegistry::InterfaceRegistry() {
+    // subscribe before loading, so no change gets lost in between
+    netlink_fd = open_netlink_socket();
+
+    if (netlink_fd == -1) {
+        logf_warning("Failed to subscribe to rtnetlink, changes of the network interfaces will not be noticed");
+    }
+
+    load();
+}
+
+InterfaceRegistry::~InterfaceRegistry() {
+    if (netlink_fd != -1) {
+        close(netlink_fd);
+    }
+}
+
+bool InterfaceRegistry::handle_events() {
+    if (netlink_fd == -1) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    alignas(nlmsghdr) char buffer[8192];
+    auto changed = false;
+
+    while (true) {
+        const auto read_result = recv(netlink_fd, buffer, sizeof(buffer), 0);
+
+        if (read_result == -1 and errno == ENOBUFS) {
+            // lost track, so everything might have changed
+            try {
+                load();
+            } catch (const std::exception& e) {
+                // called from the event loop, so don't throw, but keep the cached interfaces
+                logf_error("Failed to reload the network interfaces: %s", e.what());
+            }
+            changed = true;
+            continue;
+        }
+
+        if (read_result <= 0) {
+            // EAGAIN, no (more) changes
+            return changed;
+        }
+
+        changed = apply_messages(buffer, read_result) or changed;
+    }
+}
+
+bool InterfaceRegistry::handle_messages(const void* buffer, std::size_t length) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return apply_messages(buffer, length);
+}
+
+bool InterfaceRegistry::apply_messages(const void* buffer, std::size_t length) {
+    auto changed = false;
+
+    auto remaining = static_cast<unsigned int>(length);
+    for (auto header = static_cast<const nlmsghdr*>(buffer); NLMSG_OK(header, remaining);
+         header = NLMSG_NEXT(header, remaining)) {
+        switch (header->nlmsg_type) {
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+            changed = handle_link_message(header) or changed;
+            break;
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+            changed = handle_address_message(header) or changed;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return changed;
+}
+
+std::optional<sockaddr_in6> InterfaceRegistry::get_address(const std::string& interface_name) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (interface_name == "auto") {
+        for (const auto& interface : interfaces) {
+            if (const auto address = get_preferred_address(interface)) {
+                logf_info("Found an ipv6 link local address for interface: %s", interface.name.c_str());
+                return address;
+            }
+        }
+        return std::nullopt;
+    }
+
+    const auto interface = find(interface_name);
+    if (interface == nullptr) {
+        return std::nullopt;
+    }
+
+    return get_preferred_address(*interface);
+}
+
+unsigned int InterfaceRegistry::get_index(const std::string& interface_name) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto interface = find(interface_name);
+    return (interface != nullptr) ? interface->index : 0;
+}
+
+std::string InterfaceRegistry::find_first_link_local_interface() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (const auto& interface : interfaces) {
+        const auto has_link_local_address =
+            std::any_of(interface.addresses.begin(), interface.addresses.end(),
+                        [](const sockaddr_in6& address) { return IN6_IS_ADDR_LINKLOCAL(&address.sin6_addr); });
+        if (has_link_local_address) {
+            return interface.name;
+        }
+    }
+
+    return {};
+}
+
+void InterfaceRegistry::load() {
+    struct ifaddrs* if_list_head;
+    if (getifaddrs(&if_list_head) == -1) {
+        log_and_throw("Failed to call getifaddrs");
+    }
+
+    interfaces.clear();
+
+    for (auto current_if = if_list_head; current_if != nullptr; current_if = current_if->ifa_next) {
+        auto interface = find(current_if->ifa_name);
+
+        if (interface == nullptr) {
+            const auto index = if_nametoindex(current_if->ifa_name);
+            if (index == 0) {
+                continue;
+            }
+            interface = &interfaces.emplace_back(Interface{current_if->ifa_name, index, {}});
+        }
+
+        if (current_if->ifa_addr == nullptr or current_if->ifa_addr->sa_family != AF_INET6) {
+            continue;
+        }
+
+        // NOTE (aw): because we did the check for AF_INET6, we can assume that ifa_addr is indeed an sockaddr_in6
+        const auto current_addr = reinterpret_cast<const sockaddr_in6*>(current_if->ifa_addr);
+        interface->addresses.push_back(*current_addr);
+    }
+
+    freeifaddrs(if_list_head);
+}
+
+bool InterfaceRegistry::handle_link_message(const nlmsghdr* header) {
+    const auto info = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+    const auto index = static_cast<unsigned int>(info->ifi_index);
+
+    if (header->nlmsg_type == RTM_DELLINK) {
+        const auto interface = std::find_if(interfaces.begin(), interfaces.end(),
+                                            [index](const Interface& interface) { return interface.index == index; });
+        if (interface == interfaces.end()) {
+            return false;
+        }
+
+        logf_info("Network interface %s was removed", interface->name.c_str());
+        interfaces.erase(interface);
+        return true;
+    }
+
+    std::string name;
+    auto payload_length = IFLA_PAYLOAD(header);
+    for (auto attribute = IFLA_RTA(info); RTA_OK(attribute, payload_length);
+         attribute = RTA_NEXT(attribute, payload_length)) {
+        if (attribute->rta_type == IFLA_IFNAME) {
+            name = static_cast<const char*>(RTA_DATA(attribute));
+        }
+    }
+
+    if (name.empty()) {
+        return false;
+    }
+
+    if (auto interface = find(index)) {
+        // e.g. a flag change, only a rename is of interest
+        if (interface->name == name) {
+            return false;
+        }
+        interface->name = name;
+        return true;
+    }
+
+    logf_info("Network interface %s was added", name.c_str());
+    interfaces.push_back(Interface{name, index, {}});
+    return true;
+}
+
+bool InterfaceRegistry::handle_address_message(const nlmsghdr* header) {
+    const auto info = static_cast<const ifaddrmsg*>(NLMSG_DATA(header));
+
+    if (info->ifa_family != AF_INET6) {
+        return false;
+    }
+
+    std::optional<in6_addr> address;
+    auto payload_length = IFA_PAYLOAD(header);
+    for (auto attribute = IFA_RTA(info); RTA_OK(attribute, payload_length);
+         attribute = RTA_NEXT(attribute, payload_length)) {
+        if (attribute->rta_type == IFA_ADDRESS and RTA_PAYLOAD(attribute) == sizeof(in6_addr)) {
+            address.emplace();
+            std::memcpy(&*address, RTA_DATA(attribute), sizeof(in6_addr));
+        }
+    }
+
+    if (not address) {
+        return false;
+    }
+
+    auto interface = find(info->ifa_index);
+
+    if (interface == nullptr) {
+        // the link notification might come later
+        char name[IF_NAMESIZE];
+        if (if_indextoname(info->ifa_index, name) == nullptr) {
+            return false;
+        }
+        interface = &interfaces.emplace_back(Interface{name, info->ifa_index, {}});
+    }
+
+    auto& addresses = interface->addresses;
+    const auto known_address = std::find_if(addresses.begin(), addresses.end(),
+                                            [&address](const sockaddr_in6& known) {
+                                                return is_same_address(known, *address);
+                                            });
+
+    if (header->nlmsg_type == RTM_DELADDR) {
+        if (known_address == addresses.end()) {
+            return false;
+        }
+        addresses.erase(known_address);
+        logf_info("Network interface %s lost an ipv6 address", interface->name.c_str());
+        return true;
+    }
+
+    if (known_address != addresses.end()) {
+        // e.g. a lifetime update
+        return false;
+    }
+
+    addresses.push_back(make_address(*address, interface->index));
+    logf_info("Network interface %s got a new ipv6 address", interface->name.c_str());
+    return true;
+}
+
+InterfaceRegistry::Interface* InterfaceRegistry::find(unsigned int index) {
+    const auto interface = std::find_if(interfaces.begin(), interfaces.end(),
+                                        [index](const Interface& interface) { return interface.index == index; });
+    return (interface != interfaces.end()) ? &*interface : nullptr;
+}
+
+InterfaceRegistry::Interface* InterfaceRegistry::find(const std::string& name) {
+    const auto interface = std::find_if(interfaces.begin(), interfaces.end(),
+                                        [&name](const Interface& interface) { return interface.name == name; });
+    return (interface != interfaces.end()) ? &*interface : nullptr;
+}
+
+std::optional<sockaddr_in6> InterfaceRegistry::get_preferred_address(const Interface& interface) const {
+    for (const auto& address : interface.addresses) {
+        // NOTE (sl): If using loopback device, accept any address. Loopback usually does not have a link local address
+        if (interface.name == LOOPBACK_INTERFACE or IN6_IS_ADDR_LINKLOCAL(&address.sin6_addr)) {
+            return address;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace iso15118::io
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/io/listener.hpp>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+
+#include <endian.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <iso15118/detail/helper.hpp>
+#include <iso15118/detail/io/socket_helper.hpp>
+
+namespace iso15118::io {
+
+namespace {
+constexpr auto DEFAULT_SOCKET_BACKLOG = 4;
+
+// socket option profile of accepted connections: requests and responses are small and latency bound, so don't wait
+// for more data (nagle), and detect a vanished EV (e.g. unplugged PLC modem) long before the V2G timeouts fire
+constexpr int KEEPALIVE_IDLE_S = 5;
+constexpr int KEEPALIVE_INTERVAL_S = 2;
+constexpr int KEEPALIVE_COUNT = 3;
+// max. time for sent data to be acknowledged, covers the keepalive probes as well
+constexpr unsigned int USER_TIMEOUT_MS = 15000;
+
+void set_socket_option(int fd, int level, int option_name, const void* value, socklen_t value_length,
+                       const char* option) {
+    if (setsockopt(fd, level, option_name, value, value_length) == -1) {
+        logf_warning("setsockopt(%s) failed with error code: %d", option, errno);
+    }
+}
+
+void apply_socket_option_profile(int fd) {
+    const int enable{1};
+    set_socket_option(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable), "TCP_NODELAY");
+    set_socket_option(fd, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable), "SO_KEEPALIVE");
+    set_socket_option(fd, IPPROTO_TCP, TCP_KEEPIDLE, &KEEPALIVE_IDLE_S, sizeof(KEEPALIVE_IDLE_S), "TCP_KEEPIDLE");
+    set_socket_option(fd, IPPROTO_TCP, TCP_KEEPINTVL, &KEEPALIVE_INTERVAL_S, sizeof(KEEPALIVE_INTERVAL_S),
+                      "TCP_KEEPINTVL");
+    set_socket_option(fd, IPPROTO_TCP, TCP_KEEPCNT, &KEEPALIVE_COUNT, sizeof(KEEPALIVE_COUNT), "TCP_KEEPCNT");
+    set_socket_option(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &USER_TIMEOUT_MS, sizeof(USER_TIMEOUT_MS),
+                      "TCP_USER_TIMEOUT");
+}
+
+// closes the socket, if the listener couldn't be set up completely
+class SocketGuard {
+public:
+    explicit SocketGuard(int fd_) : fd(fd_) {
+    }
+
+    SocketGuard(const SocketGuard&) = delete;
+    SocketGuard& operator=(const SocketGuard&) = delete;
+
+    ~SocketGuard() {
+        if (fd != -1) {
+            ::close(fd);
+        }
+    }
+
+    void release() {
+        fd = -1;
+    }
+
+private:
+    int fd;
+};
+} // namespace
+
+Listener::Listener(const std::string& interface_name_, uint16_t port) : interface_name(interface_name_) {
+    sockaddr_in6 address;
+    if (not get_first_sockaddr_in6_for_interface(interface_name, address)) {
+        const auto msg = "Failed to get ipv6 socket address for interface " + interface_name;
+        log_and_throw(msg.c_str());
+    }
+
+    // setup end point information
+    end_point.port = port;
+    memcpy(&end_point.address, &address.sin6_addr, sizeof(address.sin6_addr));
+
+    fd = socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        log_and_throw("Failed to create an ipv6 socket");
+    }
+
+    SocketGuard socket_guard(fd);
+
+    // before bind, set the port
+    address.sin6_port = htobe16(end_point.port);
+
+    int optval_tmp{1};
+    const auto set_reuseaddr = setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval_tmp, sizeof(optval_tmp));
+    if (set_reuseaddr == -1) {
+        log_and_throw("setsockopt(SO_REUSEADDR) failed");
+    }
+
+    const auto set_reuseport = setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &optval_tmp, sizeof(optval_tmp));
+    if (set_reuseport == -1) {
+        log_and_throw("setsockopt(SO_REUSEPORT) failed");
+    }
+
+    const auto bind_result = bind(fd, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address));
+    if (bind_result == -1) {
+        const auto error = "Failed to bind ipv6 socket to interface " + interface_name;
+        log_and_throw(error.c_str());
+    }
+
+    const auto listen_result = listen(fd, DEFAULT_SOCKET_BACKLOG);
+    if (listen_result == -1) {
+        log_and_throw("Listen on socket failed");
+    }
+
+    socket_guard.release();
+
+    const auto address_name = sockaddr_in6_to_name(address);
+    logf_info("Listening on [%s]:%" PRIu16, address_name ? address_name.get() : "?", end_point.port);
+}
+
+Listener::~Listener() {
+    if (fd != -1) {
+        ::close(fd);
+    }
+}
+
+int Listener::accept(sockaddr_in6& peer_address) {
+    socklen_t address_len = sizeof(peer_address);
+
+    const auto accept_fd = accept4(fd, reinterpret_cast<struct sockaddr*>(&peer_address), &address_len,
+                                   SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (accept_fd == -1) {
+        // the connection might have been reset by the peer, before it got accepted
+        if (errno == EAGAIN or errno == EWOULDBLOCK or errno == ECONNABORTED or errno == EINTR) {
+            return -1;
+        }
+        log_and_throw("Failed to accept4");
+    }
+
+    apply_socket_option_profile(accept_fd);
+
+    return accept_fd;
+}
+
+} // namespace iso15118::io
@@ -2,10 +2,12 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/io/poll_manager.hpp>
 
-#include <type_traits>
-#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <string>
 
-#include <poll.h>
+#include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <unistd.h>
 
@@ -13,70 +15,221 @@
 
 namespace iso15118::io {
 
-static PollSet create_poll_set(const std::map<int, PollCallback>& map, int event_fd) {
-    const auto total_size = map.size() + 1; // including event_fd
-    decltype(PollSet::fds) fds(total_size);
-    decltype(PollSet::callbacks) callbacks(total_size);
+namespace {
 
-    auto index = 0;
-    for (auto it = map.begin(); it != map.end(); ++it, ++index) {
-        fds[index].fd = it->first;
-        fds[index].events = POLLIN;
-        callbacks[index] = &it->second;
+constexpr uint64_t EVENT_FD_TAG = std::numeric_limits<uint64_t>::max();
+
+uint64_t make_tag(int fd, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+}
+
+int tag_to_fd(uint64_t tag) {
+    return static_cast<int>(static_cast<uint32_t>(tag & 0xFFFFFFFF));
+}
+
+uint32_t tag_to_generation(uint64_t tag) {
+    return static_cast<uint32_t>(tag >> 32);
+}
+
+uint32_t to_epoll_events(short events, PollTrigger trigger) {
+    uint32_t epoll_events = 0;
+
+    if (events & POLLIN) {
+        epoll_events |= EPOLLIN;
+    }
+
+    if (events & POLLOUT) {
+        epoll_events |= EPOLLOUT;
+    }
+
+    if (trigger == PollTrigger::EDGE) {
+        epoll_events |= EPOLLET;
+    }
+
+    return epoll_events;
+}
+
+short to_poll_events(uint32_t epoll_events) {
+    short events = 0;
+
+    if (epoll_events & EPOLLIN) {
+        events |= POLLIN;
+    }
+
+    if (epoll_events & EPOLLOUT) {
+        events |= POLLOUT;
     }
 
-    fds[index].fd = event_fd;
-    fds[index].events = POLLIN;
+    if (epoll_events & EPOLLERR) {
+        events |= POLLERR;
+    }
+
+    if (epoll_events & EPOLLHUP) {
+        events |= POLLHUP;
+    }
 
-    return {std::move(fds), std::move(callbacks)};
+    return events;
 }
 
+} // namespace
+
 PollManager::PollManager() {
-    event_fd = eventfd(0, 0);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1) {
+        log_and_throw("Failed to create epoll instance");
+    }
+
+    event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
     if (event_fd == -1) {
         log_and_throw("Failed to create eventfd");
     }
+
+    struct epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = EVENT_FD_TAG;
+
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event_fd, &event) == -1) {
+        log_and_throw("Failed to add eventfd to epoll instance");
+    }
 }
 
-void PollManager::register_fd(int fd, PollCallback& poll_callback) {
-    registered_fds.emplace(fd, poll_callback);
-    poll_set = create_poll_set(registered_fds, event_fd);
+PollManager::~PollManager() {
+    if (event_fd != -1) {
+        ::close(event_fd);
+    }
+
+    if (epoll_fd != -1) {
+        ::close(epoll_fd);
+    }
 }
 
-void PollManager::unregister_fd(int fd) {
-    registered_fds.erase(fd);
-    poll_set = create_poll_set(registered_fds, event_fd);
+void PollManager::register_fd(int fd, PollCallback& poll_callback) {
+    register_fd(fd, [poll_callback](short) { poll_callback(); }, POLLIN, PollTrigger::LEVEL);
 }
 
-void PollManager::poll(int timeout_ms) {
+void PollManager::register_fd(int fd, PollEventCallback& poll_callback, short events, PollTrigger trigger) {
+    const auto generation = next_generation++;
 
-    auto& pollfds = poll_set.fds;
+    struct epoll_event event {};
+    event.events = to_epoll_events(events, trigger);
+    event.data.u64 = make_tag(fd, generation);
 
-    const auto ret = ::poll(pollfds.data(), pollfds.size(), timeout_ms);
+    const auto [it, inserted] =
+        registered_fds.insert_or_assign(fd, Registration{poll_callback, events, trigger, generation});
+    auto ctl_result = epoll_ctl(epoll_fd, inserted ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event);
 
-    if (ret == -1) {
-        log_and_throw("Poll failed\n");
+    if (ctl_result == -1 and not inserted and errno == ENOENT) {
+        // the fd got closed without being unregistered and its number has been reused
+        ctl_result = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    if (ctl_result == -1) {
+        registered_fds.erase(it);
+        const auto msg = "Failed to register fd " + std::to_string(fd) + " with epoll";
+        log_and_throw(msg.c_str());
     }
+}
+
+void PollManager::modify_fd(int fd, short events) {
+    const auto it = registered_fds.find(fd);
+    if (it == registered_fds.end()) {
+        logf_warning("Tried to modify the events of the unregistered fd %d", fd);
+        return;
+    }
+
+    auto& registration = it->second;
 
-    if (ret == 0) {
-        // timeout
+    if (registration.events == events) {
         return;
     }
 
-    // first check for event_fd
-    if (pollfds[pollfds.size() - 1].revents & POLLIN) {
-        eventfd_t tmp;
-        eventfd_read(event_fd, &tmp);
+    struct epoll_event event {};
+    event.events = to_epoll_events(events, registration.trigger);
+    event.data.u64 = make_tag(fd, registration.generation);
 
-        // just break;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event) == -1) {
+        const auto msg = "Failed to modify events of fd " + std::to_string(fd);
+        log_and_throw(msg.c_str());
+    }
+
+    registration.events = events;
+}
+
+void PollManager::unregister_fd(int fd) {
+    if (registered_fds.erase(fd) == 0) {
         return;
     }
 
-    // check fds
-    for (std::size_t i = 0; i < pollfds.size() - 1; ++i) {
-        if (pollfds[i].revents & POLLIN) {
-            (*poll_set.callbacks[i])();
+    // NOTE: if the fd got already closed, the kernel did remove it from the interest list for us
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr) == -1 and errno != EBADF and errno != ENOENT) {
+        logf_warning("Failed to remove fd %d from epoll instance", fd);
+    }
+}
+
+TimerId PollManager::add_timer(int32_t timeout_ms, const TimerCallback& callback) {
+    const auto now = get_ticks();
+    timer_wheel.update(now);
+
+    return timer_wheel.add(now + std::max(timeout_ms, 0), callback);
+}
+
+void PollManager::cancel_timer(TimerId id) {
+    timer_wheel.cancel(id);
+}
+
+uint64_t PollManager::get_ticks() const {
+    const auto elapsed = std::chrono::steady_clock::now() - start_time;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+void PollManager::poll(int timeout_ms) {
+
+    timer_wheel.update(get_ticks());
+
+    if (const auto timer_timeout = timer_wheel.get_timeout()) {
+        const auto capped_timer_timeout =
+            static_cast<int>(std::min<uint64_t>(*timer_timeout, std::numeric_limits<int>::max()));
+        timeout_ms = (timeout_ms < 0) ? capped_timer_timeout : std::min(timeout_ms, capped_timer_timeout);
+    }
+
+    const auto ready_count = epoll_wait(epoll_fd, ready_list.data(), ready_list.size(), timeout_ms);
+
+    if (ready_count == -1 and errno != EINTR) {
+        log_and_throw("Poll failed\n");
+    }
+
+    dispatch_ready_list(ready_count);
+
+    timer_wheel.update(get_ticks());
+    timer_wheel.expire();
+}
+
+void PollManager::dispatch_ready_list(int ready_count) {
+    for (auto i = 0; i < ready_count; ++i) {
+        const auto tag = ready_list[i].data.u64;
+
+        if (tag == EVENT_FD_TAG) {
+            // woken up by abort(), the remaining ready fds still get dispatched, edge triggered events would get
+            // lost otherwise
+            eventfd_t tmp;
+            eventfd_read(event_fd, &tmp);
+            continue;
         }
+
+        // NOTE: a previous callback might have unregistered this fd, so look it up again
+        const auto it = registered_fds.find(tag_to_fd(tag));
+        if (it == registered_fds.end() or it->second.generation != tag_to_generation(tag)) {
+            continue;
+        }
+
+        const auto revents = to_poll_events(ready_list[i].events);
+        if ((revents & (it->second.events | POLLERR | POLLHUP)) == 0) {
+            continue;
+        }
+
+        // copy the callback, it might unregister itself while being called
+        const auto callback = it->second.callback;
+        callback(revents);
     }
 }
 
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/io/sdp_rate_limiter.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace iso15118::io {
+
+SdpRateLimiter::SdpRateLimiter(uint32_t burst_, std::chrono::milliseconds refill_interval_) :
+    burst(burst_), refill_interval(refill_interval_) {
+    buckets.reserve(MAX_TRACKED_PEERS);
+}
+
+bool SdpRateLimiter::allow(const sockaddr_in6& peer, const TimePoint& now) {
+    auto& bucket = get_bucket(peer, now);
+
+    const auto refills = (now - bucket.last_refill) / refill_interval;
+    if (refills > 0) {
+        if (bucket.tokens + refills >= burst) {
+            bucket.tokens = burst;
+            bucket.last_refill = now;
+        } else {
+            // keep the fraction of the interval, which already passed
+            bucket.tokens += refills;
+            bucket.last_refill += refills * refill_interval;
+        }
+    }
+
+    bucket.last_seen = now;
+
+    if (bucket.tokens == 0) {
+        return false;
+    }
+
+    bucket.tokens--;
+    return true;
+}
+
+SdpRateLimiter::Bucket& SdpRateLimiter::get_bucket(const sockaddr_in6& peer, const TimePoint& now) {
+    const auto bucket = std::find_if(buckets.begin(), buckets.end(), [&peer](const Bucket& bucket) {
+        return bucket.scope_id == peer.sin6_scope_id and
+               std::memcmp(&bucket.address, &peer.sin6_addr, sizeof(bucket.address)) == 0;
+    });
+
+    if (bucket != buckets.end()) {
+        return *bucket;
+    }
+
+    const Bucket new_bucket{peer.sin6_addr, peer.sin6_scope_id, burst, now, now};
+
+    if (buckets.size() < MAX_TRACKED_PEERS) {
+        return buckets.emplace_back(new_bucket);
+    }
+
+    auto& least_recently_seen = *std::min_element(
+        buckets.begin(), buckets.end(), [](const Bucket& a, const Bucket& b) { return a.last_seen < b.last_seen; });
+    least_recently_seen = new_bucket;
+
+    return least_recently_seen;
+}
+
+} // namespace iso15118::io
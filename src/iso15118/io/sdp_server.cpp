@@ -2,6 +2,8 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/io/sdp_server.hpp>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 
 #include <endian.h>
@@ -10,10 +12,12 @@
 
 #include <arpa/inet.h>
 #include <net/if.h>
+#include <sys/socket.h>
 
 #include <cbv2g/exi_v2gtp.h>
 
 #include <iso15118/detail/helper.hpp>
+#include <iso15118/detail/io/interface_registry.hpp>
 
 // FIXME(Sl): Not sure with define
 /* link-local multicast address ff02::1 aka ip6-allnodes */
@@ -38,7 +42,20 @@ static void log_peer_hostname(const struct sockaddr_in6& address) {
 
 namespace io {
 
-SdpServer::SdpServer(const std::string& interface_name) {
+static unsigned int get_interface_index(msghdr& header) {
+    for (auto control_message = CMSG_FIRSTHDR(&header); control_message != nullptr;
+         control_message = CMSG_NXTHDR(&header, control_message)) {
+        if (control_message->cmsg_level == IPPROTO_IPV6 and control_message->cmsg_type == IPV6_PKTINFO) {
+            in6_pktinfo packet_info;
+            memcpy(&packet_info, CMSG_DATA(control_message), sizeof(packet_info));
+            return packet_info.ipi6_ifindex;
+        }
+    }
+
+    return 0;
+}
+
+SdpServer::SdpServer(const std::vector<std::string>& interface_names_) : interface_names(interface_names_) {
     fd = socket(AF_INET6, SOCK_DGRAM, 0);
 
     if (fd == -1) {
@@ -59,29 +76,66 @@ SdpServer::SdpServer(const std::string& interface_name) {
         log_and_throw(error_msg.c_str());
     }
 
+    // instead of binding to a single device, the ingress interface of each request is reported
+    result = setsockopt(fd, IPPROTO_IPV6, IPV6_RECVPKTINFO, &enable, sizeof(enable));
+    if (result == -1) {
+        const auto error_msg = adding_err_msg("Setsockopt(IPV6_RECVPKTINFO) failed");
+        log_and_throw(error_msg.c_str());
+    }
+
     const auto bind_result =
         bind(fd, reinterpret_cast<const struct sockaddr*>(&socket_address), sizeof(socket_address));
     if (bind_result == -1) {
         log_and_throw("Failed to bind to socket");
     }
 
-    // Bind only to specified device
-    result = setsockopt(fd, SOL_SOCKET, SO_BINDTODEVICE, interface_name.c_str(), interface_name.length());
-    if (result == -1) {
-        const auto error_msg = adding_err_msg("Setsockopt(SO_BINDTODEVICE) failed");
-        log_and_throw(error_msg.c_str());
+    // Join multicast group on each interface
+    for (const auto& interface_name : interface_names) {
+        const auto interface_index = InterfaceRegistry::get_instance().get_index(interface_name);
+
+        if (not join_multicast_group(interface_index)) {
+            const auto error_msg = adding_err_msg("Setsockopt(IPV6_JOIN_GROUP) failed for " + interface_name);
+            log_and_throw(error_msg.c_str());
+        }
+
+        interface_indices.push_back(interface_index);
     }
+}
+
+void SdpServer::refresh() {
+    std::vector<unsigned int> current_indices;
 
-    // Join multicast group
+    for (const auto& interface_name : interface_names) {
+        const auto interface_index = InterfaceRegistry::get_instance().get_index(interface_name);
+
+        if (interface_index == 0) {
+            // gone, the kernel dropped the membership together with the interface
+            continue;
+        }
+
+        if (not is_served_interface(interface_index)) {
+            if (not join_multicast_group(interface_index)) {
+                logf_warning("Failed to join ff02::1 on interface %s: %s", interface_name.c_str(), strerror(errno));
+                continue;
+            }
+            logf_info("SDP server joined ff02::1 on interface %s", interface_name.c_str());
+        }
+
+        current_indices.push_back(interface_index);
+    }
+
+    interface_indices = std::move(current_indices);
+}
+
+bool SdpServer::join_multicast_group(unsigned int interface_index) {
     struct ipv6_mreq mreq {};
     mreq.ipv6mr_multiaddr = IN6ADDR_ALLNODES;
-    mreq.ipv6mr_interface = if_nametoindex(interface_name.c_str());
+    mreq.ipv6mr_interface = interface_index;
 
-    result = setsockopt(fd, IPPROTO_IPV6, IPV6_JOIN_GROUP, &mreq, sizeof(mreq));
-    if (result == -1) {
-        const auto error_msg = adding_err_msg("Setsockopt(IPV6_JOIN_GROUP) failed");
-        log_and_throw(error_msg.c_str());
-    }
+    return setsockopt(fd, IPPROTO_IPV6, IPV6_JOIN_GROUP, &mreq, sizeof(mreq)) == 0 or errno == EADDRINUSE;
+}
+
+SdpServer::SdpServer(const std::string& interface_name) : SdpServer(std::vector<std::string>{interface_name}) {
 }
 
 SdpServer::~SdpServer() {
@@ -92,29 +146,89 @@ SdpServer::~SdpServer() {
     }
 }
 
-PeerRequestContext SdpServer::get_peer_request() {
-    decltype(PeerRequestContext::address) peer_address;
-    socklen_t peer_addr_len = sizeof(peer_address);
+const std::vector<PeerRequestContext>& SdpServer::get_peer_requests() {
+    requests.clear();
+
+    mmsghdr messages[BATCH_SIZE];
+    iovec buffers[BATCH_SIZE];
+
+    for (auto batch = 0; batch < MAX_BATCHES_PER_CALL; ++batch) {
+        for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+            buffers[i] = {udp_buffers[i], sizeof(udp_buffers[i])};
+            messages[i] = {};
+            messages[i].msg_hdr.msg_name = &peer_addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(peer_addresses[i]);
+            messages[i].msg_hdr.msg_iov = &buffers[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_control = control_buffers[i];
+            messages[i].msg_hdr.msg_controllen = sizeof(control_buffers[i]);
+        }
 
-    const auto read_result = recvfrom(fd, udp_buffer, sizeof(udp_buffer), 0,
-                                      reinterpret_cast<struct sockaddr*>(&peer_address), &peer_addr_len);
-    if (read_result <= 0) {
-        log_and_throw("Read on sdp server socket failed");
-    }
+        const auto read_result = recvmmsg(fd, messages, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+
+        if (read_result == -1) {
+            if (errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR) {
+                // e.g. a pending ICMP error of a previous response, the socket stays usable
+                logf_warning("Read on sdp server socket failed: %s", strerror(errno));
+            }
+            break;
+        }
+
+        const auto now = get_current_time_point();
+
+        for (auto i = 0; i < read_result; ++i) {
+            auto& header = messages[i].msg_hdr;
+
+            if (header.msg_namelen > sizeof(peer_addresses[i])) {
+                logf_warning("Unexpected address length during read on sdp server socket");
+                continue;
+            }
+
+            const auto interface_index = get_interface_index(header);
+            if (not is_served_interface(interface_index)) {
+                // the socket isn't bound to a device, so anything sent to the SDP port ends up here
+                continue;
+            }
 
-    if (peer_addr_len > sizeof(peer_address)) {
-        log_and_throw("Unexpected address length during read on sdp server socket");
+            if (not rate_limiter.allow(peer_addresses[i], now)) {
+                // no logging here, a flooding peer would flood the log as well
+                continue;
+            }
+
+            auto request = parse_request(udp_buffers[i], messages[i].msg_len, header.msg_flags, peer_addresses[i]);
+            if (request) {
+                request.interface_index = interface_index;
+                requests.push_back(request);
+            }
+        }
+
+        if (static_cast<std::size_t>(read_result) < BATCH_SIZE) {
+            // socket is drained
+            break;
+        }
     }
 
+    return requests;
+}
+
+PeerRequestContext SdpServer::parse_request(const uint8_t* datagram, std::size_t length, int flags,
+                                            const sockaddr_in6& peer_address) {
     log_peer_hostname(peer_address);
 
-    if (read_result == sizeof(udp_buffer)) {
+    if (flags & MSG_TRUNC) {
         logf_warning("Read on sdp server socket succeeded, but message is to big for the buffer");
         return PeerRequestContext{false};
     }
 
+    // v2gtp header and the two bytes of the request
+    static constexpr std::size_t SDP_REQUEST_SIZE = 10;
+    if (length < SDP_REQUEST_SIZE) {
+        logf_warning("Sdp server received a truncated payload");
+        return PeerRequestContext{false};
+    }
+
     uint32_t sdp_payload_len;
-    const auto parse_sdp_result = V2GTP20_ReadHeader(udp_buffer, &sdp_payload_len, V2GTP20_SDP_REQUEST_PAYLOAD_ID);
+    const auto parse_sdp_result = V2GTP20_ReadHeader(datagram, &sdp_payload_len, V2GTP20_SDP_REQUEST_PAYLOAD_ID);
 
     if (parse_sdp_result != V2GTP_ERROR__NO_ERROR) {
         // FIXME (aw): we should not die here immediately
@@ -125,8 +239,8 @@ PeerRequestContext SdpServer::get_peer_request() {
     PeerRequestContext peer_request{true};
 
     // NOTE (aw): this could be moved into a constructor
-    const uint8_t sdp_request_byte1 = udp_buffer[8];
-    const uint8_t sdp_request_byte2 = udp_buffer[9];
+    const uint8_t sdp_request_byte1 = datagram[8];
+    const uint8_t sdp_request_byte2 = datagram[9];
     peer_request.security = static_cast<v2gtp::Security>(sdp_request_byte1);
     peer_request.transport_protocol = static_cast<v2gtp::TransportProtocol>(sdp_request_byte2);
     memcpy(&peer_request.address, &peer_address, sizeof(peer_address));
@@ -134,6 +248,10 @@ PeerRequestContext SdpServer::get_peer_request() {
     return peer_request;
 }
 
+bool SdpServer::is_served_interface(unsigned int interface_index) const {
+    return std::find(interface_indices.begin(), interface_indices.end(), interface_index) != interface_indices.end();
+}
+
 void SdpServer::send_response(const PeerRequestContext& request, const Ipv6EndPoint& ipv6_endpoint) {
     // that worked, now response
     uint8_t v2g_packet[28];
@@ -149,9 +267,31 @@ void SdpServer::send_response(const PeerRequestContext& request, const Ipv6EndPo
 
     V2GTP20_WriteHeader(v2g_packet, 20, V2GTP20_SDP_RESPONSE_PAYLOAD_ID);
 
-    const auto peer_addr_len = sizeof(request.address);
+    // answer on the interface, the request was received on
+    iovec buffer{v2g_packet, sizeof(v2g_packet)};
+    alignas(cmsghdr) uint8_t control_buffer[CMSG_SPACE(sizeof(in6_pktinfo))]{};
+
+    msghdr message{};
+    message.msg_name = const_cast<sockaddr_in6*>(&request.address);
+    message.msg_namelen = sizeof(request.address);
+    message.msg_iov = &buffer;
+    message.msg_iovlen = 1;
+
+    if (request.interface_index != 0) {
+        message.msg_control = control_buffer;
+        message.msg_controllen = sizeof(control_buffer);
+
+        const auto control_message = CMSG_FIRSTHDR(&message);
+        control_message->cmsg_level = IPPROTO_IPV6;
+        control_message->cmsg_type = IPV6_PKTINFO;
+        control_message->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
 
-    sendto(fd, v2g_packet, sizeof(v2g_packet), 0, reinterpret_cast<const sockaddr*>(&request.address), peer_addr_len);
+        in6_pktinfo packet_info{};
+        packet_info.ipi6_ifindex = request.interface_index;
+        memcpy(CMSG_DATA(control_message), &packet_info, sizeof(packet_info));
+    }
+
+    sendmsg(fd, &message, 0);
 }
 TlsKeyLoggingServer::TlsKeyLoggingServer(const std::string& interface_name, uint16_t port_) : port(port_) {
     static constexpr auto LINK_LOCAL_MULTICAST = "ff02::1";
@@ -164,25 +304,22 @@ TlsKeyLoggingServer::TlsKeyLoggingServer(const std::string& interface_name, uint
 
     // source setup
 
-    // find port between 49152-65535
-    auto could_bind = false;
-    auto source_port = 49152;
-    for (; source_port < 65535; source_port++) {
-        sockaddr_in6 source_address = {AF_INET6, htons(source_port), 0, {}, 0};
-        if (bind(fd, reinterpret_cast<sockaddr*>(&source_address), sizeof(sockaddr_in6)) == 0) {
-            could_bind = true;
-            break;
-        }
+    // let the kernel pick a free port from the ephemeral range
+    sockaddr_in6 source_address = {AF_INET6, 0, 0, {}, 0};
+    if (bind(fd, reinterpret_cast<sockaddr*>(&source_address), sizeof(sockaddr_in6)) != 0) {
+        const auto error_msg = adding_err_msg("Could not bind");
+        log_and_throw(error_msg.c_str());
     }
 
-    if (!could_bind) {
-        const auto error_msg = adding_err_msg("Could not bind");
+    socklen_t source_address_length = sizeof(source_address);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&source_address), &source_address_length) != 0) {
+        const auto error_msg = adding_err_msg("Could not get the bound address");
         log_and_throw(error_msg.c_str());
     }
 
-    logf_info("UDP socket bound to source port: %u", source_port);
+    logf_info("UDP socket bound to source port: %u", ntohs(source_address.sin6_port));
 
-    const auto index = if_nametoindex(interface_name.c_str());
+    const auto index = InterfaceRegistry::get_instance().get_index(interface_name);
     auto mreq = ipv6_mreq{};
     mreq.ipv6mr_interface = index;
     if (inet_pton(AF_INET6, LINK_LOCAL_MULTICAST, &mreq.ipv6mr_multiaddr) <= 0) {
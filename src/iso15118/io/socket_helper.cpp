@@ -5,57 +5,24 @@
 #include <cstring>
 
 #include <arpa/inet.h>
-#include <ifaddrs.h>
 #include <net/if.h>
 #include <netdb.h>
 #include <netinet/in.h>
 
 #include <iso15118/detail/helper.hpp>
+#include <iso15118/detail/io/interface_registry.hpp>
 
 namespace iso15118::io {
 
-namespace {
-
-auto choose_first_ipv6_interface() {
-    std::string interface_name{};
-    struct ifaddrs* if_list_head;
-    const auto get_if_addrs_result = getifaddrs(&if_list_head);
-
-    if (get_if_addrs_result == -1) {
-        logf_error("Failed to call getifaddrs");
-        return std::string("");
-    }
-
-    for (auto current_if = if_list_head; current_if != nullptr; current_if = current_if->ifa_next) {
-        if (current_if->ifa_addr == nullptr or current_if->ifa_addr->sa_family != AF_INET6) {
-            continue;
-        }
-
-        // NOTE (aw): because we did the check for AF_INET6, we can assume that ifa_addr is indeed an sockaddr_in6
-        const auto current_addr = reinterpret_cast<const sockaddr_in6*>(current_if->ifa_addr);
-        if (not IN6_IS_ADDR_LINKLOCAL(&(current_addr->sin6_addr))) {
-            continue;
-        }
-        interface_name = current_if->ifa_name;
-        break; // Stop the loop if a interface is found
-    }
-    freeifaddrs(if_list_head);
-
-    return interface_name;
-}
-
-} // namespace
-
 bool check_and_update_interface(std::string& interface_name) {
+    auto& registry = InterfaceRegistry::get_instance();
 
     if (interface_name == "auto") {
         logf_info("Search for the first available ipv6 interface");
-        interface_name = choose_first_ipv6_interface();
+        interface_name = registry.find_first_link_local_interface();
     }
 
-    struct ipv6_mreq mreq {};
-    mreq.ipv6mr_interface = if_nametoindex(interface_name.c_str());
-    if (!mreq.ipv6mr_interface) {
+    if (registry.get_index(interface_name) == 0) {
         logf_error("No such interface: %s", interface_name.c_str());
         return false;
     }
@@ -63,49 +30,15 @@ bool check_and_update_interface(std::string& interface_name) {
 }
 
 bool get_first_sockaddr_in6_for_interface(const std::string& interface_name, sockaddr_in6& address) {
-    struct ifaddrs* if_list_head;
-    const auto get_if_addrs_result = getifaddrs(&if_list_head);
-
-    if (get_if_addrs_result == -1) {
-        log_and_throw("Failed to call getifaddrs");
-    }
+    const auto interface_address = InterfaceRegistry::get_instance().get_address(interface_name);
 
-    bool found_interface = false;
-
-    for (auto current_if = if_list_head; current_if != nullptr; current_if = current_if->ifa_next) {
-        if (current_if->ifa_addr == nullptr) {
-            continue;
-        }
-
-        if (current_if->ifa_addr->sa_family != AF_INET6) {
-            continue;
-        }
-
-        if (interface_name.compare("auto") != 0 && interface_name.compare(current_if->ifa_name) != 0) {
-            continue;
-        }
-
-        // NOTE (aw): because we did the check for AF_INET6, we can assume that ifa_addr is indeed an sockaddr_in6
-        const auto current_addr = reinterpret_cast<const sockaddr_in6*>(current_if->ifa_addr);
-
-        // NOTE (sl): If using loopback device, accept any address. Loopback usually does not have a link local address
-        if (interface_name.compare("lo") != 0 and not IN6_IS_ADDR_LINKLOCAL(&(current_addr->sin6_addr))) {
-            continue;
-        }
-
-        if (interface_name == "auto") {
-            logf_info("Found an ipv6 link local address for interface: %s", current_if->ifa_name);
-        }
-
-        memcpy(&address, current_addr, sizeof(address));
-        found_interface = true;
-        break; // Stop the loop if a interface is found
+    // Todo(sl): What to do if interface was not found?
+    if (not interface_address) {
+        return false;
     }
 
-    freeifaddrs(if_list_head);
-
-    // Todo(sl): What to do if interface was not found?
-    return found_interface;
+    address = *interface_address;
+    return true;
 }
 
 std::unique_ptr<char[]> sockaddr_in6_to_name(const sockaddr_in6& address) {
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/detail/io/ssl_context_cache.hpp>
+
+#include <algorithm>
+#include <exception>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <iso15118/detail/helper.hpp>
+
+namespace iso15118::io {
+
+namespace {
+
+constexpr auto WATCHED_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+
+bool is_same_config(const config::SSLConfig& a, const config::SSLConfig& b) {
+    return a.backend == b.backend and a.config_string == b.config_string and
+           a.path_certificate_chain == b.path_certificate_chain and a.path_certificate_key == b.path_certificate_key and
+           a.private_key_password == b.private_key_password and
+           a.path_certificate_v2g_root == b.path_certificate_v2g_root and
+           a.path_certificate_mo_root == b.path_certificate_mo_root and a.enable_ssl_logging == b.enable_ssl_logging and
+           a.enable_tls_key_logging == b.enable_tls_key_logging and a.enforce_tls_1_3 == b.enforce_tls_1_3 and
+           a.tls_key_logging_path == b.tls_key_logging_path and
+           a.enable_session_resumption == b.enable_session_resumption and
+           a.session_cache_size == b.session_cache_size and a.enable_ktls == b.enable_ktls;
+}
+
+std::shared_ptr<SSL_CTX> build_context(const SSLContextCache::Builder& builder, const config::SSLConfig& config) {
+    return std::shared_ptr<SSL_CTX>(builder(config), SSL_CTX_free);
+}
+
+} // namespace
+
+SSLContextCache& SSLContextCache::get_instance() {
+    static SSLContextCache instance;
+    return instance;
+}
+
+SSLContextCache::SSLContextCache() {
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (inotify_fd == -1) {
+        logf_warning("Failed to initialize inotify, changed certificates will not be reloaded");
+    }
+}
+
+SSLContextCache::~SSLContextCache() {
+    if (inotify_fd != -1) {
+        close(inotify_fd);
+    }
+}
+
+std::shared_ptr<SSL_CTX> SSLContextCache::get(const config::SSLConfig& config, const Builder& builder) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    handle_file_events();
+
+    auto entry = std::find_if(entries.begin(), entries.end(),
+                              [&config](const Entry& entry) { return is_same_config(entry.config, config); });
+
+    if (entry == entries.end()) {
+        entry = entries.insert(entries.end(), Entry{config, nullptr, {}, false});
+
+        try {
+            entry->ctx = build_context(builder, entry->config);
+        } catch (...) {
+            entries.erase(entry);
+            throw;
+        }
+
+        watch_files(*entry);
+
+        return entry->ctx;
+    }
+
+    if (entry->outdated) {
+        try {
+            entry->ctx = build_context(builder, entry->config);
+            entry->outdated = false;
+            logf_info("Reloaded TLS context, because its certificate files changed");
+        } catch (const std::exception& e) {
+            // NOTE: the files might have been read while they were written, the write might not trigger another
+            // event, so the entry stays outdated and the next lookup tries again
+            logf_error("Failed to reload TLS context, keeping the previous one: %s", e.what());
+        }
+    }
+
+    return entry->ctx;
+}
+
+void SSLContextCache::watch_files(Entry& entry) {
+    for (const auto& file : {entry.config.path_certificate_chain, entry.config.path_certificate_key,
+                             entry.config.path_certificate_v2g_root, entry.config.path_certificate_mo_root}) {
+        if (file.empty()) {
+            continue;
+        }
+
+        std::error_code ec;
+        const auto path = std::filesystem::absolute(file, ec).lexically_normal();
+        if (ec) {
+            continue;
+        }
+
+        entry.files.push_back(path);
+
+        if (inotify_fd == -1) {
+            continue;
+        }
+
+        // NOTE: watching the directory instead of the file itself also catches files, which get replaced by a rename
+        const auto directory = path.parent_path();
+        const auto wd = inotify_add_watch(inotify_fd, directory.c_str(), WATCHED_EVENTS);
+
+        if (wd == -1) {
+            logf_warning("Failed to watch %s, changed certificates will not be reloaded", directory.c_str());
+            continue;
+        }
+
+        watched_directories.insert_or_assign(wd, directory);
+    }
+}
+
+void SSLContextCache::handle_file_events() {
+    if (inotify_fd == -1) {
+        return;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+
+    while (true) {
+        const auto read_result = read(inotify_fd, buffer, sizeof(buffer));
+
+        if (read_result <= 0) {
+            // EAGAIN, no (more) changes
+            return;
+        }
+
+        for (auto offset = 0; offset < read_result;) {
+            const auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // lost track, so everything might have changed
+                for (auto& entry : entries) {
+                    entry.outdated = true;
+                }
+                continue;
+            }
+
+            const auto directory = watched_directories.find(event->wd);
+            if (directory == watched_directories.end() or event->len == 0) {
+                continue;
+            }
+
+            const auto path = directory->second / event->name;
+
+            for (auto& entry : entries) {
+                if (std::find(entry.files.begin(), entry.files.end(), path) != entry.files.end()) {
+                    entry.outdated = true;
+                }
+            }
+        }
+    }
+}
+
+} // namespace iso15118::io
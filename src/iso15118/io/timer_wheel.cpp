@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/io/timer_wheel.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace iso15118::io {
+
+namespace {
+
+uint64_t rotl(uint64_t value, unsigned int count) {
+    count &= 63;
+    if (count == 0) {
+        return value;
+    }
+    return (value << count) | (value >> (64 - count));
+}
+
+uint64_t rotr(uint64_t value, unsigned int count) {
+    count &= 63;
+    if (count == 0) {
+        return value;
+    }
+    return (value >> count) | (value << (64 - count));
+}
+
+// find last (most significant) set bit, 1 based, value must not be zero
+int fls(uint64_t value) {
+    return 64 - __builtin_clzll(value);
+}
+
+// count trailing zeros, value must not be zero
+int ctz(uint64_t value) {
+    return __builtin_ctzll(value);
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(uint64_t now) : current_time(now) {
+}
+
+TimerId TimerWheel::add(uint64_t expires, const TimerCallback& callback) {
+    const auto id = next_id++;
+
+    // NOTE: the timer is first put onto the expired list and then moved to its final position
+    expired.push_back({id, expires, callback});
+    const auto it = std::prev(expired.end());
+    timers.emplace(id, TimerLocation{&expired, it});
+
+    schedule(expired, it);
+
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    const auto location = timers.find(id);
+    if (location == timers.end()) {
+        return false;
+    }
+
+    auto& [list, it, wheel, slot] = location->second;
+    list->erase(it);
+
+    if (list != &expired and list->empty()) {
+        pending_slots[wheel] &= ~(uint64_t(1) << slot);
+    }
+
+    timers.erase(location);
+
+    return true;
+}
+
+void TimerWheel::schedule(TimerList& from, TimerList::iterator it) {
+    auto& location = timers.at(it->id);
+    const auto expires = it->expires;
+
+    if (expires <= current_time) {
+        expired.splice(expired.end(), from, it);
+        location.list = &expired;
+        return;
+    }
+
+    const auto remaining = std::min(expires - current_time, MAX_TIMEOUT);
+    const auto wheel = (fls(remaining) - 1) / WHEEL_BITS;
+    const auto slot = WHEEL_MASK & ((expires >> (wheel * WHEEL_BITS)) - (wheel ? 1 : 0));
+
+    auto& list = wheels[wheel][slot];
+    list.splice(list.end(), from, it);
+    location.list = &list;
+    location.wheel = wheel;
+    location.slot = static_cast<int>(slot);
+
+    pending_slots[wheel] |= uint64_t(1) << slot;
+}
+
+void TimerWheel::update(uint64_t now) {
+    if (now <= current_time) {
+        return;
+    }
+
+    auto elapsed = now - current_time;
+    TimerList todo;
+
+    for (auto wheel = 0; wheel < WHEEL_COUNT; ++wheel) {
+        const auto shift = wheel * WHEEL_BITS;
+        uint64_t pending;
+
+        // mark all the slots between the last processed and the current one (inclusive) as due, if the elapsed time
+        // exceeds the period of this wheel, all slots are due
+        if ((elapsed >> shift) > WHEEL_MASK) {
+            pending = std::numeric_limits<uint64_t>::max();
+        } else {
+            const auto elapsed_slots = static_cast<unsigned int>(WHEEL_MASK & (elapsed >> shift));
+            const auto old_slot = static_cast<unsigned int>(WHEEL_MASK & (current_time >> shift));
+            const auto new_slot = static_cast<unsigned int>(WHEEL_MASK & (now >> shift));
+            const auto fill = (uint64_t(1) << elapsed_slots) - 1;
+
+            pending = rotl(fill, old_slot);
+            pending |= rotr(rotl(fill, new_slot), elapsed_slots);
+            pending |= uint64_t(1) << new_slot;
+        }
+
+        while (pending & pending_slots[wheel]) {
+            const auto slot = ctz(pending & pending_slots[wheel]);
+            todo.splice(todo.end(), wheels[wheel][slot]);
+            pending_slots[wheel] &= ~(uint64_t(1) << slot);
+        }
+
+        if ((pending & 0x1) == 0) {
+            // this wheel didn't wrap around, so the higher ones didn't tick
+            break;
+        }
+
+        // the next wheel needs to tick at least once
+        elapsed = std::max(elapsed, uint64_t(WHEEL_LENGTH) << shift);
+    }
+
+    current_time = now;
+
+    for (auto& timer : todo) {
+        timers.at(timer.id).list = &todo;
+    }
+
+    while (not todo.empty()) {
+        schedule(todo, todo.begin());
+    }
+}
+
+std::size_t TimerWheel::expire() {
+    std::size_t called{0};
+
+    // NOTE: only call the timers which are expired by now, callbacks might add already expired timers again
+    for (auto count = expired.size(); count > 0 and not expired.empty(); --count) {
+        auto& timer = expired.front();
+        const auto callback = std::move(timer.callback);
+
+        timers.erase(timer.id);
+        expired.pop_front();
+
+        callback();
+        called++;
+    }
+
+    return called;
+}
+
+std::optional<uint64_t> TimerWheel::get_timeout() const {
+    if (not expired.empty()) {
+        return 0;
+    }
+
+    if (timers.empty()) {
+        return std::nullopt;
+    }
+
+    auto timeout = std::numeric_limits<uint64_t>::max();
+    uint64_t relative_mask = 0;
+
+    for (auto wheel = 0; wheel < WHEEL_COUNT; ++wheel) {
+        const auto shift = wheel * WHEEL_BITS;
+
+        if (pending_slots[wheel]) {
+            const auto slot = static_cast<unsigned int>(WHEEL_MASK & (current_time >> shift));
+
+            // timers on higher wheels are one rotation in the future, otherwise they would be on a lower wheel
+            auto wheel_timeout = static_cast<uint64_t>(ctz(rotr(pending_slots[wheel], slot)) + (wheel ? 1 : 0))
+                                 << shift;
+
+            // reduce by how much the lower wheels have progressed
+            wheel_timeout -= relative_mask & current_time;
+
+            timeout = std::min(timeout, wheel_timeout);
+        }
+
+        relative_mask <<= WHEEL_BITS;
+        relative_mask |= WHEEL_MASK;
+    }
+
+    return timeout;
+}
+
+} // namespace iso15118::io
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/detail/io/tls_key_log_writer.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <map>
+
+#include <iso15118/detail/helper.hpp>
+#include <iso15118/io/sdp_server.hpp>
+
+namespace iso15118::io {
+
+namespace {
+constexpr auto KEY_LOG_FILE_NAME = "tls_session_keys.log";
+
+static_assert((TlsKeyLogWriter::QUEUE_SIZE & (TlsKeyLogWriter::QUEUE_SIZE - 1)) == 0,
+              "The queue size needs to be a power of two");
+} // namespace
+
+TlsKeyLogWriter& TlsKeyLogWriter::get_instance() {
+    static TlsKeyLogWriter instance;
+    return instance;
+}
+
+TlsKeyLogWriter::TlsKeyLogWriter() : slots(std::make_unique<Slot[]>(QUEUE_SIZE)) {
+    for (std::size_t i = 0; i < QUEUE_SIZE; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    thread = std::thread(&TlsKeyLogWriter::run, this);
+}
+
+TlsKeyLogWriter::~TlsKeyLogWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    stop_condition.notify_one();
+    thread.join();
+}
+
+// bounded multi producer queue, a slot with sequence == position is free for the producer claiming that position, a
+// slot with sequence == position + 1 is filled and ready for the writer thread
+bool TlsKeyLogWriter::push(const char* line, const std::filesystem::path& directory,
+                           std::shared_ptr<TlsKeyLoggingServer> server) {
+    const auto length = strnlen(line, MAX_LINE_LENGTH);
+    if (length == MAX_LINE_LENGTH) {
+        dropped_lines++;
+        return false;
+    }
+
+    auto position = enqueue_position.load(std::memory_order_relaxed);
+    Slot* slot{nullptr};
+
+    while (true) {
+        slot = &slots[position & (QUEUE_SIZE - 1)];
+        const auto sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+        if (difference == 0) {
+            if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // the writer thread didn't catch up yet
+            dropped_lines++;
+            return false;
+        } else {
+            // another producer claimed this position
+            position = enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::memcpy(slot->line.text, line, length + 1);
+    slot->line.length = length;
+    slot->line.directory = &directory;
+    slot->line.server = std::move(server);
+
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool TlsKeyLogWriter::pop(Line& line) {
+    auto& slot = slots[dequeue_position & (QUEUE_SIZE - 1)];
+
+    if (slot.sequence.load(std::memory_order_acquire) != dequeue_position + 1) {
+        return false;
+    }
+
+    std::memcpy(line.text, slot.line.text, slot.line.length + 1);
+    line.length = slot.line.length;
+    line.directory = slot.line.directory;
+    line.server = std::move(slot.line.server);
+
+    slot.sequence.store(dequeue_position + QUEUE_SIZE, std::memory_order_release);
+    dequeue_position++;
+
+    return true;
+}
+
+void TlsKeyLogWriter::run() {
+    // the files are opened on first use and kept open, a file, which failed to open, stays in the failed state
+    std::map<std::filesystem::path, std::ofstream> files;
+    Line line;
+
+    auto write_batch = [&]() {
+        auto written = false;
+
+        while (pop(line)) {
+            auto file = files.find(*line.directory);
+
+            if (file == files.end()) {
+                const auto path = *line.directory / KEY_LOG_FILE_NAME;
+                file = files.emplace(*line.directory, std::ofstream(path, std::ofstream::out | std::ofstream::app))
+                           .first;
+
+                if (not file->second.is_open()) {
+                    logf_error("Failed to open the TLS key log file %s", path.c_str());
+                }
+            }
+
+            if (file->second.is_open()) {
+                file->second.write(line.text, line.length).put('\n');
+                written = true;
+            }
+
+            if (line.server != nullptr and line.server->get_fd() != -1) {
+                const auto result = line.server->send(line.text);
+                if (not cmp_equal(result, line.length)) {
+                    const auto error_msg = adding_err_msg("key_logging_server send() failed");
+                    logf_error(error_msg.c_str());
+                }
+            }
+
+            line.server.reset();
+        }
+
+        if (written) {
+            for (auto& file : files) {
+                file.second.flush();
+            }
+        }
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        stop_condition.wait_for(lock, FLUSH_INTERVAL, [this]() { return stop; });
+        const auto stopping = stop;
+
+        lock.unlock();
+        write_batch();
+        lock.lock();
+
+        if (stopping) {
+            // everything queued before the stop request is written out by now
+            return;
+        }
+    }
+}
+
+} // namespace iso15118::io
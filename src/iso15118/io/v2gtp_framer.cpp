@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/io/v2gtp_framer.hpp>
+
+#include <cassert>
+#include <cstring>
+
+#include <endian.h>
+
+#include <iso15118/io/sdp_packet.hpp>
+
+#include <iso15118/detail/helper.hpp>
+
+namespace iso15118::io {
+
+ReadResult V2gtpFramer::read(IConnection& connection) {
+    if (begin == end) {
+        begin = end = 0;
+    } else if (sizeof(buffer) - end < MAX_FRAME_SIZE) {
+        // not enough space left for a complete frame, move the incomplete one to the front
+        std::memmove(buffer, buffer + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+
+    assert(end < sizeof(buffer));
+
+    const auto result = connection.read(buffer + end, sizeof(buffer) - end);
+    end += result.bytes_read;
+
+    return result;
+}
+
+std::optional<V2gtpFrame> V2gtpFramer::next_frame() {
+    const auto available = end - begin;
+
+    if (available < SdpPacket::V2GTP_HEADER_SIZE) {
+        return std::nullopt;
+    }
+
+    const auto header = buffer + begin;
+
+    if ((header[0] != SDP_PROTOCOL_VERSION) or (header[1] != SDP_INVERSE_PROTOCOL_VERSION)) {
+        log_and_throw("Error while reading V2GTP frame: invalid header");
+    }
+
+    uint16_t payload_type;
+    std::memcpy(&payload_type, header + 2, sizeof(payload_type));
+
+    uint32_t payload_length;
+    std::memcpy(&payload_length, header + 4, sizeof(payload_length));
+    payload_length = be32toh(payload_length);
+
+    if (payload_length > MAX_FRAME_SIZE - SdpPacket::V2GTP_HEADER_SIZE) {
+        log_and_throw("Error while reading V2GTP frame: frame too large for buffer");
+    }
+
+    const auto frame_size = payload_length + SdpPacket::V2GTP_HEADER_SIZE;
+
+    if (available < frame_size) {
+        // incomplete frame
+        return std::nullopt;
+    }
+
+    begin += frame_size;
+
+    return V2gtpFrame{static_cast<v2gtp::PayloadType>(be16toh(payload_type)), header + SdpPacket::V2GTP_HEADER_SIZE,
+                      payload_length};
+}
+
+} // namespace iso15118::io
@@ -2,8 +2,10 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/message/authorization.hpp>
 
+#include <cstring>
 #include <type_traits>
 
+#include <iso15118/detail/exi_template.hpp>
 #include <iso15118/detail/variant_access.hpp>
 
 #include <cbv2g/iso_20/iso20_CommonMessages_Encoder.h>
@@ -89,6 +91,41 @@ template <> size_t serialize(const AuthorizationResponse& in, const io::StreamOu
     return serialize_helper(in, out);
 }
 
+AuthorizationResponseBuilder::AuthorizationResponseBuilder(iso20_exiDocument& document_) : document(&document_) {
+    init_iso20_exiDocument(document);
+    CB_SET_USED(document->AuthorizationRes);
+
+    // zeroed, so that equal messages compare equal for the response template
+    std::memset(&document->AuthorizationRes, 0, sizeof(document->AuthorizationRes));
+    init_iso20_AuthorizationResType(&document->AuthorizationRes);
+}
+
+AuthorizationResponseBuilder& AuthorizationResponseBuilder::set(const AuthorizationResponse& in) {
+    convert(in, document->AuthorizationRes);
+    return *this;
+}
+
+template <> int serialize_to_exi(const AuthorizationResponseBuilder& in, exi_bitstream_t& out) {
+    return encode_iso20_exiDocument(&out, &in.get_document());
+}
+
+template <> size_t serialize(const AuthorizationResponseBuilder& in, const io::StreamOutputView& out) {
+    return serialize_helper(in, out);
+}
+
+static constexpr std::array<ExiPatchField, 1> AUTHORIZATION_RES_PATCH_FIELDS = {
+    EXI_PATCH_FIELD(iso20_AuthorizationResType, Header.TimeStamp, UnsignedInteger),
+};
+
+template <>
+size_t serialize(const AuthorizationResponseBuilder& in, ResponseTemplates& templates,
+                 const io::StreamOutputView& out) {
+    auto& document = in.get_document();
+    auto& exi_template = templates.get(Type::AuthorizationRes);
+    return serialize_with_template<encode_iso20_exiDocument>(exi_template, document, document.AuthorizationRes,
+                                                             AUTHORIZATION_RES_PATCH_FIELDS, out);
+}
+
 template <> size_t serialize(const AuthorizationRequest& in, const io::StreamOutputView& out) {
     return serialize_helper(in, out);
 }
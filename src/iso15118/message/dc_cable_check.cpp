@@ -2,8 +2,10 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/message/dc_cable_check.hpp>
 
+#include <cstring>
 #include <type_traits>
 
+#include <iso15118/detail/exi_template.hpp>
 #include <iso15118/detail/variant_access.hpp>
 
 #include <cbv2g/iso_20/iso20_DC_Decoder.h>
@@ -41,4 +43,39 @@ template <> size_t serialize(const DC_CableCheckResponse& in, const io::StreamOu
     return serialize_helper(in, out);
 }
 
+DC_CableCheckResponseBuilder::DC_CableCheckResponseBuilder(iso20_dc_exiDocument& document_) : document(&document_) {
+    init_iso20_dc_exiDocument(document);
+    CB_SET_USED(document->DC_CableCheckRes);
+
+    // zeroed, so that equal messages compare equal for the response template
+    std::memset(&document->DC_CableCheckRes, 0, sizeof(document->DC_CableCheckRes));
+    init_iso20_dc_DC_CableCheckResType(&document->DC_CableCheckRes);
+}
+
+DC_CableCheckResponseBuilder& DC_CableCheckResponseBuilder::set(const DC_CableCheckResponse& in) {
+    convert(in, document->DC_CableCheckRes);
+    return *this;
+}
+
+template <> int serialize_to_exi(const DC_CableCheckResponseBuilder& in, exi_bitstream_t& out) {
+    return encode_iso20_dc_exiDocument(&out, &in.get_document());
+}
+
+template <> size_t serialize(const DC_CableCheckResponseBuilder& in, const io::StreamOutputView& out) {
+    return serialize_helper(in, out);
+}
+
+static constexpr std::array<ExiPatchField, 1> DC_CABLE_CHECK_RES_PATCH_FIELDS = {
+    EXI_PATCH_FIELD(iso20_dc_DC_CableCheckResType, Header.TimeStamp, UnsignedInteger),
+};
+
+template <>
+size_t serialize(const DC_CableCheckResponseBuilder& in, ResponseTemplates& templates,
+                 const io::StreamOutputView& out) {
+    auto& document = in.get_document();
+    auto& exi_template = templates.get(Type::DC_CableCheckRes);
+    return serialize_with_template<encode_iso20_dc_exiDocument>(exi_template, document, document.DC_CableCheckRes,
+                                                                DC_CABLE_CHECK_RES_PATCH_FIELDS, out);
+}
+
 } // namespace iso15118::message_20
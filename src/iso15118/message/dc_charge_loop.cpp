@@ -2,8 +2,12 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/message/dc_charge_loop.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <type_traits>
 
+#include <iso15118/detail/exi_template.hpp>
 #include <iso15118/detail/variant_access.hpp>
 
 #include <cbv2g/iso_20/iso20_DC_Decoder.h>
@@ -90,6 +94,22 @@ void convert(const struct iso20_dc_BPT_Dynamic_DC_CLReqControlModeType& in,
     CB2CPP_CONVERT_IF_USED(in.EVMinimumV2XEnergyRequest, out.min_v2x_energy_request);
 }
 
+static void convert_control_mode(const struct iso20_dc_DC_ChargeLoopReqType& in,
+                                 DC_ChargeLoopRequestView::ControlMode& out) {
+    if (in.Scheduled_DC_CLReqControlMode_isUsed) {
+        convert(in.Scheduled_DC_CLReqControlMode, out.emplace<datatypes::Scheduled_DC_CLReqControlMode>());
+    } else if (in.BPT_Scheduled_DC_CLReqControlMode_isUsed) {
+        convert(in.BPT_Scheduled_DC_CLReqControlMode, out.emplace<datatypes::BPT_Scheduled_DC_CLReqControlMode>());
+    } else if (in.Dynamic_DC_CLReqControlMode_isUsed) {
+        convert(in.Dynamic_DC_CLReqControlMode, out.emplace<datatypes::Dynamic_DC_CLReqControlMode>());
+    } else if (in.BPT_Dynamic_DC_CLReqControlMode_isUsed) {
+        convert(in.BPT_Dynamic_DC_CLReqControlMode, out.emplace<datatypes::BPT_Dynamic_DC_CLReqControlMode>());
+    } else {
+        // should not happen
+        assert(false);
+    }
+}
+
 template <> void convert(const struct iso20_dc_DC_ChargeLoopReqType& in, DC_ChargeLoopRequest& out) {
     convert(in.Header, out.header);
 
@@ -99,24 +119,73 @@ template <> void convert(const struct iso20_dc_DC_ChargeLoopReqType& in, DC_Char
 
     convert(in.EVPresentVoltage, out.present_voltage);
 
-    if (in.Scheduled_DC_CLReqControlMode_isUsed) {
-        convert(in.Scheduled_DC_CLReqControlMode, out.control_mode.emplace<datatypes::Scheduled_DC_CLReqControlMode>());
-    } else if (in.BPT_Scheduled_DC_CLReqControlMode_isUsed) {
-        convert(in.BPT_Scheduled_DC_CLReqControlMode,
-                out.control_mode.emplace<datatypes::BPT_Scheduled_DC_CLReqControlMode>());
-    } else if (in.Dynamic_DC_CLReqControlMode_isUsed) {
-        convert(in.Dynamic_DC_CLReqControlMode, out.control_mode.emplace<datatypes::Dynamic_DC_CLReqControlMode>());
-    } else if (in.BPT_Dynamic_DC_CLReqControlMode_isUsed) {
-        convert(in.BPT_Dynamic_DC_CLReqControlMode,
-                out.control_mode.emplace<datatypes::BPT_Dynamic_DC_CLReqControlMode>());
-    } else {
-        // should not happen
-        assert(false);
-    }
+    convert_control_mode(in, out.control_mode);
 }
 
 template <> void insert_type(VariantAccess& va, const struct iso20_dc_DC_ChargeLoopReqType& in) {
-    va.insert_type<DC_ChargeLoopRequest>(in);
+    va.insert_view<DC_ChargeLoopRequestView>(in);
+}
+
+static_assert(sizeof(DC_ChargeLoopRequestView::SessionIdBytes) == sizeof(iso20_dc_MessageHeaderType::SessionID.bytes));
+
+const DC_ChargeLoopRequestView::SessionIdBytes& DC_ChargeLoopRequestView::get_session_id() const {
+    return message->Header.SessionID.bytes;
+}
+
+uint64_t DC_ChargeLoopRequestView::get_timestamp() const {
+    return message->Header.TimeStamp;
+}
+
+std::optional<datatypes::DisplayParameters> DC_ChargeLoopRequestView::get_display_parameters() const {
+    std::optional<datatypes::DisplayParameters> display_parameters;
+    CB2CPP_CONVERT_IF_USED(message->DisplayParameters, display_parameters);
+    return display_parameters;
+}
+
+bool DC_ChargeLoopRequestView::get_meter_info_requested() const {
+    return message->MeterInfoRequested;
+}
+
+datatypes::RationalNumber DC_ChargeLoopRequestView::get_present_voltage() const {
+    datatypes::RationalNumber present_voltage;
+    convert(message->EVPresentVoltage, present_voltage);
+    return present_voltage;
+}
+
+template <>
+bool DC_ChargeLoopRequestView::holds_control_mode<datatypes::Scheduled_DC_CLReqControlMode>() const {
+    return message->Scheduled_DC_CLReqControlMode_isUsed;
+}
+
+template <>
+bool DC_ChargeLoopRequestView::holds_control_mode<datatypes::BPT_Scheduled_DC_CLReqControlMode>() const {
+    return message->BPT_Scheduled_DC_CLReqControlMode_isUsed;
+}
+
+template <> bool DC_ChargeLoopRequestView::holds_control_mode<datatypes::Dynamic_DC_CLReqControlMode>() const {
+    return message->Dynamic_DC_CLReqControlMode_isUsed;
+}
+
+template <>
+bool DC_ChargeLoopRequestView::holds_control_mode<datatypes::BPT_Dynamic_DC_CLReqControlMode>() const {
+    return message->BPT_Dynamic_DC_CLReqControlMode_isUsed;
+}
+
+DC_ChargeLoopRequestView::ControlMode DC_ChargeLoopRequestView::get_control_mode() const {
+    ControlMode control_mode;
+    convert_control_mode(*message, control_mode);
+    return control_mode;
+}
+
+// NOTE: the message has no lists, which would need the resource
+template <> void convert(const DC_ChargeLoopRequestView& in, DC_ChargeLoopRequest& out, std::pmr::memory_resource*) {
+    const auto& session_id = in.get_session_id();
+    std::copy(std::begin(session_id), std::end(session_id), out.header.session_id.begin());
+    out.header.timestamp = in.get_timestamp();
+    out.display_parameters = in.get_display_parameters();
+    out.meter_info_requested = in.get_meter_info_requested();
+    out.present_voltage = in.get_present_voltage();
+    out.control_mode = in.get_control_mode();
 }
 
 template <> void convert(const datatypes::DetailedCost& in, struct iso20_dc_DetailedCostType& out) {
@@ -170,7 +239,7 @@ void convert(const datatypes::BPT_Scheduled_DC_CLResControlMode& in,
 
     CPP2CB_CONVERT_IF_USED(in.max_discharge_power, out.EVSEMaximumDischargePower);
     CPP2CB_CONVERT_IF_USED(in.min_discharge_power, out.EVSEMinimumDischargePower);
-    CPP2CB_CONVERT_IF_USED(in.max_discharge_current, out.EVSEMaximumDischargePower);
+    CPP2CB_CONVERT_IF_USED(in.max_discharge_current, out.EVSEMaximumDischargeCurrent);
     CPP2CB_CONVERT_IF_USED(in.min_voltage, out.EVSEMinimumVoltage);
 }
 
@@ -179,7 +248,7 @@ template <typename cb_Type> void convert(const datatypes::Dynamic_DC_CLResContro
 
     convert(in.max_charge_power, out.EVSEMaximumChargePower);
     convert(in.min_charge_power, out.EVSEMinimumChargePower);
-    convert(in.max_charge_current, out.EVSEMaximumChargePower);
+    convert(in.max_charge_current, out.EVSEMaximumChargeCurrent);
     convert(in.max_voltage, out.EVSEMaximumVoltage);
 }
 
@@ -194,6 +263,92 @@ void convert(const datatypes::BPT_Dynamic_DC_CLResControlMode& in,
     convert(in.min_voltage, out.EVSEMinimumVoltage);
 }
 
+template <> void convert(const struct iso20_dc_EVSEStatusType& in, datatypes::EvseStatus& out) {
+    out.notification_max_delay = in.NotificationMaxDelay;
+    cb_convert_enum(in.EVSENotification, out.notification);
+}
+
+template <> void convert(const struct iso20_dc_MeterInfoType& in, datatypes::MeterInfo& out) {
+    out.meter_id = CB2CPP_STRING(in.MeterID);
+    out.charged_energy_reading_wh = in.ChargedEnergyReadingWh;
+
+    CB2CPP_ASSIGN_IF_USED(in.BPT_DischargedEnergyReadingWh, out.bpt_discharged_energy_reading_wh);
+    CB2CPP_ASSIGN_IF_USED(in.CapacitiveEnergyReadingVARh, out.capacitive_energy_reading_varh);
+    CB2CPP_ASSIGN_IF_USED(in.BPT_InductiveEnergyReadingVARh, out.bpt_inductive_energery_reading_varh);
+
+    if (in.MeterSignature_isUsed) {
+        out.meter_signature = std::string_view(reinterpret_cast<const char*>(in.MeterSignature.bytes),
+                                               in.MeterSignature.bytesLen);
+    }
+
+    CB2CPP_ASSIGN_IF_USED(in.MeterStatus, out.meter_status);
+    CB2CPP_ASSIGN_IF_USED(in.MeterTimestamp, out.meter_timestamp);
+}
+
+template <> void convert(const struct iso20_dc_DetailedCostType& in, datatypes::DetailedCost& out) {
+    convert(in.Amount, out.amount);
+    convert(in.CostPerUnit, out.cost_per_unit);
+}
+
+template <> void convert(const struct iso20_dc_ReceiptType& in, datatypes::Receipt& out) {
+    out.time_anchor = in.TimeAnchor;
+    CB2CPP_CONVERT_IF_USED(in.EnergyCosts, out.energy_costs);
+    CB2CPP_CONVERT_IF_USED(in.OccupancyCosts, out.occupany_costs);
+    CB2CPP_CONVERT_IF_USED(in.AdditionalServicesCosts, out.additional_service_costs);
+    CB2CPP_CONVERT_IF_USED(in.OverstayCosts, out.overstay_costs);
+
+    for (std::size_t i = 0; i < in.TaxCosts.arrayLen; ++i) {
+        auto& tax_costs = out.tax_costs.emplace_back();
+        tax_costs.tax_rule_id = in.TaxCosts.array[i].TaxRuleID;
+        convert(in.TaxCosts.array[i].Amount, tax_costs.amount);
+    }
+}
+
+template <typename cb_Type> void convert(const cb_Type& in, datatypes::Scheduled_DC_CLResControlMode& out) {
+    CB2CPP_CONVERT_IF_USED(in.EVSEMaximumChargePower, out.max_charge_power);
+    CB2CPP_CONVERT_IF_USED(in.EVSEMinimumChargePower, out.min_charge_power);
+    CB2CPP_CONVERT_IF_USED(in.EVSEMaximumChargeCurrent, out.max_charge_current);
+    CB2CPP_CONVERT_IF_USED(in.EVSEMaximumVoltage, out.max_voltage);
+}
+
+template <typename cb_Type> void convert(const cb_Type& in, datatypes::Dynamic_CLResControlMode& out) {
+    CB2CPP_ASSIGN_IF_USED(in.DepartureTime, out.departure_time);
+    CB2CPP_ASSIGN_IF_USED(in.MinimumSOC, out.minimum_soc);
+    CB2CPP_ASSIGN_IF_USED(in.TargetSOC, out.target_soc);
+    CB2CPP_ASSIGN_IF_USED(in.AckMaxDelay, out.ack_max_delay);
+}
+
+template <>
+void convert(const struct iso20_dc_BPT_Scheduled_DC_CLResControlModeType& in,
+             datatypes::BPT_Scheduled_DC_CLResControlMode& out) {
+    convert(in, static_cast<datatypes::Scheduled_DC_CLResControlMode&>(out));
+
+    CB2CPP_CONVERT_IF_USED(in.EVSEMaximumDischargePower, out.max_discharge_power);
+    CB2CPP_CONVERT_IF_USED(in.EVSEMinimumDischargePower, out.min_discharge_power);
+    CB2CPP_CONVERT_IF_USED(in.EVSEMaximumDischargeCurrent, out.max_discharge_current);
+    CB2CPP_CONVERT_IF_USED(in.EVSEMinimumVoltage, out.min_voltage);
+}
+
+template <typename cb_Type> void convert(const cb_Type& in, datatypes::Dynamic_DC_CLResControlMode& out) {
+    convert(in, static_cast<datatypes::Dynamic_CLResControlMode&>(out));
+
+    convert(in.EVSEMaximumChargePower, out.max_charge_power);
+    convert(in.EVSEMinimumChargePower, out.min_charge_power);
+    convert(in.EVSEMaximumChargeCurrent, out.max_charge_current);
+    convert(in.EVSEMaximumVoltage, out.max_voltage);
+}
+
+template <>
+void convert(const struct iso20_dc_BPT_Dynamic_DC_CLResControlModeType& in,
+             datatypes::BPT_Dynamic_DC_CLResControlMode& out) {
+    convert(in, static_cast<datatypes::Dynamic_DC_CLResControlMode&>(out));
+
+    convert(in.EVSEMaximumDischargePower, out.max_discharge_power);
+    convert(in.EVSEMinimumDischargePower, out.min_discharge_power);
+    convert(in.EVSEMaximumDischargeCurrent, out.max_discharge_current);
+    convert(in.EVSEMinimumVoltage, out.min_voltage);
+}
+
 struct ControlModeVisitor {
     using ScheduledCM = datatypes::Scheduled_DC_CLResControlMode;
     using BPT_ScheduledCM = datatypes::BPT_Scheduled_DC_CLResControlMode;
@@ -249,13 +404,155 @@ template <> void convert(const DC_ChargeLoopResponse& in, struct iso20_dc_DC_Cha
     std::visit(ControlModeVisitor(out), in.control_mode);
 }
 
-template <> int serialize_to_exi(const DC_ChargeLoopResponse& in, exi_bitstream_t& out) {
-    iso20_dc_exiDocument doc;
-    init_iso20_dc_exiDocument(&doc);
+template <> void convert(const struct iso20_dc_DC_ChargeLoopResType& in, DC_ChargeLoopResponse& out) {
+    convert(in.Header, out.header);
+    cb_convert_enum(in.ResponseCode, out.response_code);
+
+    CB2CPP_CONVERT_IF_USED(in.EVSEStatus, out.status);
+    CB2CPP_CONVERT_IF_USED(in.MeterInfo, out.meter_info);
+    CB2CPP_CONVERT_IF_USED(in.Receipt, out.receipt);
+
+    convert(in.EVSEPresentCurrent, out.present_current);
+    convert(in.EVSEPresentVoltage, out.present_voltage);
+
+    out.power_limit_achieved = in.EVSEPowerLimitAchieved;
+    out.current_limit_achieved = in.EVSECurrentLimitAchieved;
+    out.voltage_limit_achieved = in.EVSEVoltageLimitAchieved;
+
+    if (in.Scheduled_DC_CLResControlMode_isUsed) {
+        convert(in.Scheduled_DC_CLResControlMode, out.control_mode.emplace<datatypes::Scheduled_DC_CLResControlMode>());
+    } else if (in.BPT_Scheduled_DC_CLResControlMode_isUsed) {
+        convert(in.BPT_Scheduled_DC_CLResControlMode,
+                out.control_mode.emplace<datatypes::BPT_Scheduled_DC_CLResControlMode>());
+    } else if (in.Dynamic_DC_CLResControlMode_isUsed) {
+        convert(in.Dynamic_DC_CLResControlMode, out.control_mode.emplace<datatypes::Dynamic_DC_CLResControlMode>());
+    } else if (in.BPT_Dynamic_DC_CLResControlMode_isUsed) {
+        convert(in.BPT_Dynamic_DC_CLResControlMode,
+                out.control_mode.emplace<datatypes::BPT_Dynamic_DC_CLResControlMode>());
+    }
+}
+
+DC_ChargeLoopResponseBuilder::DC_ChargeLoopResponseBuilder(iso20_dc_exiDocument& document_) : document(&document_) {
+    init_iso20_dc_exiDocument(document);
+    CB_SET_USED(document->DC_ChargeLoopRes);
+
+    // zeroed, so that equal messages compare equal for the response template
+    auto& message = document->DC_ChargeLoopRes;
+    std::memset(&message, 0, sizeof(message));
+    init_iso20_dc_DC_ChargeLoopResType(&message);
+
+    present_current({0, 0});
+    present_voltage({0, 0});
+    power_limit_achieved(false);
+    current_limit_achieved(false);
+    voltage_limit_achieved(false);
+    control_mode(datatypes::Scheduled_DC_CLResControlMode());
+}
+
+DC_ChargeLoopResponseBuilder& DC_ChargeLoopResponseBuilder::header(const Header& header) {
+    convert(header, document->DC_ChargeLoopRes.Header);
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder& DC_ChargeLoopResponseBuilder::response_code(datatypes::ResponseCode response_code) {
+    cb_convert_enum(response_code, document->DC_ChargeLoopRes.ResponseCode);
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder& DC_ChargeLoopResponseBuilder::status(const datatypes::EvseStatus& status) {
+    convert(status, document->DC_ChargeLoopRes.EVSEStatus);
+    CB_SET_USED(document->DC_ChargeLoopRes.EVSEStatus);
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder& DC_ChargeLoopResponseBuilder::meter_info(const datatypes::MeterInfo& meter_info) {
+    convert(meter_info, document->DC_ChargeLoopRes.MeterInfo);
+    CB_SET_USED(document->DC_ChargeLoopRes.MeterInfo);
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder& DC_ChargeLoopResponseBuilder::receipt(const datatypes::Receipt& receipt) {
+    convert(receipt, document->DC_ChargeLoopRes.Receipt);
+    CB_SET_USED(document->DC_ChargeLoopRes.Receipt);
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder&
+DC_ChargeLoopResponseBuilder::present_current(const datatypes::RationalNumber& present_current) {
+    convert(present_current, document->DC_ChargeLoopRes.EVSEPresentCurrent);
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder&
+DC_ChargeLoopResponseBuilder::present_voltage(const datatypes::RationalNumber& present_voltage) {
+    convert(present_voltage, document->DC_ChargeLoopRes.EVSEPresentVoltage);
+    return *this;
+}
 
-    CB_SET_USED(doc.DC_ChargeLoopRes);
+DC_ChargeLoopResponseBuilder& DC_ChargeLoopResponseBuilder::power_limit_achieved(bool limit_achieved) {
+    document->DC_ChargeLoopRes.EVSEPowerLimitAchieved = limit_achieved;
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder& DC_ChargeLoopResponseBuilder::current_limit_achieved(bool limit_achieved) {
+    document->DC_ChargeLoopRes.EVSECurrentLimitAchieved = limit_achieved;
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder& DC_ChargeLoopResponseBuilder::voltage_limit_achieved(bool limit_achieved) {
+    document->DC_ChargeLoopRes.EVSEVoltageLimitAchieved = limit_achieved;
+    return *this;
+}
+
+static void clear_control_mode(iso20_dc_DC_ChargeLoopResType& res) {
+    res.Scheduled_DC_CLResControlMode_isUsed = 0;
+    res.BPT_Scheduled_DC_CLResControlMode_isUsed = 0;
+    res.Dynamic_DC_CLResControlMode_isUsed = 0;
+    res.BPT_Dynamic_DC_CLResControlMode_isUsed = 0;
+}
+
+DC_ChargeLoopResponseBuilder&
+DC_ChargeLoopResponseBuilder::control_mode(const datatypes::Scheduled_DC_CLResControlMode& control_mode) {
+    clear_control_mode(document->DC_ChargeLoopRes);
+    ControlModeVisitor(document->DC_ChargeLoopRes)(control_mode);
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder&
+DC_ChargeLoopResponseBuilder::control_mode(const datatypes::BPT_Scheduled_DC_CLResControlMode& control_mode) {
+    clear_control_mode(document->DC_ChargeLoopRes);
+    ControlModeVisitor(document->DC_ChargeLoopRes)(control_mode);
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder&
+DC_ChargeLoopResponseBuilder::control_mode(const datatypes::Dynamic_DC_CLResControlMode& control_mode) {
+    clear_control_mode(document->DC_ChargeLoopRes);
+    ControlModeVisitor(document->DC_ChargeLoopRes)(control_mode);
+    return *this;
+}
+
+DC_ChargeLoopResponseBuilder&
+DC_ChargeLoopResponseBuilder::control_mode(const datatypes::BPT_Dynamic_DC_CLResControlMode& control_mode) {
+    clear_control_mode(document->DC_ChargeLoopRes);
+    ControlModeVisitor(document->DC_ChargeLoopRes)(control_mode);
+    return *this;
+}
 
-    convert(in, doc.DC_ChargeLoopRes);
+DC_ChargeLoopResponseBuilder& DC_ChargeLoopResponseBuilder::set(const DC_ChargeLoopResponse& in) {
+    convert(in, document->DC_ChargeLoopRes);
+    return *this;
+}
+
+DC_ChargeLoopResponse DC_ChargeLoopResponseBuilder::get() const {
+    DC_ChargeLoopResponse res;
+    convert(document->DC_ChargeLoopRes, res);
+    return res;
+}
+
+template <> int serialize_to_exi(const DC_ChargeLoopResponse& in, exi_bitstream_t& out) {
+    iso20_dc_exiDocument doc;
+    DC_ChargeLoopResponseBuilder(doc).set(in);
 
     return encode_iso20_dc_exiDocument(&out, &doc);
 }
@@ -264,4 +561,27 @@ template <> size_t serialize(const DC_ChargeLoopResponse& in, const io::StreamOu
     return serialize_helper(in, out);
 }
 
+template <> int serialize_to_exi(const DC_ChargeLoopResponseBuilder& in, exi_bitstream_t& out) {
+    return encode_iso20_dc_exiDocument(&out, &in.get_document());
+}
+
+template <> size_t serialize(const DC_ChargeLoopResponseBuilder& in, const io::StreamOutputView& out) {
+    return serialize_helper(in, out);
+}
+
+static constexpr std::array<ExiPatchField, 5> DC_CHARGE_LOOP_RES_PATCH_FIELDS = {
+    EXI_PATCH_FIELD(iso20_dc_DC_ChargeLoopResType, Header.TimeStamp, UnsignedInteger),
+    EXI_PATCH_RATIONAL_NUMBER(iso20_dc_DC_ChargeLoopResType, EVSEPresentCurrent),
+    EXI_PATCH_RATIONAL_NUMBER(iso20_dc_DC_ChargeLoopResType, EVSEPresentVoltage),
+};
+
+template <>
+size_t serialize(const DC_ChargeLoopResponseBuilder& in, ResponseTemplates& templates,
+                 const io::StreamOutputView& out) {
+    auto& document = in.get_document();
+    auto& exi_template = templates.get(Type::DC_ChargeLoopRes);
+    return serialize_with_template<encode_iso20_dc_exiDocument>(exi_template, document, document.DC_ChargeLoopRes,
+                                                                DC_CHARGE_LOOP_RES_PATCH_FIELDS, out);
+}
+
 } // namespace iso15118::message_20
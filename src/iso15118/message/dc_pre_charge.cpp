@@ -2,8 +2,10 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/message/dc_pre_charge.hpp>
 
+#include <cstring>
 #include <type_traits>
 
+#include <iso15118/detail/exi_template.hpp>
 #include <iso15118/detail/variant_access.hpp>
 
 #include <cbv2g/iso_20/iso20_DC_Decoder.h>
@@ -20,7 +22,39 @@ template <> void convert(const struct iso20_dc_DC_PreChargeReqType& in, DC_PreCh
 }
 
 template <> void insert_type(VariantAccess& va, const struct iso20_dc_DC_PreChargeReqType& in) {
-    va.insert_type<DC_PreChargeRequest>(in);
+    va.insert_view<DC_PreChargeRequestView>(in);
+}
+
+Header DC_PreChargeRequestView::get_header() const {
+    Header header;
+    convert(message->Header, header);
+    return header;
+}
+
+datatypes::Processing DC_PreChargeRequestView::get_processing() const {
+    datatypes::Processing processing;
+    cb_convert_enum(message->EVProcessing, processing);
+    return processing;
+}
+
+datatypes::RationalNumber DC_PreChargeRequestView::get_present_voltage() const {
+    datatypes::RationalNumber present_voltage;
+    convert(message->EVPresentVoltage, present_voltage);
+    return present_voltage;
+}
+
+datatypes::RationalNumber DC_PreChargeRequestView::get_target_voltage() const {
+    datatypes::RationalNumber target_voltage;
+    convert(message->EVTargetVoltage, target_voltage);
+    return target_voltage;
+}
+
+// NOTE: the message has no lists, which would need the resource
+template <> void convert(const DC_PreChargeRequestView& in, DC_PreChargeRequest& out, std::pmr::memory_resource*) {
+    out.header = in.get_header();
+    out.processing = in.get_processing();
+    out.present_voltage = in.get_present_voltage();
+    out.target_voltage = in.get_target_voltage();
 }
 
 template <> void convert(const DC_PreChargeResponse& in, struct iso20_dc_DC_PreChargeResType& out) {
@@ -46,4 +80,40 @@ template <> size_t serialize(const DC_PreChargeResponse& in, const io::StreamOut
     return serialize_helper(in, out);
 }
 
+DC_PreChargeResponseBuilder::DC_PreChargeResponseBuilder(iso20_dc_exiDocument& document_) : document(&document_) {
+    init_iso20_dc_exiDocument(document);
+    CB_SET_USED(document->DC_PreChargeRes);
+
+    // zeroed, so that equal messages compare equal for the response template
+    std::memset(&document->DC_PreChargeRes, 0, sizeof(document->DC_PreChargeRes));
+    init_iso20_dc_DC_PreChargeResType(&document->DC_PreChargeRes);
+}
+
+DC_PreChargeResponseBuilder& DC_PreChargeResponseBuilder::set(const DC_PreChargeResponse& in) {
+    convert(in, document->DC_PreChargeRes);
+    return *this;
+}
+
+template <> int serialize_to_exi(const DC_PreChargeResponseBuilder& in, exi_bitstream_t& out) {
+    return encode_iso20_dc_exiDocument(&out, &in.get_document());
+}
+
+template <> size_t serialize(const DC_PreChargeResponseBuilder& in, const io::StreamOutputView& out) {
+    return serialize_helper(in, out);
+}
+
+static constexpr std::array<ExiPatchField, 3> DC_PRE_CHARGE_RES_PATCH_FIELDS = {
+    EXI_PATCH_FIELD(iso20_dc_DC_PreChargeResType, Header.TimeStamp, UnsignedInteger),
+    EXI_PATCH_RATIONAL_NUMBER(iso20_dc_DC_PreChargeResType, EVSEPresentVoltage),
+};
+
+template <>
+size_t serialize(const DC_PreChargeResponseBuilder& in, ResponseTemplates& templates,
+                 const io::StreamOutputView& out) {
+    auto& document = in.get_document();
+    auto& exi_template = templates.get(Type::DC_PreChargeRes);
+    return serialize_with_template<encode_iso20_dc_exiDocument>(exi_template, document, document.DC_PreChargeRes,
+                                                                DC_PRE_CHARGE_RES_PATCH_FIELDS, out);
+}
+
 } // namespace iso15118::message_20
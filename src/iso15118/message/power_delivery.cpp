@@ -2,6 +2,7 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/message/power_delivery.hpp>
 
+#include <stdexcept>
 #include <type_traits>
 
 #include <iso15118/detail/variant_access.hpp>
@@ -71,9 +72,71 @@ template <> void convert(const PowerDeliveryResponse& in, iso20_PowerDeliveryRes
 }
 
 template <> void insert_type(VariantAccess& va, const struct iso20_PowerDeliveryReqType& in) {
-    va.insert_type<PowerDeliveryRequest>(in);
+    va.insert_view<PowerDeliveryRequestView>(in);
 };
 
+Header PowerDeliveryRequestView::get_header() const {
+    Header header;
+    convert(message->Header, header);
+    return header;
+}
+
+datatypes::Processing PowerDeliveryRequestView::get_processing() const {
+    datatypes::Processing processing;
+    cb_convert_enum(message->EVProcessing, processing);
+    return processing;
+}
+
+datatypes::Progress PowerDeliveryRequestView::get_charge_progress() const {
+    datatypes::Progress charge_progress;
+    cb_convert_enum(message->ChargeProgress, charge_progress);
+    return charge_progress;
+}
+
+std::optional<datatypes::PowerProfile>
+PowerDeliveryRequestView::get_power_profile(std::pmr::memory_resource* resource) const {
+    if (not message->EVPowerProfile_isUsed) {
+        return std::nullopt;
+    }
+
+    std::optional<datatypes::PowerProfile> power_profile(std::in_place, resource);
+    convert(message->EVPowerProfile, *power_profile);
+    return power_profile;
+}
+
+std::size_t PowerDeliveryRequestView::get_power_profile_entry_count() const {
+    if (not message->EVPowerProfile_isUsed) {
+        return 0;
+    }
+    return message->EVPowerProfile.EVPowerProfileEntries.EVPowerProfileEntry.arrayLen;
+}
+
+datatypes::PowerScheduleEntry PowerDeliveryRequestView::get_power_profile_entry(std::size_t index) const {
+    if (index >= get_power_profile_entry_count()) {
+        throw std::out_of_range("Power profile entry index out of range");
+    }
+
+    datatypes::PowerScheduleEntry entry;
+    convert(message->EVPowerProfile.EVPowerProfileEntries.EVPowerProfileEntry.array[index], entry);
+    return entry;
+}
+
+std::optional<datatypes::ChannelSelection> PowerDeliveryRequestView::get_channel_selection() const {
+    std::optional<datatypes::ChannelSelection> channel_selection;
+    CB2CPP_CONVERT_IF_USED(message->BPT_ChannelSelection, channel_selection);
+    return channel_selection;
+}
+
+template <>
+void convert(const PowerDeliveryRequestView& in, PowerDeliveryRequest& out, std::pmr::memory_resource* resource) {
+    out.header = in.get_header();
+    out.processing = in.get_processing();
+    out.charge_progress = in.get_charge_progress();
+    // NOTE: out is freshly constructed, so the power profile is move constructed and keeps the resource
+    out.power_profile = in.get_power_profile(resource);
+    out.channel_selection = in.get_channel_selection();
+}
+
 template <> int serialize_to_exi(const PowerDeliveryResponse& in, exi_bitstream_t& out) {
     iso20_exiDocument doc;
     init_iso20_exiDocument(&doc);
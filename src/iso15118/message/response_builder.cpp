@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/message/response_builder.hpp>
+
+#include <cbv2g/app_handshake/appHand_Encoder.h>
+#include <cbv2g/iso_20/iso20_AC_Encoder.h>
+#include <cbv2g/iso_20/iso20_CommonMessages_Encoder.h>
+#include <cbv2g/iso_20/iso20_DC_Encoder.h>
+
+namespace iso15118::message_20 {
+
+union ResponseDocuments::Storage {
+    appHand_exiDocument sap;
+    iso20_exiDocument main;
+    iso20_dc_exiDocument dc;
+    iso20_ac_exiDocument ac;
+};
+
+ResponseDocuments::ResponseDocuments() = default;
+
+ResponseDocuments::~ResponseDocuments() = default;
+
+template <> appHand_exiDocument& ResponseDocuments::get() {
+    if (not storage) {
+        storage = std::make_unique<Storage>();
+    }
+    return storage->sap;
+}
+
+template <> iso20_exiDocument& ResponseDocuments::get() {
+    if (not storage) {
+        storage = std::make_unique<Storage>();
+    }
+    return storage->main;
+}
+
+template <> iso20_dc_exiDocument& ResponseDocuments::get() {
+    if (not storage) {
+        storage = std::make_unique<Storage>();
+    }
+    return storage->dc;
+}
+
+template <> iso20_ac_exiDocument& ResponseDocuments::get() {
+    if (not storage) {
+        storage = std::make_unique<Storage>();
+    }
+    return storage->ac;
+}
+
+} // namespace iso15118::message_20
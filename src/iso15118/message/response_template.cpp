@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/message/response_template.hpp>
+
+#include <utility>
+
+#include <iso15118/detail/exi_template.hpp>
+
+namespace iso15118::message_20 {
+
+namespace {
+// responses, which don't depend on the state of the session, apart from their header
+bool is_shareable(Type type) {
+    switch (type) {
+    case Type::SupportedAppProtocolRes:
+    case Type::ServiceDiscoveryRes:
+    case Type::ServiceDetailRes:
+        return true;
+    default:
+        return false;
+    }
+}
+} // namespace
+
+ResponseTemplates::ResponseTemplates() = default;
+
+ResponseTemplates::ResponseTemplates(std::shared_ptr<ResponseTemplates> shared_templates) :
+    shared(std::move(shared_templates)) {
+}
+
+ResponseTemplates::~ResponseTemplates() = default;
+
+ExiTemplate& ResponseTemplates::get(Type type, uint16_t variant) {
+    if (shared and is_shareable(type)) {
+        return shared->get(type, variant);
+    }
+
+    for (auto& entry : templates) {
+        if (entry.type == type and entry.variant == variant) {
+            return *entry.exi_template;
+        }
+    }
+
+    return *templates.emplace_back(Entry{type, variant, std::make_unique<ExiTemplate>()}).exi_template;
+}
+
+} // namespace iso15118::message_20
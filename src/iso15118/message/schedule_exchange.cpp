@@ -65,12 +65,16 @@ template <> void convert(const struct iso20_EVEnergyOfferType& in, datatypes::EV
 }
 
 template <>
-void convert(const struct iso20_Scheduled_SEReqControlModeType& in, datatypes::Scheduled_SEReqControlMode& out) {
+void convert(const struct iso20_Scheduled_SEReqControlModeType& in, datatypes::Scheduled_SEReqControlMode& out,
+             std::pmr::memory_resource* resource) {
     CB2CPP_ASSIGN_IF_USED(in.DepartureTime, out.departure_time);
     CB2CPP_CONVERT_IF_USED(in.EVTargetEnergyRequest, out.target_energy);
     CB2CPP_CONVERT_IF_USED(in.EVMaximumEnergyRequest, out.max_energy);
     CB2CPP_CONVERT_IF_USED(in.EVMinimumEnergyRequest, out.min_energy);
-    CB2CPP_CONVERT_IF_USED(in.EVEnergyOffer, out.energy_offer);
+
+    if (in.EVEnergyOffer_isUsed) {
+        convert(in.EVEnergyOffer, out.energy_offer.emplace(resource));
+    }
 }
 
 template <>
@@ -85,7 +89,9 @@ void convert(const struct iso20_Dynamic_SEReqControlModeType& in, datatypes::Dyn
     CB2CPP_CONVERT_IF_USED(in.EVMinimumV2XEnergyRequest, out.min_v2x_energy);
 }
 
-template <> void convert(const struct iso20_ScheduleExchangeReqType& in, ScheduleExchangeRequest& out) {
+template <>
+void convert(const struct iso20_ScheduleExchangeReqType& in, ScheduleExchangeRequest& out,
+             std::pmr::memory_resource* resource) {
     convert(in.Header, out.header);
 
     out.max_supporting_points = in.MaximumSupportingPoints;
@@ -95,7 +101,7 @@ template <> void convert(const struct iso20_ScheduleExchangeReqType& in, Schedul
         convert(in.Dynamic_SEReqControlMode, mode_out);
     } else if (in.Scheduled_SEReqControlMode_isUsed) {
         auto& mode_out = out.control_mode.emplace<datatypes::Scheduled_SEReqControlMode>();
-        convert(in.Scheduled_SEReqControlMode, mode_out);
+        convert(in.Scheduled_SEReqControlMode, mode_out, resource);
     } else {
         throw std::runtime_error("No control mode selected in iso20_ScheduleExchangeReqType");
     }
@@ -165,6 +171,7 @@ template <> void convert(const datatypes::OverstayRule& in, struct iso20_Oversta
 }
 
 template <> void convert(const datatypes::AbsolutePriceSchedule& in, struct iso20_AbsolutePriceScheduleType& out) {
+    init_iso20_AbsolutePriceScheduleType(&out);
 
     CPP2CB_STRING_IF_USED(in.id, out.Id);
     out.TimeAnchor = in.time_anchor;
@@ -173,7 +180,7 @@ template <> void convert(const datatypes::AbsolutePriceSchedule& in, struct iso2
     CPP2CB_STRING(in.currency, out.Currency);
     CPP2CB_STRING(in.language, out.Language);
     CPP2CB_STRING(in.price_algorithm, out.PriceAlgorithm);
-    CPP2CB_CONVERT_IF_USED(in.minimum_cost, out.MaximumCost);
+    CPP2CB_CONVERT_IF_USED(in.minimum_cost, out.MinimumCost);
     CPP2CB_CONVERT_IF_USED(in.maximum_cost, out.MaximumCost);
 
     if (in.tax_rules.has_value()) {
@@ -346,7 +353,7 @@ template <> void convert(const ScheduleExchangeResponse& in, struct iso20_Schedu
 }
 
 template <> void insert_type(VariantAccess& va, const struct iso20_ScheduleExchangeReqType& in) {
-    va.insert_type<ScheduleExchangeRequest>(in);
+    va.insert_type_with_resource<ScheduleExchangeRequest>(in);
 };
 
 template <> int serialize_to_exi(const ScheduleExchangeResponse& in, exi_bitstream_t& out) {
@@ -2,8 +2,10 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/message/service_detail.hpp>
 
+#include <cstring>
 #include <type_traits>
 
+#include <iso15118/detail/exi_template.hpp>
 #include <iso15118/detail/variant_access.hpp>
 
 #include <cbv2g/iso_20/iso20_CommonMessages_Encoder.h>
@@ -183,7 +185,7 @@ struct ParameterValueVisitor {
         CB_SET_USED(parameter.intValue);
         parameter.intValue = in;
     }
-    void operator()(const std::string& in) {
+    void operator()(const datatypes::Name& in) {
         CB_SET_USED(parameter.finiteString);
         CPP2CB_STRING(in, parameter.finiteString);
     }
@@ -263,4 +265,41 @@ template <> size_t serialize(const ServiceDetailRequest& in, const io::StreamOut
     return serialize_helper(in, out);
 }
 
+ServiceDetailResponseBuilder::ServiceDetailResponseBuilder(iso20_exiDocument& document_) : document(&document_) {
+    init_iso20_exiDocument(document);
+    CB_SET_USED(document->ServiceDetailRes);
+
+    // zeroed, so that equal messages compare equal for the response template
+    std::memset(&document->ServiceDetailRes, 0, sizeof(document->ServiceDetailRes));
+    init_iso20_ServiceDetailResType(&document->ServiceDetailRes);
+}
+
+ServiceDetailResponseBuilder& ServiceDetailResponseBuilder::set(const ServiceDetailResponse& in) {
+    convert(in, document->ServiceDetailRes);
+    return *this;
+}
+
+template <> int serialize_to_exi(const ServiceDetailResponseBuilder& in, exi_bitstream_t& out) {
+    return encode_iso20_exiDocument(&out, &in.get_document());
+}
+
+template <> size_t serialize(const ServiceDetailResponseBuilder& in, const io::StreamOutputView& out) {
+    return serialize_helper(in, out);
+}
+
+// shared by all sessions, so the session id is patched as well
+static constexpr std::array<ExiPatchField, 2> SERVICE_DETAIL_RES_PATCH_FIELDS = {
+    EXI_PATCH_FIELD(iso20_ServiceDetailResType, Header.SessionID.bytes, Bytes),
+    EXI_PATCH_FIELD(iso20_ServiceDetailResType, Header.TimeStamp, UnsignedInteger),
+};
+
+template <>
+size_t serialize(const ServiceDetailResponseBuilder& in, ResponseTemplates& templates,
+                 const io::StreamOutputView& out) {
+    auto& document = in.get_document();
+    auto& exi_template = templates.get(Type::ServiceDetailRes, document.ServiceDetailRes.ServiceID);
+    return serialize_with_template<encode_iso20_exiDocument>(exi_template, document, document.ServiceDetailRes,
+                                                             SERVICE_DETAIL_RES_PATCH_FIELDS, out);
+}
+
 } // namespace iso15118::message_20
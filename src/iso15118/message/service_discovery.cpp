@@ -2,8 +2,10 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/message/service_discovery.hpp>
 
+#include <cstring>
 #include <type_traits>
 
+#include <iso15118/detail/exi_template.hpp>
 #include <iso15118/detail/variant_access.hpp>
 
 #include <cbv2g/iso_20/iso20_CommonMessages_Encoder.h>
@@ -15,7 +17,7 @@ template <> void convert(const struct iso20_ServiceDiscoveryReqType& in, Service
 
     if (in.SupportedServiceIDs_isUsed == true) {
         auto& temp = out.supported_service_ids.emplace();
-        temp.insert(temp.end(), in.SupportedServiceIDs.ServiceID.array,
+        temp.assign(in.SupportedServiceIDs.ServiceID.array,
                     in.SupportedServiceIDs.ServiceID.array + in.SupportedServiceIDs.ServiceID.arrayLen);
     }
 }
@@ -132,4 +134,41 @@ template <> size_t serialize(const ServiceDiscoveryRequest& in, const io::Stream
     return serialize_helper(in, out);
 }
 
+ServiceDiscoveryResponseBuilder::ServiceDiscoveryResponseBuilder(iso20_exiDocument& document_) : document(&document_) {
+    init_iso20_exiDocument(document);
+    CB_SET_USED(document->ServiceDiscoveryRes);
+
+    // zeroed, so that equal messages compare equal for the response template
+    std::memset(&document->ServiceDiscoveryRes, 0, sizeof(document->ServiceDiscoveryRes));
+    init_iso20_ServiceDiscoveryResType(&document->ServiceDiscoveryRes);
+}
+
+ServiceDiscoveryResponseBuilder& ServiceDiscoveryResponseBuilder::set(const ServiceDiscoveryResponse& in) {
+    convert(in, document->ServiceDiscoveryRes);
+    return *this;
+}
+
+template <> int serialize_to_exi(const ServiceDiscoveryResponseBuilder& in, exi_bitstream_t& out) {
+    return encode_iso20_exiDocument(&out, &in.get_document());
+}
+
+template <> size_t serialize(const ServiceDiscoveryResponseBuilder& in, const io::StreamOutputView& out) {
+    return serialize_helper(in, out);
+}
+
+// shared by all sessions, so the session id is patched as well
+static constexpr std::array<ExiPatchField, 2> SERVICE_DISCOVERY_RES_PATCH_FIELDS = {
+    EXI_PATCH_FIELD(iso20_ServiceDiscoveryResType, Header.SessionID.bytes, Bytes),
+    EXI_PATCH_FIELD(iso20_ServiceDiscoveryResType, Header.TimeStamp, UnsignedInteger),
+};
+
+template <>
+size_t serialize(const ServiceDiscoveryResponseBuilder& in, ResponseTemplates& templates,
+                 const io::StreamOutputView& out) {
+    auto& document = in.get_document();
+    auto& exi_template = templates.get(Type::ServiceDiscoveryRes);
+    return serialize_with_template<encode_iso20_exiDocument>(exi_template, document, document.ServiceDiscoveryRes,
+                                                             SERVICE_DISCOVERY_RES_PATCH_FIELDS, out);
+}
+
 } // namespace iso15118::message_20
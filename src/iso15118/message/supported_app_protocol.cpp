@@ -2,9 +2,11 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/message/supported_app_protocol.hpp>
 
+#include <cstring>
 #include <type_traits>
 
 #include <iso15118/detail/cb_exi.hpp>
+#include <iso15118/detail/exi_template.hpp>
 #include <iso15118/detail/variant_access.hpp>
 
 #include <cbv2g/app_handshake/appHand_Encoder.h>
@@ -91,4 +93,40 @@ template <> size_t serialize(const SupportedAppProtocolRequest& in, const io::St
     return serialize_helper(in, out);
 }
 
+SupportedAppProtocolResponseBuilder::SupportedAppProtocolResponseBuilder(appHand_exiDocument& document_) :
+    document(&document_) {
+    init_appHand_exiDocument(document);
+    CB_SET_USED(document->supportedAppProtocolRes);
+
+    // zeroed, so that equal messages compare equal for the response template
+    std::memset(&document->supportedAppProtocolRes, 0, sizeof(document->supportedAppProtocolRes));
+    init_appHand_supportedAppProtocolRes(&document->supportedAppProtocolRes);
+}
+
+SupportedAppProtocolResponseBuilder&
+SupportedAppProtocolResponseBuilder::set(const SupportedAppProtocolResponse& in) {
+    convert(in, document->supportedAppProtocolRes);
+    return *this;
+}
+
+template <> int serialize_to_exi(const SupportedAppProtocolResponseBuilder& in, exi_bitstream_t& out) {
+    return encode_appHand_exiDocument(&out, &in.get_document());
+}
+
+template <> size_t serialize(const SupportedAppProtocolResponseBuilder& in, const io::StreamOutputView& out) {
+    return serialize_helper(in, out);
+}
+
+// without a header, the response only changes with the request
+static constexpr std::array<ExiPatchField, 0> SUPPORTED_APP_PROTOCOL_RES_PATCH_FIELDS{};
+
+template <>
+size_t serialize(const SupportedAppProtocolResponseBuilder& in, ResponseTemplates& templates,
+                 const io::StreamOutputView& out) {
+    auto& document = in.get_document();
+    auto& exi_template = templates.get(Type::SupportedAppProtocolRes);
+    return serialize_with_template<encode_appHand_exiDocument>(exi_template, document, document.supportedAppProtocolRes,
+                                                               SUPPORTED_APP_PROTOCOL_RES_PATCH_FIELDS, out);
+}
+
 } // namespace iso15118::message_20
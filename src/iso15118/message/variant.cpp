@@ -2,8 +2,10 @@
 // Copyright 2023 Pionix GmbH and Contributors to EVerest
 #include <iso15118/message/variant.hpp>
 
+#include <array>
 #include <cassert>
-#include <string>
+#include <memory>
+#include <optional>
 
 #include <iso15118/detail/helper.hpp>
 #include <iso15118/detail/variant_access.hpp>
@@ -17,100 +19,210 @@ using PayloadType = iso15118::io::v2gtp::PayloadType;
 
 namespace iso15118::message_20 {
 
-static void handle_sap(VariantAccess& va) {
-    appHand_exiDocument doc;
+// the cbv2g documents have a member for every message type of their schema, so they are rather large.  They are decoded
+// into storage, which is allocated once per variant, instead of the stack.  The views of the decoded messages point
+// into this storage as well.
+union DocumentScratch {
+    appHand_exiDocument sap;
+    iso20_exiDocument main;
+    iso20_dc_exiDocument dc;
+    iso20_ac_exiDocument ac;
+};
 
-    const auto decode_status = decode_appHand_exiDocument(&va.input_stream, &doc);
+namespace {
 
-    if (decode_status != 0) {
-        va.error = "decode_appHand_exiDocument failed with " + std::to_string(decode_status);
-        return;
-    }
+// every document starts with the exi header (no options, no cookie), followed by the event code of its root element
+constexpr uint8_t EXI_HEADER = 0x80;
 
-    if (doc.supportedAppProtocolReq_isUsed) {
-        insert_type(va, doc.supportedAppProtocolReq);
-    } else {
-        va.error = "chosen message type unhandled";
+std::optional<uint8_t> peek_event_code(const io::StreamInputView& buffer_view, uint8_t event_code_bits) {
+    if (buffer_view.payload_len < 2 or buffer_view.payload[0] != EXI_HEADER) {
+        return std::nullopt;
     }
+
+    return buffer_view.payload[1] >> (8 - event_code_bits);
 }
 
-static void handle_main(VariantAccess& va) {
-    iso20_exiDocument doc;
+template <typename DocType> struct MessageEntry {
+    Type type;
+    uint8_t event_code;
+    bool (*insert)(VariantAccess&, const DocType&);
+};
 
-    const auto decode_status = decode_iso20_exiDocument(&va.input_stream, &doc);
+#define MESSAGE_ENTRY(doc_type, event_code, type, member)                                                              \
+    MessageEntry<doc_type> {                                                                                           \
+        Type::type, event_code, [](VariantAccess& va, const doc_type& doc) {                                         \
+            if (not doc.member##_isUsed) {                                                                             \
+                return false;                                                                                          \
+            }                                                                                                          \
+            insert_type(va, doc.member);                                                                               \
+            return true;                                                                                               \
+        }                                                                                                              \
+    }
 
-    if (decode_status != 0) {
-        va.error = "decode_iso20_exiDocument failed with " + std::to_string(decode_status);
-        return;
+// widest event code of a root element, which can be looked up directly
+constexpr uint8_t MAX_EVENT_CODE_BITS = 6;
+
+template <typename DocType, std::size_t N> struct DocumentGrammar {
+    constexpr DocumentGrammar(PayloadType payload_type_, const char* decoder_name_,
+                              int (*decode_)(exi_bitstream_t*, DocType*), uint8_t event_code_bits_,
+                              std::array<MessageEntry<DocType>, N> messages_) :
+        payload_type(payload_type_),
+        decoder_name(decoder_name_),
+        decode(decode_),
+        event_code_bits(event_code_bits_),
+        messages(messages_),
+        message_by_event_code() {
+        if (event_code_bits > MAX_EVENT_CODE_BITS) {
+            throw std::logic_error("Event codes too wide to be looked up");
+        }
+
+        for (auto& index : message_by_event_code) {
+            index = N;
+        }
+
+        for (std::size_t i = 0; i < N; ++i) {
+            message_by_event_code[messages[i].event_code] = static_cast<uint8_t>(i);
+        }
     }
 
-    if (doc.SessionSetupReq_isUsed) {
-        insert_type(va, doc.SessionSetupReq);
-    } else if (doc.SessionSetupRes_isUsed) {
-        insert_type(va, doc.SessionSetupRes);
-    } else if (doc.AuthorizationSetupReq_isUsed) {
-        insert_type(va, doc.AuthorizationSetupReq);
-    } else if (doc.AuthorizationSetupRes_isUsed) {
-        insert_type(va, doc.AuthorizationSetupRes);
-    } else if (doc.AuthorizationReq_isUsed) {
-        insert_type(va, doc.AuthorizationReq);
-    } else if (doc.AuthorizationRes_isUsed) {
-        insert_type(va, doc.AuthorizationRes);
-    } else if (doc.ServiceDiscoveryReq_isUsed) {
-        insert_type(va, doc.ServiceDiscoveryReq);
-    } else if (doc.ServiceDiscoveryRes_isUsed) {
-        insert_type(va, doc.ServiceDiscoveryRes);
-    } else if (doc.ServiceDetailReq_isUsed) {
-        insert_type(va, doc.ServiceDetailReq);
-    } else if (doc.ServiceDetailRes_isUsed) {
-        insert_type(va, doc.ServiceDetailRes);
-    } else if (doc.ServiceSelectionReq_isUsed) {
-        insert_type(va, doc.ServiceSelectionReq);
-    } else if (doc.ServiceSelectionRes_isUsed) {
-        insert_type(va, doc.ServiceSelectionRes);
-    } else if (doc.ScheduleExchangeReq_isUsed) {
-        insert_type(va, doc.ScheduleExchangeReq);
-    } else if (doc.PowerDeliveryReq_isUsed) {
-        insert_type(va, doc.PowerDeliveryReq);
-    } else if (doc.SessionStopReq_isUsed) {
-        insert_type(va, doc.SessionStopReq);
-    } else {
-        va.error = "chosen message type unhandled";
+    PayloadType payload_type;
+    const char* decoder_name;
+    int (*decode)(exi_bitstream_t*, DocType*);
+    // width of the root element event code
+    uint8_t event_code_bits;
+    std::array<MessageEntry<DocType>, N> messages;
+    // index into the messages, N if the event code is not handled
+    std::array<uint8_t, 1 << MAX_EVENT_CODE_BITS> message_by_event_code;
+};
+
+// event codes of the root elements, as encoded by cbv2g (the global elements of the schema, sorted by name)
+constexpr DocumentGrammar<appHand_exiDocument, 1> SAP_GRAMMAR{
+    PayloadType::SAP,
+    "decode_appHand_exiDocument",
+    decode_appHand_exiDocument,
+    1,
+    {
+        MESSAGE_ENTRY(appHand_exiDocument, 0, SupportedAppProtocolReq, supportedAppProtocolReq),
+    },
+};
+
+constexpr DocumentGrammar<iso20_exiDocument, 15> MAIN_GRAMMAR{
+    PayloadType::Part20Main,
+    "decode_iso20_exiDocument",
+    decode_iso20_exiDocument,
+    6,
+    {
+        MESSAGE_ENTRY(iso20_exiDocument, 0, AuthorizationReq, AuthorizationReq),
+        MESSAGE_ENTRY(iso20_exiDocument, 1, AuthorizationRes, AuthorizationRes),
+        MESSAGE_ENTRY(iso20_exiDocument, 2, AuthorizationSetupReq, AuthorizationSetupReq),
+        MESSAGE_ENTRY(iso20_exiDocument, 3, AuthorizationSetupRes, AuthorizationSetupRes),
+        MESSAGE_ENTRY(iso20_exiDocument, 21, PowerDeliveryReq, PowerDeliveryReq),
+        MESSAGE_ENTRY(iso20_exiDocument, 27, ScheduleExchangeReq, ScheduleExchangeReq),
+        MESSAGE_ENTRY(iso20_exiDocument, 29, ServiceDetailReq, ServiceDetailReq),
+        MESSAGE_ENTRY(iso20_exiDocument, 30, ServiceDetailRes, ServiceDetailRes),
+        MESSAGE_ENTRY(iso20_exiDocument, 31, ServiceDiscoveryReq, ServiceDiscoveryReq),
+        MESSAGE_ENTRY(iso20_exiDocument, 32, ServiceDiscoveryRes, ServiceDiscoveryRes),
+        MESSAGE_ENTRY(iso20_exiDocument, 33, ServiceSelectionReq, ServiceSelectionReq),
+        MESSAGE_ENTRY(iso20_exiDocument, 34, ServiceSelectionRes, ServiceSelectionRes),
+        MESSAGE_ENTRY(iso20_exiDocument, 35, SessionSetupReq, SessionSetupReq),
+        MESSAGE_ENTRY(iso20_exiDocument, 36, SessionSetupRes, SessionSetupRes),
+        MESSAGE_ENTRY(iso20_exiDocument, 37, SessionStopReq, SessionStopReq),
+    },
+};
+
+constexpr DocumentGrammar<iso20_dc_exiDocument, 5> DC_GRAMMAR{
+    PayloadType::Part20DC,
+    "decode_iso20_dc_exiDocument",
+    decode_iso20_dc_exiDocument,
+    6,
+    {
+        MESSAGE_ENTRY(iso20_dc_exiDocument, 11, DC_CableCheckReq, DC_CableCheckReq),
+        MESSAGE_ENTRY(iso20_dc_exiDocument, 13, DC_ChargeLoopReq, DC_ChargeLoopReq),
+        MESSAGE_ENTRY(iso20_dc_exiDocument, 15, DC_ChargeParameterDiscoveryReq, DC_ChargeParameterDiscoveryReq),
+        MESSAGE_ENTRY(iso20_dc_exiDocument, 17, DC_PreChargeReq, DC_PreChargeReq),
+        MESSAGE_ENTRY(iso20_dc_exiDocument, 19, DC_WeldingDetectionReq, DC_WeldingDetectionReq),
+    },
+};
+
+#undef MESSAGE_ENTRY
+
+// the payload type of every message type (0 if there is none), taken from the message registry
+template <typename... Exchanges> constexpr auto make_payload_types(detail::TypeList<Exchanges...>) {
+    std::array<uint16_t, TYPE_COUNT> payload_types{};
+    ((payload_types[static_cast<std::size_t>(Exchanges::request_type)] =
+          static_cast<uint16_t>(Exchanges::payload_type)),
+     ...);
+    ((payload_types[static_cast<std::size_t>(Exchanges::response_type)] =
+          static_cast<uint16_t>(Exchanges::payload_type)),
+     ...);
+    return payload_types;
+}
+
+constexpr auto PAYLOAD_TYPES = make_payload_types(MessageExchanges{});
+
+template <typename DocType, std::size_t N> constexpr bool matches_registry(const DocumentGrammar<DocType, N>& grammar) {
+    for (const auto& message : grammar.messages) {
+        if (PAYLOAD_TYPES[static_cast<std::size_t>(message.type)] != static_cast<uint16_t>(grammar.payload_type)) {
+            return false;
+        }
     }
+    return true;
 }
 
-static void handle_dc(VariantAccess& va) {
-    iso20_dc_exiDocument doc;
+static_assert(matches_registry(SAP_GRAMMAR), "SAP grammar doesn't match the message registry");
+static_assert(matches_registry(MAIN_GRAMMAR), "Main grammar doesn't match the message registry");
+static_assert(matches_registry(DC_GRAMMAR), "DC grammar doesn't match the message registry");
 
-    const auto decode_status = decode_iso20_dc_exiDocument(&va.input_stream, &doc);
+template <typename DocType, std::size_t N>
+const MessageEntry<DocType>* find_message(const DocumentGrammar<DocType, N>& grammar,
+                                          const io::StreamInputView& buffer_view) {
+    const auto event_code = peek_event_code(buffer_view, grammar.event_code_bits);
+    if (not event_code) {
+        return nullptr;
+    }
+
+    const auto index = grammar.message_by_event_code[*event_code];
+    return (index < N) ? &grammar.messages[index] : nullptr;
+}
+
+template <typename DocType, std::size_t N>
+void handle_document(VariantAccess& va, const io::StreamInputView& buffer_view,
+                     const DocumentGrammar<DocType, N>& grammar, DocType& doc) {
+    const auto expected_message = find_message(grammar, buffer_view);
+
+    if (expected_message == nullptr and peek_event_code(buffer_view, grammar.event_code_bits).has_value()) {
+        // no need to decode a message, which won't be handled anyway
+        va.set_error("chosen message type unhandled");
+        return;
+    }
+
+    const auto decode_status = grammar.decode(&va.input_stream, &doc);
 
     if (decode_status != 0) {
-        va.error = "decode_iso20_dc_exiDocument failed with " + std::to_string(decode_status);
+        va.set_error(grammar.decoder_name, decode_status);
         return;
     }
 
-    if (doc.DC_ChargeParameterDiscoveryReq_isUsed) {
-        insert_type(va, doc.DC_ChargeParameterDiscoveryReq);
-    } else if (doc.DC_CableCheckReq_isUsed) {
-        insert_type(va, doc.DC_CableCheckReq);
-    } else if (doc.DC_PreChargeReq_isUsed) {
-        insert_type(va, doc.DC_PreChargeReq);
-    } else if (doc.DC_ChargeLoopReq_isUsed) {
-        insert_type(va, doc.DC_ChargeLoopReq);
-    } else if (doc.DC_WeldingDetectionReq_isUsed) {
-        insert_type(va, doc.DC_WeldingDetectionReq);
-    } else {
-        va.error = "chosen message type unhandled";
+    if (expected_message != nullptr and expected_message->insert(va, doc)) {
+        return;
     }
-}
 
-static void handle_ac(VariantAccess& va) {
-    iso20_ac_exiDocument doc;
+    // event code not matching, fall back to the document flags
+    for (const auto& message : grammar.messages) {
+        if (message.insert(va, doc)) {
+            return;
+        }
+    }
+
+    va.set_error("chosen message type unhandled");
+}
 
+// the event codes of the AC schema are not derived, so its messages are told by the document flags after decoding
+void handle_ac_document(VariantAccess& va, iso20_ac_exiDocument& doc) {
     const auto decode_status = decode_iso20_ac_exiDocument(&va.input_stream, &doc);
 
     if (decode_status != 0) {
-        va.error = "decode_iso20_dc_exiDocument failed with " + std::to_string(decode_status);
+        va.set_error("decode_iso20_ac_exiDocument", decode_status);
         return;
     }
 
@@ -119,49 +231,83 @@ static void handle_ac(VariantAccess& va) {
     } else if (doc.AC_ChargeLoopReq_isUsed) {
         insert_type(va, doc.AC_ChargeLoopReq);
     } else {
-        va.error = "chosen message type unhandled";
+        va.set_error("chosen message type unhandled");
+    }
+}
+
+} // namespace
+
+Type peek_type(io::v2gtp::PayloadType payload_type, const io::StreamInputView& buffer_view) {
+    const auto get_type = [](const auto* message) { return (message != nullptr) ? message->type : Type::None; };
+
+    if (payload_type == PayloadType::SAP) {
+        return get_type(find_message(SAP_GRAMMAR, buffer_view));
+    } else if (payload_type == PayloadType::Part20Main) {
+        return get_type(find_message(MAIN_GRAMMAR, buffer_view));
+    } else if (payload_type == PayloadType::Part20DC) {
+        return get_type(find_message(DC_GRAMMAR, buffer_view));
     }
+
+    // AC messages can only be told by decoding them
+    return Type::None;
+}
+
+Variant::Variant() = default;
+
+Variant::Variant(std::pmr::memory_resource* resource_) : resource(resource_) {
 }
 
 Variant::Variant(io::v2gtp::PayloadType payload_type, const io::StreamInputView& buffer_view) {
+    decode(payload_type, buffer_view);
+}
+
+Variant::~Variant() = default;
+
+void Variant::decode(io::v2gtp::PayloadType payload_type, const io::StreamInputView& buffer_view) {
+    reset();
 
     VariantAccess va{
-        get_exi_input_stream(buffer_view), this->data, this->type, this->custom_deleter, this->error,
+        get_exi_input_stream(buffer_view),
+        this->storage,
+        this->type,
+        this->error,
+        this->resource,
     };
 
+    if (not scratch) {
+        scratch = std::make_unique<DocumentScratch>();
+    }
+
     if (payload_type == PayloadType::SAP) {
-        handle_sap(va);
+        handle_document(va, buffer_view, SAP_GRAMMAR, scratch->sap);
     } else if (payload_type == PayloadType::Part20Main) {
-        handle_main(va);
+        handle_document(va, buffer_view, MAIN_GRAMMAR, scratch->main);
     } else if (payload_type == PayloadType::Part20DC) {
-        handle_dc(va);
+        handle_document(va, buffer_view, DC_GRAMMAR, scratch->dc);
     } else if (payload_type == PayloadType::Part20AC) {
-        handle_ac(va);
+        handle_ac_document(va, scratch->ac);
     } else {
         logf_warning("Unknown type");
     }
 
-    if (data) {
-        // in case data was set, make sure the custom deleter and the type were set!
-        assert(custom_deleter != nullptr);
-        assert(type != Type::None);
-    } else {
-        logf_error("Failed due to: %s\n", error.c_str());
+    if (type == Type::None) {
+        logf_error("Failed due to: %s\n", error.data());
     }
 }
 
-Variant::~Variant() {
-    if (data) {
-        custom_deleter(data);
-    }
+void Variant::reset() {
+    storage.emplace<std::monostate>();
+    converted.emplace<std::monostate>();
+    type = Type::None;
+    error[0] = '\0';
 }
 
 Type Variant::get_type() const {
     return type;
 }
 
-const std::string& Variant::get_error() const {
-    return error;
+const char* Variant::get_error() const {
+    return error.data();
 }
 
 } // namespace iso15118::message_20
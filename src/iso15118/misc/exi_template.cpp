@@ -0,0 +1,320 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <iso15118/detail/exi_template.hpp>
+
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace iso15118::message_20 {
+
+namespace {
+
+// encoded bits of a value, the first one to be written is the most significant one
+struct ExiBits {
+    uint64_t value;
+    uint8_t count;
+};
+
+std::optional<ExiBits> encode_unsigned(uint64_t value) {
+    ExiBits bits{0, 0};
+    do {
+        if (bits.count == 64) {
+            // too long to be patched
+            return std::nullopt;
+        }
+
+        auto group = static_cast<uint8_t>(value & 0x7f);
+        value >>= 7;
+        if (value != 0) {
+            group |= 0x80;
+        }
+
+        bits.value = (bits.value << 8) | group;
+        bits.count += 8;
+    } while (value != 0);
+
+    return bits;
+}
+
+std::optional<ExiBits> encode_field(const ExiPatchField& field, int64_t value) {
+    switch (field.encoding) {
+    case ExiPatchEncoding::UnsignedInteger:
+        return encode_unsigned(static_cast<uint64_t>(value));
+    case ExiPatchEncoding::Integer: {
+        const auto negative = value < 0;
+        auto bits = encode_unsigned(negative ? static_cast<uint64_t>(-(value + 1)) : static_cast<uint64_t>(value));
+        if (not bits or bits->count == 64) {
+            return std::nullopt;
+        }
+        bits->value |= static_cast<uint64_t>(negative) << bits->count;
+        bits->count += 1;
+        return bits;
+    }
+    case ExiPatchEncoding::Byte:
+        return ExiBits{static_cast<uint64_t>(value + 128) & 0xff, 8};
+    case ExiPatchEncoding::Bytes:
+        if (field.size > sizeof(uint64_t)) {
+            return std::nullopt;
+        }
+        return ExiBits{static_cast<uint64_t>(value), static_cast<uint8_t>(field.size * 8)};
+    }
+
+    return std::nullopt;
+}
+
+// a different value with an encoding of the same length, only the least significant bit of the encoded value differs
+int64_t get_probe_value(const ExiPatchField& field, int64_t value) {
+    switch (field.encoding) {
+    case ExiPatchEncoding::UnsignedInteger:
+    case ExiPatchEncoding::Bytes:
+        return static_cast<int64_t>(static_cast<uint64_t>(value) ^ 1);
+    case ExiPatchEncoding::Integer:
+        return (value >= 0) ? (value ^ 1) : -((-(value + 1) ^ 1) + 1);
+    case ExiPatchEncoding::Byte:
+        return ((value + 128) ^ 1) - 128;
+    }
+
+    return value;
+}
+
+template <typename T> int64_t read_as(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return static_cast<int64_t>(value);
+}
+
+template <typename T> void write_as(uint8_t* data, int64_t value) {
+    const auto typed_value = static_cast<T>(value);
+    std::memcpy(data, &typed_value, sizeof(typed_value));
+}
+
+int64_t read_value(const uint8_t* message, const ExiPatchField& field) {
+    const auto data = message + field.offset;
+
+    if (field.encoding == ExiPatchEncoding::Bytes) {
+        // in the order they are encoded
+        uint64_t value = 0;
+        for (std::size_t i = 0; i < field.size; ++i) {
+            value = (value << 8) | data[i];
+        }
+        return static_cast<int64_t>(value);
+    }
+
+    const auto is_unsigned = field.encoding == ExiPatchEncoding::UnsignedInteger;
+
+    switch (field.size) {
+    case 1:
+        return is_unsigned ? read_as<uint8_t>(data) : read_as<int8_t>(data);
+    case 2:
+        return is_unsigned ? read_as<uint16_t>(data) : read_as<int16_t>(data);
+    case 4:
+        return is_unsigned ? read_as<uint32_t>(data) : read_as<int32_t>(data);
+    default:
+        return is_unsigned ? read_as<uint64_t>(data) : read_as<int64_t>(data);
+    }
+}
+
+void write_value(uint8_t* message, const ExiPatchField& field, int64_t value) {
+    const auto data = message + field.offset;
+
+    if (field.encoding == ExiPatchEncoding::Bytes) {
+        for (std::size_t i = field.size; i > 0; --i) {
+            data[i - 1] = static_cast<uint8_t>(value);
+            value = static_cast<int64_t>(static_cast<uint64_t>(value) >> 8);
+        }
+        return;
+    }
+
+    switch (field.size) {
+    case 1:
+        write_as<uint8_t>(data, value);
+        break;
+    case 2:
+        write_as<uint16_t>(data, value);
+        break;
+    case 4:
+        write_as<uint32_t>(data, value);
+        break;
+    default:
+        write_as<uint64_t>(data, value);
+        break;
+    }
+}
+
+uint64_t read_bits(const uint8_t* data, std::size_t offset, uint8_t count) {
+    uint64_t value = 0;
+    for (std::size_t i = offset; i < offset + count; ++i) {
+        value = (value << 1) | ((data[i / 8] >> (7 - i % 8)) & 1);
+    }
+    return value;
+}
+
+void write_bits(uint8_t* data, std::size_t offset, const ExiBits& bits) {
+    for (uint8_t i = 0; i < bits.count; ++i) {
+        const auto position = offset + i;
+        const auto mask = static_cast<uint8_t>(0x80 >> (position % 8));
+        if ((bits.value >> (bits.count - 1 - i)) & 1) {
+            data[position / 8] |= mask;
+        } else {
+            data[position / 8] &= ~mask;
+        }
+    }
+}
+
+std::optional<std::size_t> find_first_different_bit(const uint8_t* a, const uint8_t* b, std::size_t length) {
+    for (std::size_t i = 0; i < length; ++i) {
+        const auto different = static_cast<uint8_t>(a[i] ^ b[i]);
+        if (different == 0) {
+            continue;
+        }
+
+        auto bit = std::size_t{0};
+        while (((different << bit) & 0x80) == 0) {
+            ++bit;
+        }
+        return i * 8 + bit;
+    }
+
+    return std::nullopt;
+}
+
+int encode_document(void* document, ExiTemplate::EncodeFunction encode, const io::StreamOutputView& out,
+                    size_t& size) {
+    auto stream = get_exi_output_stream(out);
+    const auto error = encode(&stream, document);
+    size = exi_bitstream_get_length(&stream);
+    return error;
+}
+
+} // namespace
+
+size_t ExiTemplate::serialize(void* document, void* message_, std::size_t message_size, const ExiPatchField* fields,
+                              std::size_t field_count, EncodeFunction encode, const io::StreamOutputView& out) {
+    const auto message = static_cast<uint8_t*>(message_);
+
+    scratch.assign(message, message + message_size);
+    for (std::size_t i = 0; i < field_count; ++i) {
+        write_value(scratch.data(), fields[i], 0);
+    }
+
+    // values of a different encoding length move the bits of the following fields, so they need new bit positions
+    for (std::size_t i = 0; i < field_count; ++i) {
+        const auto bits = encode_field(fields[i], read_value(message, fields[i]));
+        scratch.push_back(bits ? bits->count : 0);
+    }
+
+    if (scratch == key) {
+        if (patchable) {
+            if (const auto size = patch(message, fields, field_count, out); size != 0) {
+                ++patch_count;
+                return size;
+            }
+        }
+
+        // probing again would give the same result
+        return encode_plain(document, encode, out);
+    }
+
+    key.swap(scratch);
+
+    return record(document, message, fields, field_count, encode, out);
+}
+
+size_t ExiTemplate::patch(const uint8_t* message, const ExiPatchField* fields, std::size_t field_count,
+                          const io::StreamOutputView& out) {
+    if (encoded.size() > out.payload_len) {
+        return 0;
+    }
+
+    std::memcpy(out.payload, encoded.data(), encoded.size());
+
+    for (std::size_t i = 0; i < field_count; ++i) {
+        const auto bits = encode_field(fields[i], read_value(message, fields[i]));
+        if (not bits or bits->count != slots[i].bit_count) {
+            // doesn't fit, the output gets overwritten by the plain encode
+            return 0;
+        }
+
+        write_bits(out.payload, slots[i].bit_offset, *bits);
+    }
+
+    return encoded.size();
+}
+
+size_t ExiTemplate::record(void* document, uint8_t* message, const ExiPatchField* fields, std::size_t field_count,
+                           EncodeFunction encode, const io::StreamOutputView& out) {
+    patchable = false;
+    slots.clear();
+
+    const auto size = encode_plain(document, encode, out);
+
+    encoded.assign(out.payload, out.payload + size);
+
+    probe.resize(out.payload_len);
+    const io::StreamOutputView probe_view{probe.data(), probe.size()};
+
+    for (std::size_t i = 0; i < field_count; ++i) {
+        const auto& field = fields[i];
+
+        const auto value = read_value(message, field);
+        const auto probe_value = get_probe_value(field, value);
+
+        const auto bits = encode_field(field, value);
+        const auto probe_bits = encode_field(field, probe_value);
+        if (not bits or not probe_bits or bits->count != probe_bits->count) {
+            return size;
+        }
+
+        write_value(message, field, probe_value);
+        ++encode_count;
+        size_t probe_size{0};
+        const auto error = encode_document(document, encode, probe_view, probe_size);
+        write_value(message, field, value);
+
+        if (error != 0 or probe_size != size) {
+            return size;
+        }
+
+        const auto different_bit = find_first_different_bit(encoded.data(), probe.data(), size);
+        if (not different_bit) {
+            return size;
+        }
+
+        // position of the differing bit within the encoded field
+        auto different_bits = bits->value ^ probe_bits->value;
+        auto position_in_field = std::size_t{bits->count - 1u};
+        while (different_bits >>= 1) {
+            --position_in_field;
+        }
+
+        if (*different_bit < position_in_field) {
+            return size;
+        }
+
+        // make sure the encoding is really the one expected at this position
+        const auto bit_offset = *different_bit - position_in_field;
+        if (bit_offset + bits->count > size * 8 or read_bits(encoded.data(), bit_offset, bits->count) != bits->value) {
+            return size;
+        }
+
+        slots.push_back({bit_offset, bits->count});
+    }
+
+    patchable = true;
+    return size;
+}
+
+size_t ExiTemplate::encode_plain(void* document, EncodeFunction encode, const io::StreamOutputView& out) {
+    ++encode_count;
+
+    size_t size{0};
+    if (const auto error = encode_document(document, encode, out, size); error != 0) {
+        throw std::runtime_error("Could not encode exi: " + std::to_string(error));
+    }
+
+    return size;
+}
+
+} // namespace iso15118::message_20
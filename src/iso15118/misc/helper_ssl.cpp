@@ -7,6 +7,8 @@
 
 #include <openssl/err.h>
 
+#include <iso15118/detail/helper.hpp>
+
 namespace iso15118::io {
 
 static int add_error_str(const char* str, std::size_t len, void* u) {
@@ -26,4 +28,10 @@ void log_and_raise_openssl_error(const std::string& error_msg) {
     log_and_raise(error_message);
 }
 
+void log_openssl_error(const std::string& error_msg) {
+    std::string error_message = {error_msg};
+    ERR_print_errors_cb(&add_error_str, &error_message);
+    logf_warning("%s", error_message.c_str());
+}
+
 } // namespace iso15118::io
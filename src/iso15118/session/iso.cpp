@@ -3,9 +3,7 @@
 #include <iso15118/session/iso.hpp>
 
 #include <cassert>
-#include <chrono>
 #include <cstring>
-#include <thread>
 
 #include <endian.h>
 
@@ -15,7 +13,28 @@
 
 namespace iso15118 {
 
-static constexpr auto SESSION_IDLE_TIMEOUT_MS = 5000;
+// time for the EV to set up the session, after its connection has been accepted
+// (V2G_SECC_CommunicationSetup_Performance_Time)
+static constexpr auto SESSION_IDLE_TIMEOUT_MS = 20000;
+
+// max. time between sending a response and receiving the next request (V2G_SECC_Sequence_Timeout)
+static constexpr auto SEQUENCE_TIMEOUT_MS = 60000;
+
+// max. time between receiving a request and sending its response (V2G_SECC_Msg_Performance_Time)
+static constexpr auto MSG_PERFORMANCE_TIME_MS = 2000;
+
+static const char* timeout_to_string(d20::Event event) {
+    switch (event) {
+    case d20::Event::SEQUENCE_TIMEOUT:
+        return "sequence timeout";
+    case d20::Event::PERFORMANCE_TIMEOUT:
+        return "message performance timeout";
+    case d20::Event::IDLE_TIMEOUT:
+        return "session idle timeout";
+    default:
+        return "unknown timeout";
+    }
+}
 
 static void log_sdp_packet(const iso15118::io::SdpPacket& sdp) {
     static constexpr auto ESCAPED_BYTE_CHAR_COUNT = 4;
@@ -29,80 +48,9 @@ static void log_sdp_packet(const iso15118::io::SdpPacket& sdp) {
                         payload_string_buffer.get());
 }
 
-static void log_packet_from_car(const iso15118::io::SdpPacket& packet, session::SessionLogger& logger) {
-    logger.exi(static_cast<uint16_t>(packet.get_payload_type()), packet.get_payload_buffer(),
-               packet.get_payload_length(), session::logging::ExiMessageDirection::FROM_EV);
-}
-
-static std::unique_ptr<message_20::Variant> make_variant_from_packet(const iso15118::io::SdpPacket& packet) {
-    return std::make_unique<message_20::Variant>(
-        packet.get_payload_type(), io::StreamInputView{packet.get_payload_buffer(), packet.get_payload_length()});
-}
-
-void raise_invalid_packet_state(const io::SdpPacket& sdp_packet) {
-    using PacketState = io::SdpPacket::State;
-
-    auto error = std::string("Error while reading sdp packet: ");
-    switch (sdp_packet.get_state()) {
-    case PacketState::INVALID_HEADER:
-        error += "invalid sdp packet header";
-        break;
-    case PacketState::PAYLOAD_TO_LONG:
-        error += "packet too large for buffer";
-        break;
-    default:
-        assert(false);
-    }
-
-    log_and_throw(error.c_str());
-}
-
-// NOTE (aw): this function return true, if it would block to read a complete packet
-//            if it returns false, the packet is complete
-bool read_single_sdp_packet(io::IConnection& connection, io::SdpPacket& sdp_packet) {
-    // NOTE (aw): not happy with this function
-    //            main problem is, that it combines too much logic of the sdp packet and io related stuff
-    using PacketState = io::SdpPacket::State;
-
-    assert(sdp_packet.get_state() == PacketState::EMPTY || sdp_packet.get_state() == PacketState::HEADER_READ);
-
-    const auto first_try =
-        connection.read(sdp_packet.get_current_buffer_pos(), sdp_packet.get_remaining_bytes_to_read());
-
-    sdp_packet.update_read_bytes(first_try.bytes_read);
-
-    if (first_try.would_block) {
-        // need more data for at least the header
-        return true;
-    }
-
-    if (sdp_packet.get_state() == PacketState::COMPLETE) {
-        // done
-        return false;
-    }
-
-    // packet not finished
-    if (sdp_packet.get_state() != PacketState::HEADER_READ) {
-        raise_invalid_packet_state(sdp_packet);
-    }
-
-    // header read successfully, try to read the rest
-    const auto second_try =
-        connection.read(sdp_packet.get_current_buffer_pos(), sdp_packet.get_remaining_bytes_to_read());
-
-    sdp_packet.update_read_bytes(second_try.bytes_read);
-
-    if (second_try.would_block) {
-        // need more data for the rest of the packet!
-        return true;
-    }
-
-    // assert finished packet
-    if (sdp_packet.get_state() != PacketState::COMPLETE) {
-        raise_invalid_packet_state(sdp_packet);
-    }
-
-    return false;
+static void log_frame_from_car(const iso15118::io::V2gtpFrame& frame, session::SessionLogger& logger) {
+    logger.exi(static_cast<uint16_t>(frame.payload_type), frame.payload, frame.payload_length,
+               session::logging::ExiMessageDirection::FROM_EV);
 }
 
 static size_t setup_response_header(uint8_t* buffer, iso15118::io::v2gtp::PayloadType payload_type, size_t size) {
@@ -121,37 +69,105 @@ static size_t setup_response_header(uint8_t* buffer, iso15118::io::v2gtp::Payloa
     return size + iso15118::io::SdpPacket::V2GTP_HEADER_SIZE;
 }
 
-Session::Session(std::unique_ptr<io::IConnection> connection_, d20::SessionConfig session_config,
-                 const session::feedback::Callbacks& callbacks) :
+Session::Session(io::PollManager& poll_manager_, std::unique_ptr<io::IConnection> connection_,
+                 d20::SessionConfig session_config, const session::feedback::Callbacks& callbacks,
+                 std::shared_ptr<message_20::ResponseTemplates> shared_templates) :
+    poll_manager(poll_manager_),
     connection(std::move(connection_)),
     log(this),
+    message_exchange({response_buffer + io::SdpPacket::V2GTP_HEADER_SIZE,
+                      sizeof(response_buffer) - io::SdpPacket::V2GTP_HEADER_SIZE},
+                     std::move(shared_templates)),
     ctx(callbacks, log, std::move(session_config), active_control_event, message_exchange),
     fsm(ctx.create_state<d20::state::SupportedAppProtocol>()) {
 
-    next_session_event = offset_time_point_by_ms(get_current_time_point(), SESSION_IDLE_TIMEOUT_MS);
+    next_session_event = TimePoint::max();
     connection->set_event_callback([this](io::ConnectionEvent event) { this->handle_connection_event(event); });
+
+    // NOTE: the idle timer is armed on accepting the connection, a session waiting for the EV doesn't time out
 }
 
-Session::~Session() = default;
+Session::~Session() {
+    stop_timer(timers.idle);
+    stop_timer(timers.sequence);
+    stop_timer(timers.performance);
+}
 
 void Session::push_control_event(const d20::ControlEvent& event) {
     control_event_queue.push(event);
 }
 
+void Session::start_timer(std::optional<io::TimerId>& timer, int32_t timeout_ms, d20::Event event) {
+    stop_timer(timer);
+
+    timer = poll_manager.add_timer(timeout_ms, [this, &timer, event]() {
+        timer.reset();
+        state.timeout = event;
+    });
+}
+
+void Session::stop_timer(std::optional<io::TimerId>& timer) {
+    if (timer) {
+        poll_manager.cancel_timer(*timer);
+        timer.reset();
+    }
+}
+
+void Session::handle_timeout(d20::Event event) {
+    log("Stopping session due to %s", timeout_to_string(event));
+
+    // give the current state the chance to react on the timeout
+    [[maybe_unused]] const auto res = fsm.feed(event);
+
+    if (ctx.session_stopped) {
+        return;
+    }
+
+    ctx.session_stopped = true;
+
+    stop_timer(timers.idle);
+    stop_timer(timers.sequence);
+    stop_timer(timers.performance);
+
+    if (state.connected) {
+        close_connection(session::feedback::Signal::DLINK_ERROR);
+    }
+}
+
+void Session::close_connection(session::feedback::Signal signal) {
+    if (state.close_signal) {
+        // already closing
+        return;
+    }
+
+    // the signal is sent, as soon as the connection is closed
+    state.close_signal = signal;
+    connection->close();
+}
+
 TimePoint const& Session::poll() {
     const auto now = get_current_time_point();
 
-    if (not state.connected) {
-        // nothing happened so far, just return
-        next_session_event = offset_time_point_by_ms(now, SESSION_IDLE_TIMEOUT_MS);
+    next_session_event = TimePoint::max();
+
+    if (state.timeout) {
+        const auto timeout = *state.timeout;
+        state.timeout.reset();
+
+        handle_timeout(timeout);
+        return next_session_event;
+    }
+
+    if (not state.connected or state.close_signal) {
+        // nothing happened so far or the connection is about to be closed, just return
         return next_session_event;
     }
 
-    // check for new data to read
+    // check for new data to read, a single read might contain several frames
     if (state.new_data) {
-        const bool would_block = read_single_sdp_packet(*connection, packet);
+        const auto read_result = framer.read(*connection);
 
-        if (would_block) {
+        if (read_result.would_block) {
             state.new_data = false;
         }
     }
@@ -168,45 +184,75 @@ TimePoint const& Session::poll() {
         // FIXME (aw): check result!
     }
 
-    // check for complete sdp packet
-    if (packet.is_complete()) {
-        // FIXME (aw): this event loop only acts on new packets, seems to be enough for now ...
-        log_packet_from_car(packet, log);
+    send_pending_response();
 
-        message_exchange.set_request(make_variant_from_packet(packet));
+    // handle all complete frames in order
+    while (state.connected and not state.close_signal) {
+        const auto frame = framer.next_frame();
+        if (not frame) {
+            break;
+        }
 
-        packet = {}; // reset the packet
+        log_frame_from_car(*frame, log);
+
+        message_exchange.set_request(frame->payload_type, io::StreamInputView{frame->payload, frame->payload_length});
+
+        stop_timer(timers.sequence);
+        start_timer(timers.performance, MSG_PERFORMANCE_TIME_MS, d20::Event::PERFORMANCE_TIMEOUT);
 
         const auto request_msg_type = ctx.peek_request_type();
         ctx.feedback.v2g_message(request_msg_type);
 
         [[maybe_unused]] const auto res = fsm.feed(d20::Event::V2GTP_MESSAGE);
         // FIXME(sl): check result!
+
+        if (timers.idle and fsm.get_current_state_id() != d20::StateID::SupportedAppProtocol and
+            fsm.get_current_state_id() != d20::StateID::SessionSetup) {
+            // the session has been set up
+            stop_timer(timers.idle);
+        }
+
+        send_pending_response();
     }
 
-    const auto [got_response, payload_size, payload_type, response_type] = message_exchange.check_and_clear_response();
+    if (state.new_data) {
+        // there might be more data to read, which is not signalled by the connection again (e.g. buffered by ssl)
+        next_session_event = now;
+    }
 
-    if (got_response) {
-        const auto response_size = setup_response_header(response_buffer, payload_type, payload_size);
-        connection->write(response_buffer, response_size);
+    return next_session_event;
+}
 
-        // FIXME (aw): this is hacky ...
-        log.exi(static_cast<uint16_t>(payload_type), response_buffer + io::SdpPacket::V2GTP_HEADER_SIZE, payload_size,
-                session::logging::ExiMessageDirection::TO_EV);
+void Session::send_pending_response() {
+    const auto [got_response, payload_size, payload_type, response_type] = message_exchange.check_and_clear_response();
 
-        ctx.feedback.v2g_message(response_type);
+    if (not got_response or not state.connected) {
+        // NOTE: if the connection got lost meanwhile, the response is dropped
+        return;
+    }
 
-        if (ctx.session_stopped) {
-            // Wait for 5 seconds [V2G20-1643]
-            std::this_thread::sleep_for(std::chrono::seconds(5));
-            connection->close();
-            ctx.feedback.signal(session::feedback::Signal::DLINK_TERMINATE);
-        }
+    const auto response_size = setup_response_header(response_buffer, payload_type, payload_size);
+    connection->write(response_buffer, response_size);
+
+    if (not state.connected) {
+        // the write failed and closed the connection, the loss has been signalled already
+        return;
     }
 
-    // FIXME (aw): proper timeout handling!
-    next_session_event = offset_time_point_by_ms(now, SESSION_IDLE_TIMEOUT_MS);
-    return next_session_event;
+    // FIXME (aw): this is hacky ...
+    log.exi(static_cast<uint16_t>(payload_type), response_buffer + io::SdpPacket::V2GTP_HEADER_SIZE, payload_size,
+            session::logging::ExiMessageDirection::TO_EV);
+
+    ctx.feedback.v2g_message(response_type);
+
+    stop_timer(timers.performance);
+
+    if (not ctx.session_stopped) {
+        start_timer(timers.sequence, SEQUENCE_TIMEOUT_MS, d20::Event::SEQUENCE_TIMEOUT);
+    } else {
+        // give the EV the chance to close the connection first [V2G20-1643]
+        close_connection(session::feedback::Signal::DLINK_TERMINATE);
+    }
 }
 
 void Session::handle_connection_event(io::ConnectionEvent event) {
@@ -214,8 +260,12 @@ void Session::handle_connection_event(io::ConnectionEvent event) {
     switch (event) {
     case Event::ACCEPTED:
         assert(state.connected == false);
+        state.accepted = true;
         state.connected = true;
         log("Accepted connection on port %d", connection->get_public_endpoint().port);
+
+        start_timer(timers.idle, SESSION_IDLE_TIMEOUT_MS, d20::Event::IDLE_TIMEOUT);
+        start_timer(timers.sequence, SEQUENCE_TIMEOUT_MS, d20::Event::SEQUENCE_TIMEOUT);
         return;
 
     case Event::NEW_DATA:
@@ -231,6 +281,22 @@ void Session::handle_connection_event(io::ConnectionEvent event) {
     case Event::CLOSED:
         state.connected = false;
         logf_info("Connection is closed");
+
+        if (state.close_signal) {
+            ctx.feedback.signal(*state.close_signal);
+            state.close_signal.reset();
+            return;
+        }
+
+        // not closed by us, but lost due to an error of the peer (reset, timeout, not reading anymore)
+        if (not ctx.session_stopped) {
+            log("Stopping session due to the loss of the connection");
+            ctx.session_stopped = true;
+            stop_timer(timers.idle);
+            stop_timer(timers.sequence);
+            stop_timer(timers.performance);
+            ctx.feedback.signal(session::feedback::Signal::DLINK_ERROR);
+        }
         return;
     }
 }
@@ -5,101 +5,396 @@
 #include <algorithm>
 #include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 
 #include <iso15118/io/connection_plain.hpp>
 #include <iso15118/io/connection_ssl.hpp>
 #include <iso15118/session/iso.hpp>
 
 #include <iso15118/detail/helper.hpp>
+#include <iso15118/detail/io/interface_registry.hpp>
 #include <iso15118/detail/io/socket_helper.hpp>
 
 namespace iso15118 {
 
+namespace {
+bool is_same_address(const std::optional<sockaddr_in6>& a, const std::optional<sockaddr_in6>& b) {
+    if (not a or not b) {
+        return not a and not b;
+    }
+
+    return a->sin6_scope_id == b->sin6_scope_id and std::memcmp(&a->sin6_addr, &b->sin6_addr, sizeof(in6_addr)) == 0;
+}
+
+std::vector<TbdConnectorConfig> make_single_connector(const TbdConfig& config, session::feedback::Callbacks callbacks,
+                                                      d20::EvseSetupConfig setup) {
+    std::vector<TbdConnectorConfig> connectors;
+    connectors.push_back({config.interface_name, std::move(callbacks), std::move(setup)});
+    return connectors;
+}
+} // namespace
+
 TbdController::TbdController(TbdConfig config_, session::feedback::Callbacks callbacks_, d20::EvseSetupConfig setup_) :
-    config(std::move(config_)),
-    callbacks(std::move(callbacks_)),
-    evse_setup(std::move(setup_)),
-    interface_name(config.interface_name) {
+    TbdController(config_, make_single_connector(config_, std::move(callbacks_), std::move(setup_))) {
+}
+
+TbdController::TbdController(TbdConfig config_, std::vector<TbdConnectorConfig> connector_configs) :
+    config(std::move(config_)) {
+
+    if (connector_configs.empty()) {
+        throw std::runtime_error("At least one connector needs to be configured!");
+    }
+
+    connectors.reserve(connector_configs.size());
+
+    for (auto& connector_config : connector_configs) {
+        auto& interface_name = connector_config.interface_name;
+
+        const auto result_interface_check = io::check_and_update_interface(interface_name);
+        if (result_interface_check) {
+            logf_info("Using ethernet interface: %s", interface_name.c_str());
+        } else {
+            throw std::runtime_error("Ethernet interface was not found!");
+        }
+
+        for (const auto& connector : connectors) {
+            if (connector.interface_name == interface_name) {
+                const auto msg = "Ethernet interface " + interface_name + " is used by more than one connector";
+                throw std::runtime_error(msg);
+            }
+        }
+
+        auto& connector = connectors.emplace_back();
+        connector.interface_name = std::move(interface_name);
+        connector.callbacks = std::move(connector_config.callbacks);
+        connector.evse_setup = std::move(connector_config.evse_setup);
+        connector.pending.evse_setup = connector.evse_setup;
+        connector.response_templates = std::make_shared<message_20::ResponseTemplates>();
+    }
 
-    const auto result_interface_check = io::check_and_update_interface(interface_name);
-    if (result_interface_check) {
-        logf_info("Using ethernet interface: %s", interface_name.c_str());
-    } else {
-        throw std::runtime_error("Ethernet interface was not found!");
+    for (auto& connector : connectors) {
+        open_listeners(connector);
+    }
+
+    // keeps the cached interfaces and addresses up to date
+    if (const auto registry_fd = io::InterfaceRegistry::get_instance().get_fd(); registry_fd != -1) {
+        poll_manager.register_fd(registry_fd, [this]() {
+            if (io::InterfaceRegistry::get_instance().handle_events()) {
+                handle_interface_change();
+            }
+        });
     }
 
     if (config.enable_sdp_server) {
-        sdp_server = std::make_unique<io::SdpServer>(interface_name);
+        std::vector<std::string> interface_names;
+        for (const auto& connector : connectors) {
+            interface_names.push_back(connector.interface_name);
+        }
+
+        sdp_server = std::make_unique<io::SdpServer>(interface_names);
         poll_manager.register_fd(sdp_server->get_fd(), [this]() { handle_sdp_server_input(); });
     }
 }
 
 void TbdController::loop() {
-    static constexpr auto POLL_MANAGER_TIMEOUT_MS = 50;
+    apply_pending_updates();
 
     if (not config.enable_sdp_server) {
-        auto connection = std::make_unique<io::ConnectionPlain>(poll_manager, interface_name);
-        session = std::make_unique<Session>(std::move(connection), d20::SessionConfig(evse_setup), callbacks);
+        for (auto& connector : connectors) {
+            start_session_without_sdp(connector);
+        }
     }
 
-    auto next_event = get_current_time_point();
+    // NOTE: all timeouts are handled by the timers of the poll manager, so without pending work, we can wait until
+    // the next io or timer event
+    auto poll_timeout_ms = -1;
 
-    while (true) {
-        const auto poll_timeout_ms = get_timeout_ms_until(next_event, POLL_MANAGER_TIMEOUT_MS);
+    while (not stop_requested) {
         poll_manager.poll(poll_timeout_ms);
 
-        next_event = offset_time_point_by_ms(get_current_time_point(), POLL_MANAGER_TIMEOUT_MS);
+        apply_pending_updates();
+
+        auto next_event = TimePoint::max();
+
+        for (auto& connector : connectors) {
+            auto& session = connector.session;
+
+            if (not session) {
+                continue;
+            }
+
+            // NOTE: a failing session (broken frame, io error, ...) must not take down the other connectors
+            try {
+                const auto next_session_event = session->poll();
+                next_event = std::min(next_event, next_session_event);
+            } catch (const std::exception& e) {
+                logf_error("Closing the session on interface %s, due to: %s", connector.interface_name.c_str(),
+                           e.what());
+                abort_session(connector);
+                continue;
+            }
 
-        if (session) {
-            const auto next_session_event = session->poll();
-            next_event = std::min(next_event, next_session_event);
             if (session->is_finished()) {
                 session.reset();
 
                 if (not config.enable_sdp_server) {
-                    auto connection = std::make_unique<io::ConnectionPlain>(poll_manager, interface_name);
-                    session =
-                        std::make_unique<Session>(std::move(connection), d20::SessionConfig(evse_setup), callbacks);
+                    start_session_without_sdp(connector);
                 }
             }
         }
+
+        if (next_event == TimePoint::max()) {
+            poll_timeout_ms = -1;
+        } else {
+            poll_timeout_ms = std::max(0, get_timeout_ms_until(next_event, std::numeric_limits<int32_t>::max()));
+        }
     }
 }
 
+void TbdController::stop() {
+    stop_requested = true;
+    poll_manager.abort();
+}
+
 void TbdController::send_control_event(const d20::ControlEvent& event) {
-    if (session) {
-        session->push_control_event(event);
+    send_control_event(0, event);
+}
+
+void TbdController::send_control_event(ConnectorId id, const d20::ControlEvent& event) {
+    auto& connector = get_connector(id);
+
+    {
+        const std::lock_guard<std::mutex> lock(update_mutex);
+        connector.pending.control_events.push_back(event);
     }
+
+    // wake up the event loop
+    poll_manager.abort();
 }
 
 void TbdController::update_authorization_services(const std::vector<message_20::datatypes::Authorization>& services,
                                                   bool cert_install_service) {
+    update_authorization_services(0, services, cert_install_service);
+}
 
-    evse_setup.enable_certificate_install_service = cert_install_service;
+void TbdController::update_authorization_services(ConnectorId id,
+                                                  const std::vector<message_20::datatypes::Authorization>& services,
+                                                  bool cert_install_service) {
 
-    if (services.empty()) {
-        logf_warning("The authorization services are not updated because services are empty!");
-        return;
+    auto& connector = get_connector(id);
+
+    {
+        const std::lock_guard<std::mutex> lock(update_mutex);
+        auto& pending = connector.pending;
+
+        const auto cert_install_service_changed =
+            pending.evse_setup.enable_certificate_install_service != cert_install_service;
+        pending.evse_setup.enable_certificate_install_service = cert_install_service;
+        pending.evse_setup_changed = true;
+
+        if (services.empty()) {
+            logf_warning("The authorization services are not updated because services are empty!");
+            pending.templates_changed = pending.templates_changed or cert_install_service_changed;
+        } else {
+            pending.evse_setup.authorization_services = services;
+            // the services are encoded into the session setup responses
+            pending.templates_changed = true;
+        }
     }
-    evse_setup.authorization_services = services;
+
+    poll_manager.abort();
 }
 
 void TbdController::update_dc_limits(const d20::DcTransferLimits& limits) {
+    update_dc_limits(0, limits);
+}
 
-    evse_setup.dc_limits = limits;
+void TbdController::update_dc_limits(ConnectorId id, const d20::DcTransferLimits& limits) {
+    auto& connector = get_connector(id);
 
-    if (session) {
-        session->push_control_event(limits);
+    {
+        const std::lock_guard<std::mutex> lock(update_mutex);
+        auto& pending = connector.pending;
+
+        // NOTE: the limits are not part of any response template, so the templates are kept
+        pending.evse_setup.dc_limits = limits;
+        pending.evse_setup_changed = true;
+        pending.control_events.push_back(limits);
     }
+
+    // wake up the event loop
+    poll_manager.abort();
 }
 
-void TbdController::handle_sdp_server_input() {
-    auto request = sdp_server->get_peer_request();
+TbdController::Connector& TbdController::get_connector(ConnectorId id) {
+    if (id >= connectors.size()) {
+        const auto msg = "Connector id " + std::to_string(id) + " is out of range";
+        throw std::out_of_range(msg);
+    }
+
+    return connectors[id];
+}
+
+void TbdController::apply_pending_updates() {
+    for (auto& connector : connectors) {
+        std::vector<d20::ControlEvent> control_events;
+
+        {
+            const std::lock_guard<std::mutex> lock(update_mutex);
+            auto& pending = connector.pending;
+
+            if (pending.evse_setup_changed) {
+                connector.evse_setup = pending.evse_setup;
+                pending.evse_setup_changed = false;
+            }
+
+            if (pending.templates_changed) {
+                // the next session starts with new templates, running sessions keep the ones of their evse setup
+                connector.response_templates = std::make_shared<message_20::ResponseTemplates>();
+                pending.templates_changed = false;
+            }
+
+            control_events.swap(pending.control_events);
+        }
+
+        // NOTE: without a session, the control events are dropped (the evse setup of the next one is up to date)
+        if (connector.session) {
+            for (const auto& event : control_events) {
+                connector.session->push_control_event(event);
+            }
+        }
+    }
+}
+
+void TbdController::open_listeners(Connector& connector) {
+    // NOTE: the listeners are kept open, so the endpoint offered by SDP is already listening
+    const auto enable_tls_listener =
+        config.enable_sdp_server and config.tls_negotiation_strategy != config::TlsNegotiationStrategy::ENFORCE_NO_TLS;
+
+    connector.tcp_listener.reset();
+    connector.tls_listener.reset();
+    connector.listener_address.reset();
+
+    const auto address = io::InterfaceRegistry::get_instance().get_address(connector.interface_name);
+
+    connector.tcp_listener = std::make_unique<io::Listener>(connector.interface_name, io::TCP_LISTENER_PORT);
+
+    if (enable_tls_listener) {
+        connector.tls_listener = std::make_unique<io::Listener>(connector.interface_name, io::TLS_LISTENER_PORT);
+    }
+
+    connector.listener_address = address;
+}
+
+void TbdController::handle_interface_change() {
+    auto& registry = io::InterfaceRegistry::get_instance();
+
+    for (auto& connector : connectors) {
+        const auto address = registry.get_address(connector.interface_name);
+
+        if (is_same_address(address, connector.listener_address)) {
+            continue;
+        }
+
+        // the connection of a session, which still waits for the EV, uses the previous listeners, whose endpoint
+        // can't be reached anymore, so the EV needs to start over with SDP (established connections are kept)
+        if (connector.session and
+            (connector.session->is_waiting_for_connection() or connector.session->is_finished())) {
+            connector.session.reset();
+            connector.sdp_offer.reset();
+        }
 
-    if (not request) {
+        if (not address) {
+            logf_warning("Interface %s lost its address, closing its listeners", connector.interface_name.c_str());
+            connector.tcp_listener.reset();
+            connector.tls_listener.reset();
+            connector.listener_address.reset();
+            continue;
+        }
+
+        logf_info("Address of interface %s changed, reopening its listeners", connector.interface_name.c_str());
+
+        try {
+            open_listeners(connector);
+        } catch (const std::exception& e) {
+            logf_error("Failed to reopen the listeners of interface %s, due to: %s", connector.interface_name.c_str(),
+                       e.what());
+            connector.tcp_listener.reset();
+            connector.tls_listener.reset();
+            continue;
+        }
+
+        if (not config.enable_sdp_server and not connector.session) {
+            start_session_without_sdp(connector);
+        }
+    }
+
+    // the interfaces might have come back with a new index
+    if (sdp_server) {
+        sdp_server->refresh();
+    }
+}
+
+void TbdController::abort_session(Connector& connector) {
+    connector.session.reset();
+    connector.sdp_offer.reset();
+
+    if (connector.callbacks.signal) {
+        connector.callbacks.signal(session::feedback::Signal::DLINK_ERROR);
+    }
+
+    if (not config.enable_sdp_server) {
+        start_session_without_sdp(connector);
+    }
+}
+
+void TbdController::start_session_without_sdp(Connector& connector) {
+    if (not connector.tcp_listener) {
+        // the interface has no address at the moment, the session is started as soon as it gets one
         return;
     }
 
+    auto connection = std::make_unique<io::ConnectionPlain>(poll_manager, *connector.tcp_listener);
+    connector.session = std::make_unique<Session>(poll_manager, std::move(connection),
+                                                  d20::SessionConfig(connector.evse_setup), connector.callbacks,
+                                                  connector.response_templates);
+}
+
+void TbdController::handle_sdp_server_input() {
+    for (auto request : sdp_server->get_peer_requests()) {
+        const auto connector = find_connector_by_interface(request.interface_index);
+
+        if (connector == nullptr) {
+            logf_warning("Dropping SDP request received on an interface without connector");
+            continue;
+        }
+
+        // NOTE: e.g. a TLS context, which can't be built, must not take down the other connectors
+        try {
+            handle_sdp_request(*connector, request);
+        } catch (const std::exception& e) {
+            logf_error("Failed to handle the SDP request on interface %s, due to: %s",
+                       connector->interface_name.c_str(), e.what());
+            abort_session(*connector);
+        }
+    }
+}
+
+TbdController::Connector* TbdController::find_connector_by_interface(unsigned int interface_index) {
+    auto& registry = io::InterfaceRegistry::get_instance();
+
+    for (auto& connector : connectors) {
+        if (registry.get_index(connector.interface_name) == interface_index) {
+            return &connector;
+        }
+    }
+
+    return nullptr;
+}
+
+void TbdController::handle_sdp_request(Connector& connector, io::PeerRequestContext& request) {
     switch (config.tls_negotiation_strategy) {
     case config::TlsNegotiationStrategy::ACCEPT_CLIENT_OFFER:
         // nothing to change
@@ -112,19 +407,59 @@ void TbdController::handle_sdp_server_input() {
         break;
     }
 
-    auto connection = [this](bool secure_connection) -> std::unique_ptr<io::IConnection> {
+    // the EV retries the SDP request, until it gets an answer, so the answer might just have been lost or late
+    if (is_retry_of_pending_offer(connector, request)) {
+        sdp_server->send_response(request, connector.sdp_offer->end_point);
+        return;
+    }
+
+    // a new request of another (or a confused) EV must not tear down a running session
+    if (connector.session and not connector.session->is_waiting_for_connection() and
+        not connector.session->is_finished()) {
+        logf_warning("Dropping SDP request, interface %s has an active session", connector.interface_name.c_str());
+        return;
+    }
+
+    const auto secure_connection = (request.security == io::v2gtp::Security::TLS);
+    const auto& listener = secure_connection ? connector.tls_listener : connector.tcp_listener;
+
+    if (not listener) {
+        logf_warning("Dropping SDP request, interface %s has no listener at the moment",
+                     connector.interface_name.c_str());
+        return;
+    }
+
+    // the previous session (and its connection) needs to release the listener first
+    connector.session.reset();
+    connector.sdp_offer.reset();
+
+    auto connection = [this, &listener](bool secure_connection) -> std::unique_ptr<io::IConnection> {
         if (secure_connection) {
-            return std::make_unique<io::ConnectionSSL>(poll_manager, interface_name, config.ssl);
+            return std::make_unique<io::ConnectionSSL>(poll_manager, *listener, config.ssl);
         } else {
-            return std::make_unique<io::ConnectionPlain>(poll_manager, interface_name);
+            return std::make_unique<io::ConnectionPlain>(poll_manager, *listener);
         }
-    }(request.security == io::v2gtp::Security::TLS);
+    }(secure_connection);
 
     const auto ipv6_endpoint = connection->get_public_endpoint();
 
-    session = std::make_unique<Session>(std::move(connection), d20::SessionConfig(evse_setup), callbacks);
+    connector.session = std::make_unique<Session>(poll_manager, std::move(connection),
+                                                  d20::SessionConfig(connector.evse_setup), connector.callbacks,
+                                                  connector.response_templates);
+    connector.sdp_offer = SdpOffer{request.address, request.security, ipv6_endpoint};
 
     sdp_server->send_response(request, ipv6_endpoint);
 }
 
+bool TbdController::is_retry_of_pending_offer(const Connector& connector, const io::PeerRequestContext& request) {
+    if (not connector.sdp_offer or not connector.session or not connector.session->is_waiting_for_connection()) {
+        return false;
+    }
+
+    const auto& offer = *connector.sdp_offer;
+
+    return offer.security == request.security and offer.peer_address.sin6_scope_id == request.address.sin6_scope_id and
+           std::memcmp(&offer.peer_address.sin6_addr, &request.address.sin6_addr, sizeof(in6_addr)) == 0;
+}
+
 } // namespace iso15118
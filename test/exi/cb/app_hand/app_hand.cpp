@@ -37,6 +37,25 @@ SCENARIO("App Protocol Ser/Des") {
         }
     }
 
+    GIVEN("An AppProtocolReq exceeding the limits of the schema") {
+        message_20::SupportedAppProtocolRequest req;
+        message_20::SupportedAppProtocolRequest::SupportedAppProtocol ap{};
+
+        THEN("A too long protocol namespace should be rejected") {
+            REQUIRE_THROWS(ap.protocol_namespace = std::string(101, 'x'));
+            REQUIRE_NOTHROW(ap.protocol_namespace = std::string(100, 'x'));
+            REQUIRE(ap.protocol_namespace.size() == 100);
+        }
+
+        THEN("Too many app protocols should be rejected") {
+            for (auto i = 0; i < 20; ++i) {
+                req.app_protocol.push_back(ap);
+            }
+            REQUIRE_THROWS(req.app_protocol.push_back(ap));
+            REQUIRE(req.app_protocol.size() == 20);
+        }
+    }
+
     // Todo(sl): Missing Decode message
     // 80400040
     // {"supportedAppProtocolRes": {"ResponseCode": "OK_SuccessfulNegotiation", "SchemaID": 1}}
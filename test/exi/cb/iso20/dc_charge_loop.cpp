@@ -1,5 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+#include <iso15118/detail/exi_template.hpp>
 #include <iso15118/message/dc_charge_loop.hpp>
 #include <iso15118/message/variant.hpp>
 
@@ -84,6 +90,79 @@ SCENARIO("Se/Deserialize dc charge loop messages") {
         }
     }
 
+    GIVEN("Deserialize consecutive dc_charge_loop_req into the same variant") {
+
+        uint8_t first_raw[] = {0x80, 0x34, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b, 0xa7, 0x6c, 0x4d, 0x8c, 0xdb, 0xfe,
+                               0x1b, 0x60, 0x62, 0x81, 0x00, 0x12, 0x00, 0x64, 0x64, 0x00, 0x0a, 0x02, 0x00, 0x24,
+                               0x00, 0xca};
+
+        uint8_t second_raw[] = {0x80, 0x34, 0x04, 0x32, 0x75, 0x76, 0x9e, 0xc7, 0x10, 0x64, 0xac, 0x8f, 0x0c, 0xfd,
+                                0xab, 0x70, 0x62, 0x00, 0x51, 0x84, 0x02, 0x00, 0x24, 0x00, 0xc6, 0x90, 0x21, 0xe0,
+                                0x5c, 0x08, 0x30, 0x3c, 0x04, 0x00, 0x00, 0x82, 0x04, 0x26, 0x1d, 0x41, 0x00, 0x00,
+                                0x00, 0x80, 0x0a, 0xc0, 0x20, 0x40, 0x04, 0x20, 0x38, 0x20, 0x02, 0x58, 0x04, 0x00};
+
+        message_20::Variant variant;
+        REQUIRE(variant.get_type() == message_20::Type::None);
+
+        variant.decode(io::v2gtp::PayloadType::Part20DC, {first_raw, sizeof(first_raw)});
+        REQUIRE(variant.get_type() == message_20::Type::DC_ChargeLoopReq);
+
+        variant.decode(io::v2gtp::PayloadType::Part20DC, {second_raw, sizeof(second_raw)});
+
+        THEN("Only the last one is held") {
+            REQUIRE(variant.get_type() == message_20::Type::DC_ChargeLoopReq);
+
+            const auto& msg = variant.get<message_20::DC_ChargeLoopRequest>();
+            REQUIRE(msg.header.timestamp == 1727440880);
+            REQUIRE(msg.display_parameters.has_value() == true);
+            REQUIRE(std::holds_alternative<message_20::datatypes::Dynamic_DC_CLReqControlMode>(msg.control_mode));
+        }
+
+        THEN("A failed decode leaves it empty") {
+            // only the exi header, the body is missing
+            variant.decode(io::v2gtp::PayloadType::Part20DC, {second_raw, 1});
+
+            REQUIRE(variant.get_type() == message_20::Type::None);
+            REQUIRE(variant.get_if<message_20::DC_ChargeLoopRequest>() == nullptr);
+        }
+    }
+
+    GIVEN("Read dc_charge_loop_req through its view") {
+
+        uint8_t doc_raw[] = {0x80, 0x34, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b, 0xa7, 0x6c, 0x4d, 0x8c, 0xdb, 0xfe, 0x1b,
+                             0x60, 0x62, 0x81, 0x00, 0x12, 0x00, 0x64, 0x64, 0x00, 0x0a, 0x02, 0x00, 0x24, 0x00, 0xca};
+
+        message_20::Variant variant(io::v2gtp::PayloadType::Part20DC, {doc_raw, sizeof(doc_raw)});
+
+        using ScheduledMode = message_20::datatypes::Scheduled_DC_CLReqControlMode;
+
+        THEN("The view reads the decoded fields") {
+            const auto view = variant.get_if<message_20::DC_ChargeLoopRequestView>();
+            REQUIRE(view != nullptr);
+
+            REQUIRE(view->get_timestamp() == 1725456333);
+            const uint8_t session_id[] = {0x3D, 0x4C, 0xBF, 0x93, 0x37, 0x4E, 0xD8, 0x9B};
+            REQUIRE(std::equal(std::begin(session_id), std::end(session_id), std::begin(view->get_session_id())));
+            REQUIRE(view->get_meter_info_requested() == false);
+            REQUIRE(dt::from_RationalNumber(view->get_present_voltage()) == 400);
+            REQUIRE(view->get_display_parameters().has_value() == false);
+            REQUIRE(view->holds_control_mode<ScheduledMode>());
+            REQUIRE(std::holds_alternative<ScheduledMode>(view->get_control_mode()));
+        }
+
+        THEN("The owning type converted from the view is the same") {
+            const auto& view = variant.get<message_20::DC_ChargeLoopRequestView>();
+            const auto& msg = variant.get<message_20::DC_ChargeLoopRequest>();
+
+            REQUIRE(std::equal(msg.header.session_id.begin(), msg.header.session_id.end(),
+                               std::begin(view.get_session_id())));
+            REQUIRE(msg.header.timestamp == view.get_timestamp());
+            REQUIRE(msg.present_voltage.value == view.get_present_voltage().value);
+            REQUIRE(msg.present_voltage.exponent == view.get_present_voltage().exponent);
+            REQUIRE(std::holds_alternative<ScheduledMode>(msg.control_mode));
+        }
+    }
+
     GIVEN("Serialize dc_charge_loop ongoing") {
 
         message_20::DC_ChargeLoopResponse res;
@@ -104,5 +183,52 @@ SCENARIO("Se/Deserialize dc charge loop messages") {
         THEN("It should be serialized succussfully") {
             REQUIRE(serialize_helper(res) == expected);
         }
+
+        THEN("Building it in place gives the same result") {
+            message_20::ResponseDocuments documents;
+
+            auto builder = documents.create_builder<message_20::DC_ChargeLoopResponseBuilder>();
+            builder.header(res.header)
+                .response_code(message_20::datatypes::ResponseCode::OK)
+                .control_mode(message_20::datatypes::Scheduled_DC_CLResControlMode())
+                .current_limit_achieved(true)
+                .power_limit_achieved(true)
+                .voltage_limit_achieved(true)
+                .present_current({1000, -3})
+                .present_voltage({4000, -1});
+
+            REQUIRE(serialize_helper(builder) == expected);
+
+            // the document is reused
+            auto next_builder = documents.create_builder<message_20::DC_ChargeLoopResponseBuilder>();
+            REQUIRE(serialize_helper(next_builder.set(res)) == expected);
+        }
+
+        THEN("Consecutive responses patched into the template are the same as fully encoded ones") {
+            message_20::ResponseDocuments documents;
+            message_20::ResponseTemplates templates;
+
+            // same encoding length, different encoding length, negative and different exponent
+            const std::vector<std::tuple<uint64_t, message_20::datatypes::RationalNumber>> cycles = {
+                {1725456334, {1000, -3}}, {1725456335, {1001, -3}}, {1725456336, {9, 0}},
+                {1725456337, {8, 0}},     {1725456338, {-8, 1}},    {1725456339, {-9, 2}},
+            };
+
+            for (const auto& [timestamp, present_current] : cycles) {
+                res.header.timestamp = timestamp;
+                res.present_current = present_current;
+
+                uint8_t buffer[1024];
+                const auto size = message_20::serialize(
+                    documents.create_builder<message_20::DC_ChargeLoopResponseBuilder>().set(res), templates,
+                    {buffer, sizeof(buffer)});
+
+                REQUIRE(std::vector<uint8_t>(buffer, buffer + size) == serialize_helper(res));
+            }
+
+            const auto& exi_template = templates.get(message_20::Type::DC_ChargeLoopRes);
+            REQUIRE(exi_template.get_encode_count() == 12);
+            REQUIRE(exi_template.get_patch_count() == 4);
+        }
     }
 }
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+#include <iso15118/detail/variant_access.hpp>
+#include <iso15118/message/variant.hpp>
+
+using namespace iso15118;
+
+using PayloadType = io::v2gtp::PayloadType;
+
+namespace {
+struct EncodedMessage {
+    message_20::Type type;
+    PayloadType payload_type;
+    std::vector<uint8_t> raw;
+
+    io::StreamInputView view() const {
+        return {raw.data(), raw.size()};
+    }
+};
+
+// requests of a DC session, in their usual order (taken from the message tests)
+const std::vector<EncodedMessage> REQUESTS = {
+    {message_20::Type::SessionSetupReq,
+     PayloadType::Part20Main,
+     {0x80, 0x8c, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x9f, 0x9c,
+      0x2b, 0xd0, 0x62, 0x0b, 0x2b, 0xa6, 0xa4, 0xab, 0x18, 0x99, 0x19, 0x9a, 0x1a, 0x9b,
+      0x1b, 0x9c, 0x1c, 0x98, 0x20, 0xa1, 0x21, 0xa2, 0x22, 0xac, 0x00}},
+    {message_20::Type::AuthorizationSetupReq,
+     PayloadType::Part20Main,
+     {0x80, 0x08, 0x04, 0x79, 0x0c, 0x8a, 0xdc, 0xee, 0xee, 0x09, 0x68, 0x8d, 0x6c, 0xac,
+      0x3a, 0x60, 0x62}},
+    {message_20::Type::AuthorizationReq,
+     PayloadType::Part20Main,
+     {0x80, 0x00, 0x04, 0x79, 0x0c, 0x8a, 0xdc, 0xee, 0xee, 0x09, 0x68, 0x8d, 0x6c, 0xac,
+      0x3a, 0x60, 0x62, 0x00}},
+    {message_20::Type::ServiceDiscoveryReq,
+     PayloadType::Part20Main,
+     {0x80, 0x7c, 0x04, 0x02, 0x75, 0xff, 0x96, 0x4a, 0x2c, 0xed, 0xa1, 0x0e, 0x38, 0x7e,
+      0x8a, 0x60, 0x62, 0x80}},
+    {message_20::Type::ServiceDetailReq,
+     PayloadType::Part20Main,
+     {0x80, 0x74, 0x04, 0x02, 0x75, 0xff, 0x96, 0x4a, 0x2c, 0xed, 0xa1, 0x0e, 0x38, 0x7e,
+      0x8a, 0x60, 0x62, 0x02, 0x80}},
+    {message_20::Type::ServiceSelectionReq,
+     PayloadType::Part20Main,
+     {0x80, 0x84, 0x04, 0x02, 0x75, 0xff, 0x96, 0x4a, 0x2c, 0xed, 0xa1, 0x0e, 0x38, 0x7e,
+      0x8a, 0x60, 0x62, 0x01, 0x40, 0x08, 0x80}},
+    {message_20::Type::DC_ChargeParameterDiscoveryReq,
+     PayloadType::Part20DC,
+     {0x80, 0x3c, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b, 0xa7, 0x6c, 0x4d, 0x8c, 0x3b, 0xfe,
+      0x1b, 0x60, 0x62, 0x88, 0x10, 0x98, 0x75, 0x04, 0x00, 0x32, 0x02, 0x00, 0x2b, 0x00,
+      0x81, 0x00, 0x01, 0x40, 0x80, 0x08, 0x40, 0x70, 0x40, 0x00, 0x50, 0x80}},
+    {message_20::Type::ScheduleExchangeReq,
+     PayloadType::Part20Main,
+     {0x80, 0x6c, 0x04, 0x23, 0xfe, 0x9d, 0xa7, 0x89, 0x92, 0xab, 0xe5, 0x0c, 0xee, 0x2c,
+      0x4b, 0x70, 0x62, 0x7e, 0x84, 0x28, 0x0e, 0x00, 0x83, 0x00, 0xa0, 0x10, 0x60, 0x28,
+      0x03, 0xf0, 0x02, 0x80, 0x00, 0x04, 0x80, 0xe0, 0x41, 0x80, 0x50, 0x40, 0x00, 0x02,
+      0xa2, 0xaa, 0xa9, 0x03, 0x27, 0x57, 0x26, 0xe3, 0xa6, 0x97, 0x36, 0xf3, 0xa7, 0x37,
+      0x46, 0x43, 0xa6, 0x97, 0x36, 0xf3, 0xa3, 0x13, 0x53, 0x13, 0x13, 0x83, 0xa2, 0xd3,
+      0x23, 0x03, 0xa5, 0x07, 0x26, 0x96, 0x36, 0x54, 0x16, 0xc6, 0x76, 0xf7, 0x26, 0x97,
+      0x46, 0x86, 0xd3, 0xa3, 0x12, 0xd5, 0x06, 0xf7, 0x76, 0x57, 0x20, 0x00, 0x02, 0x00,
+      0x00, 0x01, 0x00, 0x00, 0x01, 0x40}},
+    {message_20::Type::DC_CableCheckReq,
+     PayloadType::Part20DC,
+     {0x80, 0x2c, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b, 0xa7, 0x6c, 0x4d, 0x8c, 0x7b, 0xfe,
+      0x1b, 0x60, 0x62}},
+    {message_20::Type::DC_PreChargeReq,
+     PayloadType::Part20DC,
+     {0x80, 0x44, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b, 0xa7, 0x6c, 0x4d, 0x8c, 0xbb, 0xfe,
+      0x1b, 0x60, 0x62, 0x21, 0x00, 0x12, 0x00, 0x60, 0x80, 0x09, 0x00, 0x30}},
+    {message_20::Type::PowerDeliveryReq,
+     PayloadType::Part20Main,
+     {0x80, 0x54, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b, 0xa7, 0x6c, 0x4d, 0x8c, 0xdb, 0xfe,
+      0x1b, 0x60, 0x62, 0x00, 0x00, 0x01, 0x00, 0x42, 0x00, 0xb8, 0x41, 0x00, 0x51, 0x24}},
+    {message_20::Type::DC_ChargeLoopReq,
+     PayloadType::Part20DC,
+     {0x80, 0x34, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b, 0xa7, 0x6c, 0x4d, 0x8c, 0xdb, 0xfe,
+      0x1b, 0x60, 0x62, 0x81, 0x00, 0x12, 0x00, 0x64, 0x64, 0x00, 0x0a, 0x02, 0x00, 0x24,
+      0x00, 0xca}},
+    {message_20::Type::DC_WeldingDetectionReq,
+     PayloadType::Part20DC,
+     {0x80, 0x4c, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b, 0xa7, 0x6c, 0x4d, 0x8d, 0x5b, 0xfe,
+      0x1b, 0x60, 0x62, 0x20}},
+    {message_20::Type::SessionStopReq,
+     PayloadType::Part20Main,
+     {0x80, 0x94, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b, 0xa7, 0x6c, 0x4d, 0x8d, 0x7b, 0xfe,
+      0x1b, 0x60, 0x62, 0x28}},
+};
+
+// the stack high-water mark is measured by painting a probe area below the current stack frame, letting the decoder
+// run and checking how much of the paint got overwritten
+constexpr std::size_t STACK_PROBE_SIZE = 64 * 1024;
+constexpr uint8_t STACK_PAINT = 0xa5;
+
+[[gnu::noinline]] void paint_stack() {
+    volatile uint8_t probe[STACK_PROBE_SIZE];
+    for (auto& byte : probe) {
+        byte = STACK_PAINT;
+    }
+}
+
+[[gnu::noinline]] std::size_t measure_stack() {
+    volatile uint8_t probe[STACK_PROBE_SIZE];
+    // the stack grows down, so the paint is overwritten from the end of the probe
+    std::size_t untouched = 0;
+    while (untouched < STACK_PROBE_SIZE and probe[untouched] == STACK_PAINT) {
+        ++untouched;
+    }
+    return STACK_PROBE_SIZE - untouched;
+}
+} // namespace
+
+SCENARIO("Type-targeted decoding") {
+
+    GIVEN("The encoded requests") {
+        THEN("Their type is told without decoding them") {
+            for (const auto& request : REQUESTS) {
+                REQUIRE(message_20::peek_type(request.payload_type, request.view()) == request.type);
+            }
+        }
+
+        THEN("They are decoded into the same variant") {
+            message_20::Variant variant;
+            for (const auto& request : REQUESTS) {
+                variant.decode(request.payload_type, request.view());
+                REQUIRE(variant.get_type() == request.type);
+            }
+        }
+    }
+
+    GIVEN("A message type, which is not handled") {
+        // start of a DC_ChargeLoopRes
+        const uint8_t raw[] = {0x80, 0x38, 0x04, 0x1e, 0xa6, 0x5f, 0xc9, 0x9b};
+
+        THEN("It is rejected without decoding it") {
+            REQUIRE(message_20::peek_type(PayloadType::Part20DC, {raw, sizeof(raw)}) == message_20::Type::None);
+
+            message_20::Variant variant(PayloadType::Part20DC, {raw, sizeof(raw)});
+            REQUIRE(variant.get_type() == message_20::Type::None);
+            REQUIRE(std::string(variant.get_error()) == "chosen message type unhandled");
+        }
+    }
+}
+
+// NOTE: hidden, run with: test_exi_decode [benchmark]
+TEST_CASE("Decode time and stack usage per message type", "[.][benchmark]") {
+    message_20::Variant variant;
+
+    for (const auto& request : REQUESTS) {
+        // warm up, so one time allocations don't show up
+        variant.decode(request.payload_type, request.view());
+
+        paint_stack();
+        variant.decode(request.payload_type, request.view());
+        const auto stack_usage = measure_stack();
+
+        REQUIRE(variant.get_type() == request.type);
+        WARN("decode type " << static_cast<int>(request.type) << ": stack high-water mark " << stack_usage << " bytes");
+
+        BENCHMARK("decode type " + std::to_string(static_cast<int>(request.type))) {
+            variant.decode(request.payload_type, request.view());
+            return variant.get_type();
+        };
+    }
+}
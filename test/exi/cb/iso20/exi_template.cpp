@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <iso15118/detail/exi_template.hpp>
+
+using namespace iso15118;
+
+using message_20::ExiPatchEncoding;
+using message_20::ExiPatchField;
+using message_20::ExiTemplate;
+
+namespace {
+struct TestMessage {
+    uint8_t kind;
+    int8_t value;
+    int8_t unused; // not encoded at all, so no bit position can be found for it
+};
+
+// kind and value as bytes, like a cbv2g encoder does for xs:unsignedByte and xs:byte
+int encode_test_message(exi_bitstream_t* stream, TestMessage* message) {
+    if (const auto error = exi_bitstream_write_bits(stream, 8, message->kind); error != 0) {
+        return error;
+    }
+    return exi_bitstream_write_bits(stream, 8, static_cast<uint8_t>(message->value + 128));
+}
+
+const std::array<ExiPatchField, 1> PATCHABLE_FIELDS = {EXI_PATCH_FIELD(TestMessage, value, Byte)};
+
+const std::array<ExiPatchField, 2> NOT_PATCHABLE_FIELDS = {
+    EXI_PATCH_FIELD(TestMessage, value, Byte),
+    EXI_PATCH_FIELD(TestMessage, unused, Byte),
+};
+
+template <std::size_t N>
+std::vector<uint8_t> serialize_test_message(ExiTemplate& exi_template, TestMessage& message,
+                                            const std::array<ExiPatchField, N>& fields) {
+    uint8_t buffer[16];
+    const auto size = message_20::serialize_with_template<encode_test_message>(exi_template, message, message,
+                                                                              fields, {buffer, sizeof(buffer)});
+    return std::vector<uint8_t>(buffer, buffer + size);
+}
+} // namespace
+
+SCENARIO("Patch messages into their previous encoding") {
+
+    GIVEN("A message with a patchable field") {
+        ExiTemplate exi_template;
+        TestMessage message{0x12, 3, 0};
+
+        THEN("Changes of the field are patched, the first encode probes the field once") {
+            REQUIRE(serialize_test_message(exi_template, message, PATCHABLE_FIELDS) ==
+                    std::vector<uint8_t>{0x12, 0x83});
+
+            for (const auto value : {4, -1, 100}) {
+                message.value = static_cast<int8_t>(value);
+                REQUIRE(serialize_test_message(exi_template, message, PATCHABLE_FIELDS) ==
+                        std::vector<uint8_t>{0x12, static_cast<uint8_t>(value + 128)});
+            }
+
+            REQUIRE(exi_template.get_encode_count() == 2);
+            REQUIRE(exi_template.get_patch_count() == 3);
+        }
+
+        THEN("A change of the rest of the message is encoded and probed again") {
+            serialize_test_message(exi_template, message, PATCHABLE_FIELDS);
+
+            message.kind = 0x34;
+            REQUIRE(serialize_test_message(exi_template, message, PATCHABLE_FIELDS) ==
+                    std::vector<uint8_t>{0x34, 0x83});
+
+            REQUIRE(exi_template.get_encode_count() == 4);
+            REQUIRE(exi_template.get_patch_count() == 0);
+        }
+    }
+
+    GIVEN("A message with a field, which can't be patched") {
+        ExiTemplate exi_template;
+        TestMessage message{0x12, 3, 0};
+
+        THEN("It is only probed once and then encoded plainly") {
+            // encode plus one probe per field, the second one doesn't find the field
+            REQUIRE(serialize_test_message(exi_template, message, NOT_PATCHABLE_FIELDS) ==
+                    std::vector<uint8_t>{0x12, 0x83});
+            REQUIRE(exi_template.get_encode_count() == 3);
+
+            for (const auto value : {4, -1, 100}) {
+                message.value = static_cast<int8_t>(value);
+                REQUIRE(serialize_test_message(exi_template, message, NOT_PATCHABLE_FIELDS) ==
+                        std::vector<uint8_t>{0x12, static_cast<uint8_t>(value + 128)});
+            }
+
+            REQUIRE(exi_template.get_encode_count() == 6);
+            REQUIRE(exi_template.get_patch_count() == 0);
+
+            // probed again for the new key
+            message.kind = 0x34;
+            REQUIRE(serialize_test_message(exi_template, message, NOT_PATCHABLE_FIELDS) ==
+                    std::vector<uint8_t>{0x34, 0xe4});
+            REQUIRE(exi_template.get_encode_count() == 9);
+        }
+    }
+}
@@ -1,5 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <atomic>
+#include <memory_resource>
+#include <thread>
+
 #include <iso15118/message/power_delivery.hpp>
 #include <iso15118/message/variant.hpp>
 
@@ -41,6 +45,50 @@ SCENARIO("Se/Deserialize power delivery messages") {
             REQUIRE(mode.power_tolerance_acceptance == message_20::datatypes::PowerToleranceAcceptance::Confirmed);
             REQUIRE(mode.selected_schedule == 1);
         }
+
+        THEN("Its lists should be allocated from the memory resource of the variant") {
+            std::pmr::monotonic_buffer_resource resource;
+            message_20::Variant variant_with_resource(&resource);
+            variant_with_resource.decode(io::v2gtp::PayloadType::Part20Main, stream_view);
+
+            const auto& msg = variant_with_resource.get<message_20::PowerDeliveryRequest>();
+            REQUIRE(msg.power_profile.has_value() == true);
+            REQUIRE(msg.power_profile->entries.empty() == false);
+            REQUIRE(msg.power_profile->entries.get_allocator().resource() == &resource);
+            REQUIRE(std::pmr::get_default_resource() != &resource);
+        }
+
+        THEN("Decoding on another thread should leave the default memory resource untouched") {
+            const auto default_resource = std::pmr::get_default_resource();
+
+            std::atomic_bool decoding_done{false};
+            std::atomic_bool wrong_resource{false};
+
+            std::thread decoder([&stream_view, &decoding_done, &wrong_resource]() {
+                std::pmr::monotonic_buffer_resource resource;
+                message_20::Variant variant_with_resource(&resource);
+
+                for (auto i = 0; i < 1000; ++i) {
+                    variant_with_resource.decode(io::v2gtp::PayloadType::Part20Main, stream_view);
+                    const auto& msg = variant_with_resource.get<message_20::PowerDeliveryRequest>();
+                    if (not msg.power_profile or msg.power_profile->entries.get_allocator().resource() != &resource) {
+                        wrong_resource = true;
+                    }
+                }
+
+                decoding_done = true;
+            });
+
+            auto default_resource_changed = false;
+            while (not decoding_done) {
+                default_resource_changed |= (std::pmr::get_default_resource() != default_resource);
+            }
+
+            decoder.join();
+
+            REQUIRE(default_resource_changed == false);
+            REQUIRE(wrong_resource == false);
+        }
     }
 
     GIVEN("Serialize power_delivery_res") {
@@ -1,5 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <memory_resource>
+
 #include <iso15118/message/schedule_exchange.hpp>
 #include <iso15118/message/variant.hpp>
 
@@ -69,6 +71,18 @@ SCENARIO("Se/Deserialize schedule_exchange messages") {
                                                 .price_rules.at(0)
                                                 .power_range_start) == 0);
         }
+
+        THEN("Its lists should be allocated from the memory resource of the variant") {
+            std::pmr::monotonic_buffer_resource resource;
+            message_20::Variant variant_with_resource(&resource);
+            variant_with_resource.decode(io::v2gtp::PayloadType::Part20Main, stream_view);
+
+            const auto& msg = variant_with_resource.get<message_20::ScheduleExchangeRequest>();
+            const auto& energy_offer = std::get<dt::Scheduled_SEReqControlMode>(msg.control_mode).energy_offer;
+            REQUIRE(energy_offer.has_value() == true);
+            REQUIRE(energy_offer->power_schedule.entries.get_allocator().resource() == &resource);
+            REQUIRE(energy_offer->absolute_price_schedule.price_rule_stacks.get_allocator().resource() == &resource);
+        }
     }
 
     GIVEN("Serialize schedule_exchange_req - dynamic mode") {
@@ -162,12 +176,73 @@ SCENARIO("Se/Deserialize schedule_exchange messages") {
         THEN("It should be serialized succussfully") {
             REQUIRE(serialize_helper(res) == expected);
         }
+
+        THEN("Exceeding the schema limit is rejected") {
+            price_level.price_level_schedule_entries.resize(dt::PRICE_LEVEL_SCHEDULE_LENGTH);
+            REQUIRE_THROWS(price_level.price_level_schedule_entries.push_back({23, 8}));
+            REQUIRE(price_level.price_level_schedule_entries.size() == dt::PRICE_LEVEL_SCHEDULE_LENGTH);
+        }
     }
 
     GIVEN("Serialize schedule_exchange_res - scheduled mode - absolute price") {
         // TODO(sl): Add test + generate exi stream
     }
 
+    GIVEN("Schedule_exchange_res with an absolute price schedule of a single price rule") {
+        message_20::ScheduleExchangeResponse res;
+
+        res.header = message_20::Header{{0x47, 0xFD, 0x3B, 0x4F, 0x13, 0x25, 0x57, 0xCA}, 1727082831};
+        res.response_code = dt::ResponseCode::OK;
+        auto& control_mode = res.control_mode.emplace<dt::Scheduled_SEResControlMode>();
+        auto& tuple = control_mode.schedule_tuple.emplace_back();
+
+        tuple.schedule_tuple_id = 1;
+        tuple.charging_schedule.power_schedule.time_anchor = 1727082831;
+        tuple.charging_schedule.power_schedule.entries.push_back({86400, {2208, 1}, std::nullopt, std::nullopt});
+
+        auto& absolute_price = tuple.charging_schedule.price_schedule.emplace<dt::AbsolutePriceSchedule>();
+        absolute_price.time_anchor = 1727082831;
+        absolute_price.price_schedule_id = 1;
+        absolute_price.currency = "EUR";
+        absolute_price.language = "ENG";
+        absolute_price.price_algorithm = "urn:iso:std:iso:15118:-20:PriceAlgorithm:1-Power";
+        absolute_price.price_rule_stacks.push_back({86400, {{{30, -2}, std::nullopt, std::nullopt, std::nullopt,
+                                                             std::nullopt, {0, 0}}}});
+
+        THEN("Its footprint is sized to its content") {
+            // used to embed all 1024 price rule stacks of 8 price rules each
+            REQUIRE(sizeof(message_20::ScheduleExchangeResponse) < 1024);
+            REQUIRE(sizeof(dt::AbsolutePriceSchedule) < 1024);
+
+            // a single price rule stack is allocated, its price rules are stored in place
+            REQUIRE(absolute_price.price_rule_stacks.size() == 1);
+            REQUIRE(absolute_price.price_rule_stacks.capacity() == 1);
+            REQUIRE(absolute_price.tax_rules.has_value() == false);
+            REQUIRE(absolute_price.additional_selected_services.has_value() == false);
+        }
+
+        THEN("It should be serialized successfully") {
+            REQUIRE(serialize_helper(res).size() > 0);
+        }
+
+        THEN("Exceeding the schema limits is rejected") {
+            REQUIRE_THROWS(absolute_price.price_rule_stacks.resize(dt::PRICE_RULE_STACK_LENGTH + 1));
+            REQUIRE(absolute_price.price_rule_stacks.size() == 1);
+
+            auto& tax_rules = absolute_price.tax_rules.emplace();
+            tax_rules.resize(dt::TAX_RULE_LENGTH);
+            REQUIRE_THROWS(tax_rules.emplace_back());
+
+            auto& additional_services = absolute_price.additional_selected_services.emplace();
+            additional_services.resize(dt::ADDITIONAL_SERVICE_LENGTH);
+            REQUIRE_THROWS(additional_services.push_back({"Parking", {0, 0}}));
+
+            auto& overstay_rules = absolute_price.overstay_rules.emplace();
+            overstay_rules.overstay_rule.resize(dt::OVERSTAY_RULE_LENGTH);
+            REQUIRE_THROWS(overstay_rules.overstay_rule.push_back({std::nullopt, 0, {0, 0}, 0}));
+        }
+    }
+
     GIVEN("Serialize schedule_exchange_res - dynamic mode") {
         message_20::ScheduleExchangeResponse res;
 
@@ -1,5 +1,10 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <memory>
+#include <vector>
+
+#include <iso15118/detail/exi_template.hpp>
 #include <iso15118/message/service_detail.hpp>
 #include <iso15118/message/variant.hpp>
 
@@ -70,6 +75,36 @@ SCENARIO("Se/Deserialize service_detail messages") {
         THEN("It should be serialized successfully") {
             REQUIRE(serialize_helper(res) == expected);
         }
+
+        THEN("Following sessions get it patched into the shared template") {
+            const auto shared_templates = std::make_shared<message_20::ResponseTemplates>();
+
+            const std::vector<message_20::Header> headers = {
+                {{0x3D, 0x4C, 0xBF, 0x93, 0x37, 0x4E, 0xD8, 0x9B}, 1725456323},
+                {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01}, 1725456400},
+                {{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 1725456401},
+            };
+
+            for (const auto& header : headers) {
+                // per session
+                message_20::ResponseDocuments documents;
+                message_20::ResponseTemplates templates(shared_templates);
+
+                res.header = header;
+
+                uint8_t buffer[1024];
+                const auto size =
+                    message_20::serialize(documents.create_builder<message_20::ServiceDetailResponseBuilder>().set(res),
+                                          templates, {buffer, sizeof(buffer)});
+
+                REQUIRE(std::vector<uint8_t>(buffer, buffer + size) == serialize_helper(res));
+            }
+
+            const auto& exi_template = shared_templates->get(message_20::Type::ServiceDetailRes,
+                                                             static_cast<uint16_t>(res.service));
+            REQUIRE(exi_template.get_encode_count() == 3);
+            REQUIRE(exi_template.get_patch_count() == 2);
+        }
     }
 
     GIVEN("Deserialize service_detail_res") {
@@ -119,3 +154,37 @@ SCENARIO("Se/Deserialize service_detail messages") {
         }
     }
 }
+
+// NOTE: hidden, run with: test_exi_service_detail [benchmark]
+TEST_CASE("Encoding time of the service_detail_res for a new session", "[.][benchmark]") {
+    message_20::ServiceDetailResponse res;
+    res.header = message_20::Header{{0x3D, 0x4C, 0xBF, 0x93, 0x37, 0x4E, 0xD8, 0x9B}, 1725456323};
+    res.response_code = message_20::datatypes::ResponseCode::OK;
+    res.service = message_20::datatypes::ServiceCategory::DC;
+
+    const auto list = message_20::datatypes::DcParameterList{
+        message_20::datatypes::DcConnector::Extended, message_20::datatypes::ControlMode::Scheduled,
+        message_20::datatypes::MobilityNeedsMode::ProvidedByEvcc, message_20::datatypes::Pricing::NoPricing};
+    res.service_parameter_list = {message_20::datatypes::ParameterSet(0, list)};
+
+    uint8_t buffer[1024];
+    const io::StreamOutputView out{buffer, sizeof(buffer)};
+
+    message_20::ResponseDocuments documents;
+    const auto shared_templates = std::make_shared<message_20::ResponseTemplates>();
+
+    BENCHMARK("encoded for every session") {
+        res.header.session_id[7]++;
+        res.header.timestamp++;
+        return message_20::serialize(documents.create_builder<message_20::ServiceDetailResponseBuilder>().set(res),
+                                     out);
+    };
+
+    BENCHMARK("patched into the shared template") {
+        res.header.session_id[7]++;
+        res.header.timestamp++;
+        message_20::ResponseTemplates templates(shared_templates);
+        return message_20::serialize(documents.create_builder<message_20::ServiceDetailResponseBuilder>().set(res),
+                                     templates, out);
+    };
+}
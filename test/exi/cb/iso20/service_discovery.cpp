@@ -1,5 +1,8 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <memory>
+
 #include <iso15118/message/service_discovery.hpp>
 #include <iso15118/message/variant.hpp>
 
@@ -179,3 +182,34 @@ SCENARIO("Se/Deserialize service_discovery messages") {
         }
     }
 }
+
+// NOTE: hidden, run with: test_exi_service_discovery [benchmark]
+TEST_CASE("Encoding time of the service_discovery_res for a new session", "[.][benchmark]") {
+    message_20::ServiceDiscoveryResponse res;
+    res.header = message_20::Header{{0x3D, 0x4C, 0xBF, 0x93, 0x37, 0x4E, 0xD8, 0x9B}, 1725456322};
+    res.response_code = message_20::datatypes::ResponseCode::OK;
+    res.service_renegotiation_supported = false;
+    res.energy_transfer_service_list = {{message_20::datatypes::ServiceCategory::DC, false},
+                                        {message_20::datatypes::ServiceCategory::DC_BPT, false}};
+
+    uint8_t buffer[1024];
+    const io::StreamOutputView out{buffer, sizeof(buffer)};
+
+    message_20::ResponseDocuments documents;
+    const auto shared_templates = std::make_shared<message_20::ResponseTemplates>();
+
+    BENCHMARK("encoded for every session") {
+        res.header.session_id[7]++;
+        res.header.timestamp++;
+        return message_20::serialize(documents.create_builder<message_20::ServiceDiscoveryResponseBuilder>().set(res),
+                                     out);
+    };
+
+    BENCHMARK("patched into the shared template") {
+        res.header.session_id[7]++;
+        res.header.timestamp++;
+        message_20::ResponseTemplates templates(shared_templates);
+        return message_20::serialize(documents.create_builder<message_20::ServiceDiscoveryResponseBuilder>().set(res),
+                                     templates, out);
+    };
+}
@@ -27,7 +27,7 @@ SCENARIO("ISO15118-20 state transitions") {
                                           dc_limits, control_mobility_modes};
 
     auto state_helper = FsmStateHelper(d20::SessionConfig(evse_setup));
-    auto ctx = state_helper.get_context();
+    auto& ctx = state_helper.get_context();
 
     fsm::v2::FSM<d20::StateBase> fsm{ctx.create_state<d20::state::SupportedAppProtocol>()};
 
@@ -44,7 +44,7 @@ public:
         // Note: return value is not used here
         message_20::serialize_helper(request, output_stream_view);
 
-        msg_exch.set_request(std::make_unique<message_20::Variant>(payload_type, output_stream_view));
+        msg_exch.set_request(payload_type, output_stream_view);
     }
 
 private:
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2023 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <set>
+#include <vector>
+
+#include "helper.hpp"
+
+using namespace iso15118;
+
+namespace {
+
+bool is_inside(const void* object, std::size_t object_size, const void* memory) {
+    const auto begin = static_cast<const std::byte*>(object);
+    const auto address = static_cast<const std::byte*>(memory);
+    return address >= begin and address < begin + object_size;
+}
+
+// counts its instances and transitions to a new instance of itself on every message
+struct CountingState : public d20::StateBase {
+    explicit CountingState(d20::Context& ctx) : StateBase(ctx, d20::StateID::SupportedAppProtocol) {
+        ++instances;
+        addresses.insert(this);
+    }
+
+    ~CountingState() override {
+        --instances;
+    }
+
+    d20::Result feed(d20::Event ev) override {
+        if (ev != d20::Event::V2GTP_MESSAGE) {
+            return {};
+        }
+
+        return m_ctx.create_state<CountingState>();
+    }
+
+    static inline std::size_t instances{0};
+    static inline std::set<const void*> addresses;
+};
+
+d20::SessionConfig make_session_config() {
+    const d20::EvseSetupConfig evse_setup{"everest se",
+                                          {message_20::datatypes::ServiceCategory::DC},
+                                          {message_20::datatypes::Authorization::EIM},
+                                          false,
+                                          {},
+                                          {{message_20::datatypes::ControlMode::Scheduled,
+                                            message_20::datatypes::MobilityNeedsMode::ProvidedByEvcc}}};
+
+    return d20::SessionConfig(evse_setup);
+}
+
+} // namespace
+
+SCENARIO("State pool of the d20 context") {
+
+    GIVEN("A state pool") {
+        d20::StatePool pool;
+
+        WHEN("All slots are in use") {
+            std::vector<void*> slots;
+            for (std::size_t i = 0; i < d20::StatePool::SLOT_COUNT; ++i) {
+                slots.push_back(pool.allocate(d20::StatePool::SLOT_SIZE));
+            }
+
+            THEN("The slots are taken from the pool") {
+                for (const auto slot : slots) {
+                    REQUIRE(is_inside(&pool, sizeof(pool), slot));
+                }
+                REQUIRE(std::set<void*>(slots.begin(), slots.end()).size() == d20::StatePool::SLOT_COUNT);
+            }
+
+            THEN("Another allocation falls back to the heap") {
+                const auto memory = pool.allocate(d20::StatePool::SLOT_SIZE);
+                REQUIRE(memory != nullptr);
+                REQUIRE(is_inside(&pool, sizeof(pool), memory) == false);
+
+                // returned to the heap, the slots are still in use
+                pool.deallocate(memory);
+                const auto next_memory = pool.allocate(d20::StatePool::SLOT_SIZE);
+                REQUIRE(is_inside(&pool, sizeof(pool), next_memory) == false);
+                pool.deallocate(next_memory);
+            }
+
+            THEN("A freed slot is reused") {
+                pool.deallocate(slots[1]);
+                REQUIRE(pool.allocate(d20::StatePool::SLOT_SIZE) == slots[1]);
+            }
+        }
+    }
+
+    GIVEN("A context") {
+        auto state_helper = FsmStateHelper(make_session_config());
+        auto& ctx = state_helper.get_context();
+
+        CountingState::addresses.clear();
+
+        WHEN("The fsm transitions many times") {
+            {
+                fsm::v2::FSM<d20::StateBase> fsm{ctx.create_state<CountingState>()};
+
+                for (auto i = 0; i < 1000; ++i) {
+                    const auto result = fsm.feed(d20::Event::V2GTP_MESSAGE);
+                    REQUIRE(result.transitioned());
+                }
+
+                REQUIRE(CountingState::instances == 1);
+            }
+
+            THEN("The states reuse the slots of the context") {
+                REQUIRE(CountingState::instances == 0);
+                REQUIRE(CountingState::addresses.size() <= d20::StatePool::SLOT_COUNT);
+                for (const auto address : CountingState::addresses) {
+                    REQUIRE(is_inside(&ctx, sizeof(ctx), address));
+                }
+            }
+        }
+
+        WHEN("More states than slots exist at the same time") {
+            std::vector<d20::BasePointerType> states;
+            for (std::size_t i = 0; i < d20::StatePool::SLOT_COUNT + 1; ++i) {
+                states.push_back(ctx.create_state<CountingState>());
+            }
+
+            THEN("The last one is allocated on the heap") {
+                REQUIRE(CountingState::instances == d20::StatePool::SLOT_COUNT + 1);
+                for (std::size_t i = 0; i < d20::StatePool::SLOT_COUNT; ++i) {
+                    REQUIRE(is_inside(&ctx, sizeof(ctx), states[i].get()));
+                }
+                REQUIRE(is_inside(&ctx, sizeof(ctx), states.back().get()) == false);
+
+                states.clear();
+                REQUIRE(CountingState::instances == 0);
+            }
+        }
+
+        WHEN("A state is deleted through its base pointer") {
+            d20::BasePointerType state = ctx.create_state<CountingState>();
+            const auto slot = static_cast<const void*>(state.get());
+            state.reset();
+
+            THEN("It is destroyed and its slot is free again") {
+                REQUIRE(CountingState::instances == 0);
+                REQUIRE(ctx.create_state<CountingState>().get() == slot);
+            }
+        }
+
+        WHEN("A state without pool is deleted through its base pointer") {
+            d20::BasePointerType state(new CountingState(ctx), d20::StateDeleter{});
+            state.reset();
+
+            THEN("It is destroyed") {
+                REQUIRE(CountingState::instances == 0);
+            }
+        }
+    }
+}
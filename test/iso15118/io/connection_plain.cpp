@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <iso15118/io/connection_plain.hpp>
+
+using namespace iso15118;
+
+namespace {
+// NOTE: the connection binds to the first ipv6 address of the loopback interface (::1)
+constexpr auto INTERFACE_NAME = "lo";
+
+int connect_client(const io::Ipv6EndPoint& end_point) {
+    const auto fd = socket(AF_INET6, SOCK_STREAM, 0);
+    REQUIRE(fd != -1);
+
+    // keep the receive buffer small, so the server runs into back-pressure
+    int buffer_size = 4096;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+
+    sockaddr_in6 address{};
+    address.sin6_family = AF_INET6;
+    address.sin6_port = htons(end_point.port);
+    std::memcpy(&address.sin6_addr, end_point.address, sizeof(address.sin6_addr));
+
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+    return fd;
+}
+} // namespace
+
+SCENARIO("Plain connection") {
+
+    io::PollManager poll_manager;
+    io::ConnectionPlain connection(poll_manager, INTERFACE_NAME);
+
+    std::vector<io::ConnectionEvent> events;
+    connection.set_event_callback([&events](io::ConnectionEvent event) { events.push_back(event); });
+
+    auto client_fd = connect_client(connection.get_public_endpoint());
+    poll_manager.poll(1000);
+
+    REQUIRE(events.size() == 2);
+    REQUIRE(events[1] == io::ConnectionEvent::OPEN);
+
+    GIVEN("More output than the socket buffers can take") {
+        std::vector<uint8_t> output(io::OutputQueue::MAX_SIZE);
+        for (size_t i = 0; i < output.size(); ++i) {
+            output[i] = i % 251;
+        }
+
+        THEN("The write doesn't fail and the output is sent while the client reads") {
+            REQUIRE_NOTHROW(connection.write(output.data(), output.size()));
+
+            std::vector<uint8_t> input;
+            uint8_t buffer[65536];
+
+            while (input.size() < output.size()) {
+                poll_manager.poll(0);
+                const auto read_result = recv(client_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+                if (read_result > 0) {
+                    input.insert(input.end(), buffer, buffer + read_result);
+                }
+            }
+
+            REQUIRE(input == output);
+        }
+    }
+
+    GIVEN("A client, which doesn't read anymore") {
+        const std::vector<uint8_t> output(io::OutputQueue::MAX_SIZE);
+
+        THEN("The connection is closed, as soon as the output queue would overflow") {
+            REQUIRE_NOTHROW(connection.write(output.data(), output.size()));
+            REQUIRE(events.back() != io::ConnectionEvent::CLOSED);
+
+            // the socket buffers (at most tcp_wmem + tcp_rmem) take some of the output, the queue the rest
+            auto write_count = 1;
+            while (events.back() != io::ConnectionEvent::CLOSED and write_count < 256) {
+                REQUIRE_NOTHROW(connection.write(output.data(), output.size()));
+                ++write_count;
+            }
+
+            REQUIRE(events.back() == io::ConnectionEvent::CLOSED);
+        }
+    }
+
+    GIVEN("A client, which resets the connection") {
+        linger abort_on_close{1, 0};
+        REQUIRE(setsockopt(client_fd, SOL_SOCKET, SO_LINGER, &abort_on_close, sizeof(abort_on_close)) == 0);
+        close(client_fd);
+        client_fd = -1;
+
+        THEN("A write closes the connection instead of failing") {
+            const uint8_t output[16]{};
+
+            // the first write might still succeed, before the reset is noticed
+            for (auto i = 0; i < 2 and events.back() != io::ConnectionEvent::CLOSED; ++i) {
+                REQUIRE_NOTHROW(connection.write(output, sizeof(output)));
+            }
+
+            REQUIRE(events.back() == io::ConnectionEvent::CLOSED);
+        }
+    }
+
+    GIVEN("A client, which closes the connection") {
+        close(client_fd);
+        client_fd = -1;
+
+        THEN("The loss is reported on the next read and the fd isn't signalled anymore") {
+            poll_manager.poll(1000);
+            REQUIRE(events.back() == io::ConnectionEvent::NEW_DATA);
+
+            uint8_t buffer[16];
+            const auto read_result = connection.read(buffer, sizeof(buffer));
+            REQUIRE(read_result.would_block);
+            REQUIRE(read_result.bytes_read == 0);
+            REQUIRE(events.back() == io::ConnectionEvent::CLOSED);
+
+            const auto event_count = events.size();
+            poll_manager.poll(100);
+            REQUIRE(events.size() == event_count);
+
+            AND_THEN("A close afterwards does nothing") {
+                connection.close();
+                poll_manager.poll(100);
+                REQUIRE(events.size() == event_count);
+            }
+        }
+    }
+
+    GIVEN("A client, which closes the connection after the server") {
+        THEN("The connection is closed without waiting for the linger timeout") {
+            const auto start = std::chrono::steady_clock::now();
+            connection.close();
+
+            // the client sees the FIN of the server and closes its side as well
+            uint8_t buffer[16];
+            REQUIRE(recv(client_fd, buffer, sizeof(buffer), 0) == 0);
+            close(client_fd);
+            client_fd = -1;
+
+            while (events.back() != io::ConnectionEvent::CLOSED) {
+                poll_manager.poll(100);
+            }
+
+            REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+        }
+    }
+
+    if (client_fd != -1) {
+        close(client_fd);
+    }
+}
@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/ssl.h>
+
+#include <iso15118/io/connection_ssl.hpp>
+
+using namespace iso15118;
+
+// NOTE: the test pki is created by pki.sh in the pki directory next to the test executable
+
+namespace {
+constexpr auto INTERFACE_NAME = "lo";
+constexpr auto PKI_PASSWORD = "123456";
+constexpr auto TIMEOUT = std::chrono::seconds(10);
+
+config::SSLConfig get_ssl_config(bool enforce_tls_1_3) {
+    config::SSLConfig ssl_config{};
+    ssl_config.path_certificate_chain = "pki/certs/client/cso/CPO_CERT_CHAIN.pem";
+    ssl_config.path_certificate_key = "pki/certs/client/cso/SECC_LEAF.key";
+    ssl_config.private_key_password = PKI_PASSWORD;
+    ssl_config.path_certificate_v2g_root = "pki/certs/ca/v2g/V2G_ROOT_CA.pem";
+    ssl_config.path_certificate_mo_root = "pki/certs/ca/oem/OEM_ROOT_CA.pem";
+    ssl_config.enforce_tls_1_3 = enforce_tls_1_3;
+    ssl_config.enable_ktls = true;
+    return ssl_config;
+}
+
+int password_callback(char* buf, int size, int, void*) {
+    const auto length = std::min<int>(size - 1, strlen(PKI_PASSWORD));
+    std::memcpy(buf, PKI_PASSWORD, length);
+    return length;
+}
+
+using SessionPtr = std::unique_ptr<SSL_SESSION, void (*)(SSL_SESSION*)>;
+
+struct ClientOptions {
+    bool use_tls_1_3{false};
+    // resumes this session, if set
+    SSL_SESSION* session{nullptr};
+    // without tickets, a TLS 1.2 session is resumed by its id
+    bool use_ticket{true};
+};
+
+// blocking EV side, sends the request, reads the response and closes the connection
+struct TlsClient {
+    TlsClient(const io::Ipv6EndPoint& end_point, const ClientOptions& options, const std::vector<uint8_t>& request,
+              size_t response_size) {
+        thread = std::thread([this, end_point, options, request, response_size]() {
+            success = run(end_point, options, request, response_size);
+            done = true;
+        });
+    }
+
+    ~TlsClient() {
+        thread.join();
+    }
+
+    bool run(const io::Ipv6EndPoint& end_point, const ClientOptions& options, const std::vector<uint8_t>& request,
+             size_t response_size) {
+        const auto ctx = SSL_CTX_new(TLS_client_method());
+
+        if (options.use_tls_1_3) {
+            SSL_CTX_set_min_proto_version(ctx, TLS1_3_VERSION);
+            SSL_CTX_set_default_passwd_cb(ctx, password_callback);
+            SSL_CTX_use_certificate_chain_file(ctx, "pki/certs/ca/vehicle/VEHICLE_CERT_CHAIN.pem");
+            SSL_CTX_use_PrivateKey_file(ctx, "pki/certs/client/vehicle/VEHICLE_LEAF.key", SSL_FILETYPE_PEM);
+        } else {
+            SSL_CTX_set_max_proto_version(ctx, TLS1_2_VERSION);
+            SSL_CTX_set_cipher_list(ctx, "ECDHE-ECDSA-AES128-SHA256");
+        }
+
+        if (not options.use_ticket) {
+            SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+        }
+
+        SSL_CTX_load_verify_file(ctx, "pki/certs/ca/v2g/V2G_ROOT_CA.pem");
+        SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+
+        const auto fd = socket(AF_INET6, SOCK_STREAM, 0);
+
+        sockaddr_in6 address{};
+        address.sin6_family = AF_INET6;
+        address.sin6_port = htons(end_point.port);
+        std::memcpy(&address.sin6_addr, end_point.address, sizeof(address.sin6_addr));
+
+        auto result = (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+        const auto ssl = SSL_new(ctx);
+        SSL_set_fd(ssl, fd);
+
+        if (options.session) {
+            SSL_set_session(ssl, options.session);
+        }
+
+        result = result and (SSL_connect(ssl) == 1);
+        result = result and (SSL_write(ssl, request.data(), request.size()) == static_cast<int>(request.size()));
+
+        response.resize(response_size);
+        size_t received{0};
+        while (result and received < response_size) {
+            const auto read_result = SSL_read(ssl, response.data() + received, response_size - received);
+            result = (read_result > 0);
+            received += result ? read_result : 0;
+        }
+
+        // NOTE: the TLS 1.3 tickets are sent after the handshake, so they have been received with the response
+        session_reused = SSL_session_reused(ssl);
+        session.reset(SSL_get1_session(ssl));
+
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+        close(fd);
+        SSL_CTX_free(ctx);
+
+        return result;
+    }
+
+    std::thread thread;
+    std::vector<uint8_t> response;
+    SessionPtr session{nullptr, SSL_SESSION_free};
+    std::atomic_bool session_reused{false};
+    std::atomic_bool done{false};
+    std::atomic_bool success{false};
+};
+
+template <typename Predicate> bool poll_until(io::PollManager& poll_manager, const Predicate& predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (not predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        poll_manager.poll(10);
+    }
+    return true;
+}
+
+struct ExchangeResult {
+    bool ktls_send{false};
+    bool session_reused{false};
+    SessionPtr session{nullptr, SSL_SESSION_free};
+};
+
+ExchangeResult exchange_data(const ClientOptions& options) {
+    io::PollManager poll_manager;
+    io::ConnectionSSL connection(poll_manager, INTERFACE_NAME, get_ssl_config(options.use_tls_1_3));
+
+    bool open{false};
+    bool new_data{false};
+    bool closed{false};
+    connection.set_event_callback([&](io::ConnectionEvent event) {
+        open = open or (event == io::ConnectionEvent::OPEN);
+        new_data = new_data or (event == io::ConnectionEvent::NEW_DATA);
+        closed = closed or (event == io::ConnectionEvent::CLOSED);
+    });
+
+    const std::vector<uint8_t> request{0x01, 0xFE, 0x80, 0x02, 0x00, 0x00, 0x00, 0x00};
+    std::vector<uint8_t> response(64 * 1024);
+    for (size_t i = 0; i < response.size(); ++i) {
+        response[i] = i % 253;
+    }
+
+    TlsClient client(connection.get_public_endpoint(), options, request, response.size());
+
+    REQUIRE(poll_until(poll_manager, [&open]() { return open; }));
+    REQUIRE(poll_until(poll_manager, [&new_data]() { return new_data; }));
+
+    std::vector<uint8_t> received(request.size());
+    size_t received_bytes{0};
+    REQUIRE(poll_until(poll_manager, [&]() {
+        const auto remaining = received.size() - received_bytes;
+        received_bytes += connection.read(received.data() + received_bytes, remaining).bytes_read;
+        return received_bytes == received.size();
+    }));
+    REQUIRE(received == request);
+
+    connection.write(response.data(), response.size());
+
+    REQUIRE(poll_until(poll_manager, [&client]() { return client.done.load(); }));
+    REQUIRE(client.success);
+    REQUIRE(client.response == response);
+
+    // the client closed the connection, which needs to be read to be noticed
+    uint8_t discard_buffer[16];
+    REQUIRE(poll_until(poll_manager, [&]() {
+        if (not closed) {
+            connection.read(discard_buffer, sizeof(discard_buffer));
+        }
+        return closed;
+    }));
+
+    return {connection.is_ktls_send_enabled(), client.session_reused, std::move(client.session)};
+}
+
+void resume_session(const ClientOptions& options) {
+    const auto stats_before = io::ConnectionSSL::get_session_resumption_stats();
+
+    const auto first = exchange_data(options);
+    REQUIRE(not first.session_reused);
+    REQUIRE(first.session != nullptr);
+
+    auto resume_options = options;
+    resume_options.session = first.session.get();
+    const auto second = exchange_data(resume_options);
+    REQUIRE(second.session_reused);
+
+    const auto stats_after = io::ConnectionSSL::get_session_resumption_stats();
+    REQUIRE(stats_after.misses == stats_before.misses + 1);
+    REQUIRE(stats_after.hits == stats_before.hits + 1);
+}
+} // namespace
+
+SCENARIO("TLS connection with kTLS enabled") {
+
+    GIVEN("A TLS 1.3 client") {
+        THEN("Data is exchanged with or without kernel support") {
+            exchange_data({true});
+        }
+    }
+
+    GIVEN("A TLS 1.2 client") {
+        THEN("Data is exchanged in user space, as the kernel doesn't support the CBC ciphersuite") {
+            const auto result = exchange_data({false});
+            REQUIRE(result.ktls_send == false);
+        }
+    }
+}
+
+SCENARIO("TLS session resumption") {
+
+    GIVEN("A reconnecting TLS 1.3 client") {
+        THEN("The session is resumed with its ticket") {
+            resume_session({true});
+        }
+    }
+
+    GIVEN("A reconnecting TLS 1.2 client") {
+        THEN("The session is resumed with its ticket") {
+            resume_session({false});
+        }
+    }
+
+    GIVEN("A reconnecting TLS 1.2 client, which doesn't support tickets") {
+        THEN("The session is resumed by its id") {
+            resume_session({false, nullptr, false});
+        }
+    }
+
+}
+
+SCENARIO("TLS connection with a failing handshake") {
+
+    io::PollManager poll_manager;
+    io::ConnectionSSL connection(poll_manager, INTERFACE_NAME, get_ssl_config(false));
+
+    std::vector<io::ConnectionEvent> events;
+    connection.set_event_callback([&events](io::ConnectionEvent event) { events.push_back(event); });
+
+    GIVEN("A client, which doesn't speak TLS") {
+        const auto end_point = connection.get_public_endpoint();
+
+        const auto fd = socket(AF_INET6, SOCK_STREAM, 0);
+        sockaddr_in6 address{};
+        address.sin6_family = AF_INET6;
+        address.sin6_port = htons(end_point.port);
+        std::memcpy(&address.sin6_addr, end_point.address, sizeof(address.sin6_addr));
+        REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+        const uint8_t request[] = {0x01, 0xFE, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00};
+        REQUIRE(send(fd, request, sizeof(request), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(request)));
+
+        THEN("The connection is closed instead of throwing from the poll callback") {
+            bool closed{false};
+            REQUIRE_NOTHROW(closed = poll_until(poll_manager, [&events]() {
+                                return not events.empty() and events.back() == io::ConnectionEvent::CLOSED;
+                            }));
+            REQUIRE(closed);
+            REQUIRE(events.size() == 2);
+            REQUIRE(events[0] == io::ConnectionEvent::ACCEPTED);
+        }
+
+        close(fd);
+    }
+}
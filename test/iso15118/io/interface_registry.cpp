@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+
+#include <iso15118/detail/io/interface_registry.hpp>
+
+using namespace iso15118;
+
+namespace {
+// indices, which are not used by any real interface
+constexpr auto PLUGGED_INDEX = 100000;
+constexpr auto REPLUGGED_INDEX = 100001;
+constexpr auto INTERFACE_NAME = "plc_test0";
+
+// a buffer of rtnetlink messages, as it would be read from the netlink socket
+class NetlinkMessages {
+public:
+    void add_link(uint16_t type, int index, const std::string& name) {
+        const auto attribute_length = RTA_LENGTH(name.size() + 1);
+        const auto header = add_header(type, NLMSG_LENGTH(sizeof(ifinfomsg) + RTA_ALIGN(attribute_length)));
+
+        const auto info = static_cast<ifinfomsg*>(NLMSG_DATA(header));
+        info->ifi_family = AF_UNSPEC;
+        info->ifi_index = index;
+
+        const auto attribute = IFLA_RTA(info);
+        attribute->rta_type = IFLA_IFNAME;
+        attribute->rta_len = attribute_length;
+        std::memcpy(RTA_DATA(attribute), name.c_str(), name.size() + 1);
+    }
+
+    void add_address(uint16_t type, int index, const char* address) {
+        const auto attribute_length = RTA_LENGTH(sizeof(in6_addr));
+        const auto header = add_header(type, NLMSG_LENGTH(sizeof(ifaddrmsg) + RTA_ALIGN(attribute_length)));
+
+        const auto info = static_cast<ifaddrmsg*>(NLMSG_DATA(header));
+        info->ifa_family = AF_INET6;
+        info->ifa_prefixlen = 64;
+        info->ifa_index = index;
+
+        const auto attribute = IFA_RTA(info);
+        attribute->rta_type = IFA_ADDRESS;
+        attribute->rta_len = attribute_length;
+        REQUIRE(inet_pton(AF_INET6, address, RTA_DATA(attribute)) == 1);
+    }
+
+    const void* data() const {
+        return buffer;
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+
+private:
+    nlmsghdr* add_header(uint16_t type, uint32_t message_length) {
+        REQUIRE(length + NLMSG_ALIGN(message_length) <= sizeof(buffer));
+
+        const auto header = reinterpret_cast<nlmsghdr*>(buffer + length);
+        std::memset(header, 0, NLMSG_ALIGN(message_length));
+        header->nlmsg_len = message_length;
+        header->nlmsg_type = type;
+
+        length += NLMSG_ALIGN(message_length);
+        return header;
+    }
+
+    alignas(nlmsghdr) uint8_t buffer[1024];
+    std::size_t length{0};
+};
+} // namespace
+
+SCENARIO("Interface registry") {
+
+    io::InterfaceRegistry registry;
+
+    GIVEN("The loopback interface") {
+        THEN("Its index and (non link local) address are known") {
+            REQUIRE(registry.get_index("lo") == if_nametoindex("lo"));
+
+            const auto address = registry.get_address("lo");
+            REQUIRE(address.has_value());
+            REQUIRE(address->sin6_family == AF_INET6);
+            REQUIRE(std::memcmp(&address->sin6_addr, &in6addr_loopback, sizeof(in6_addr)) == 0);
+        }
+    }
+
+    GIVEN("An unknown interface") {
+        THEN("It is not found") {
+            REQUIRE(registry.get_index("does_not_exist0") == 0);
+            REQUIRE(registry.get_address("does_not_exist0").has_value() == false);
+        }
+    }
+
+    GIVEN("The interfaces reported by getifaddrs") {
+        struct ifaddrs* if_list_head;
+        REQUIRE(getifaddrs(&if_list_head) == 0);
+
+        THEN("All of them are cached with the same index and their link local addresses") {
+            for (auto current_if = if_list_head; current_if != nullptr; current_if = current_if->ifa_next) {
+                REQUIRE(registry.get_index(current_if->ifa_name) == if_nametoindex(current_if->ifa_name));
+
+                if (current_if->ifa_addr == nullptr or current_if->ifa_addr->sa_family != AF_INET6) {
+                    continue;
+                }
+
+                const auto current_addr = reinterpret_cast<const sockaddr_in6*>(current_if->ifa_addr);
+                if (IN6_IS_ADDR_LINKLOCAL(&current_addr->sin6_addr)) {
+                    const auto address = registry.get_address(current_if->ifa_name);
+                    REQUIRE(address.has_value());
+                    REQUIRE(IN6_IS_ADDR_LINKLOCAL(&address->sin6_addr));
+                    REQUIRE(address->sin6_scope_id == if_nametoindex(current_if->ifa_name));
+                }
+            }
+        }
+
+        freeifaddrs(if_list_head);
+    }
+
+    GIVEN("No changes of the interfaces") {
+        THEN("Handling the notifications doesn't block") {
+            registry.handle_events();
+            REQUIRE(registry.handle_events() == false);
+        }
+    }
+
+    GIVEN("A PLC interface, which is plugged in") {
+        NetlinkMessages messages;
+        messages.add_link(RTM_NEWLINK, PLUGGED_INDEX, INTERFACE_NAME);
+        messages.add_address(RTM_NEWADDR, PLUGGED_INDEX, "fe80::1");
+
+        REQUIRE(registry.handle_messages(messages.data(), messages.size()));
+
+        THEN("Its index and scoped link local address are known") {
+            REQUIRE(registry.get_index(INTERFACE_NAME) == PLUGGED_INDEX);
+
+            const auto address = registry.get_address(INTERFACE_NAME);
+            REQUIRE(address.has_value());
+            REQUIRE(IN6_IS_ADDR_LINKLOCAL(&address->sin6_addr));
+            REQUIRE(address->sin6_scope_id == PLUGGED_INDEX);
+        }
+
+        THEN("Repeated notifications don't change anything") {
+            REQUIRE(registry.handle_messages(messages.data(), messages.size()) == false);
+        }
+
+        AND_GIVEN("It is unplugged") {
+            NetlinkMessages unplug;
+            unplug.add_link(RTM_DELLINK, PLUGGED_INDEX, INTERFACE_NAME);
+
+            REQUIRE(registry.handle_messages(unplug.data(), unplug.size()));
+
+            THEN("It is not found anymore") {
+                REQUIRE(registry.get_index(INTERFACE_NAME) == 0);
+                REQUIRE(registry.get_address(INTERFACE_NAME).has_value() == false);
+            }
+
+            AND_GIVEN("It is plugged in again with a new index") {
+                NetlinkMessages replug;
+                replug.add_link(RTM_NEWLINK, REPLUGGED_INDEX, INTERFACE_NAME);
+                replug.add_address(RTM_NEWADDR, REPLUGGED_INDEX, "fe80::1");
+
+                REQUIRE(registry.handle_messages(replug.data(), replug.size()));
+
+                THEN("The same address is scoped to the new index") {
+                    REQUIRE(registry.get_index(INTERFACE_NAME) == REPLUGGED_INDEX);
+
+                    const auto address = registry.get_address(INTERFACE_NAME);
+                    REQUIRE(address.has_value());
+                    REQUIRE(address->sin6_scope_id == REPLUGGED_INDEX);
+                }
+            }
+        }
+
+        AND_GIVEN("It loses its address") {
+            NetlinkMessages remove_address;
+            remove_address.add_address(RTM_DELADDR, PLUGGED_INDEX, "fe80::1");
+
+            REQUIRE(registry.handle_messages(remove_address.data(), remove_address.size()));
+
+            THEN("The interface is known, but has no address") {
+                REQUIRE(registry.get_index(INTERFACE_NAME) == PLUGGED_INDEX);
+                REQUIRE(registry.get_address(INTERFACE_NAME).has_value() == false);
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <iso15118/io/connection_plain.hpp>
+#include <iso15118/io/listener.hpp>
+
+using namespace iso15118;
+
+namespace {
+// NOTE: the listener binds to the first ipv6 address of the loopback interface (::1)
+constexpr auto INTERFACE_NAME = "lo";
+constexpr uint16_t PORT = 50010;
+
+int connect_client(const io::Ipv6EndPoint& end_point) {
+    const auto fd = socket(AF_INET6, SOCK_STREAM, 0);
+    REQUIRE(fd != -1);
+
+    sockaddr_in6 address{};
+    address.sin6_family = AF_INET6;
+    address.sin6_port = htons(end_point.port);
+    std::memcpy(&address.sin6_addr, end_point.address, sizeof(address.sin6_addr));
+
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+    return fd;
+}
+
+int get_socket_option(int fd, int level, int option_name) {
+    int value{0};
+    socklen_t value_length = sizeof(value);
+    REQUIRE(getsockopt(fd, level, option_name, &value, &value_length) == 0);
+    return value;
+}
+
+std::size_t count_open_fds() {
+    return std::distance(std::filesystem::directory_iterator("/proc/self/fd"), std::filesystem::directory_iterator{});
+}
+} // namespace
+
+SCENARIO("Persistent listener") {
+
+    io::Listener listener(INTERFACE_NAME, PORT);
+    REQUIRE(listener.get_end_point().port == PORT);
+
+    GIVEN("No pending connection") {
+        THEN("Accept doesn't block") {
+            sockaddr_in6 peer_address;
+            REQUIRE(listener.accept(peer_address) == -1);
+        }
+    }
+
+    GIVEN("An accepted connection") {
+        const auto client_fd = connect_client(listener.get_end_point());
+
+        sockaddr_in6 peer_address;
+        const auto accept_fd = listener.accept(peer_address);
+        REQUIRE(accept_fd != -1);
+
+        THEN("The socket option profile is applied") {
+            REQUIRE(get_socket_option(accept_fd, IPPROTO_TCP, TCP_NODELAY) == 1);
+            REQUIRE(get_socket_option(accept_fd, SOL_SOCKET, SO_KEEPALIVE) == 1);
+            REQUIRE(get_socket_option(accept_fd, IPPROTO_TCP, TCP_USER_TIMEOUT) > 0);
+        }
+
+        ::close(accept_fd);
+        ::close(client_fd);
+    }
+
+    GIVEN("Consecutive connections") {
+        io::PollManager poll_manager;
+
+        THEN("Each one is accepted from the same listener") {
+            for (auto i = 0; i < 3; ++i) {
+                io::ConnectionPlain connection(poll_manager, listener);
+
+                std::vector<io::ConnectionEvent> events;
+                connection.set_event_callback([&events](io::ConnectionEvent event) { events.push_back(event); });
+
+                const auto client_fd = connect_client(connection.get_public_endpoint());
+                poll_manager.poll(1000);
+
+                REQUIRE(events.size() == 2);
+                REQUIRE(events[1] == io::ConnectionEvent::OPEN);
+
+                ::close(client_fd);
+            }
+        }
+    }
+}
+
+SCENARIO("Listener setup failure") {
+
+    GIVEN("A port, which is in use already") {
+        // neither SO_REUSEADDR nor SO_REUSEPORT, so the listener can't bind the port
+        const auto blocking_fd = socket(AF_INET6, SOCK_STREAM, 0);
+        REQUIRE(blocking_fd != -1);
+
+        sockaddr_in6 address{};
+        address.sin6_family = AF_INET6;
+        address.sin6_port = htons(PORT + 1);
+        address.sin6_addr = in6addr_loopback;
+        REQUIRE(bind(blocking_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        REQUIRE(listen(blocking_fd, 1) == 0);
+
+        THEN("The listener throws and doesn't leak its socket") {
+            const auto open_fds = count_open_fds();
+            REQUIRE_THROWS(io::Listener(INTERFACE_NAME, PORT + 1));
+            REQUIRE(count_open_fds() == open_fds);
+        }
+
+        ::close(blocking_fd);
+    }
+}
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+#include <unistd.h>
+
+#include <iso15118/io/poll_manager.hpp>
+
+using namespace iso15118;
+
+namespace {
+struct Pipe {
+    Pipe() {
+        REQUIRE(pipe(fds) == 0);
+    }
+
+    ~Pipe() {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    int read_end() const {
+        return fds[0];
+    }
+
+    int write_end() const {
+        return fds[1];
+    }
+
+    void put(char value = 'x') const {
+        REQUIRE(write(fds[1], &value, 1) == 1);
+    }
+
+    void drain() const {
+        char value;
+        REQUIRE(read(fds[0], &value, 1) == 1);
+    }
+
+private:
+    int fds[2];
+};
+} // namespace
+
+SCENARIO("PollManager") {
+
+    io::PollManager poll_manager;
+
+    GIVEN("A registered fd with pending input") {
+        Pipe pipe;
+        int call_count{0};
+
+        poll_manager.register_fd(pipe.read_end(), [&call_count]() { call_count++; });
+        pipe.put();
+
+        THEN("The callback is called as long as the input is pending (level triggered)") {
+            poll_manager.poll(0);
+            poll_manager.poll(0);
+            REQUIRE(call_count == 2);
+
+            pipe.drain();
+            poll_manager.poll(0);
+            REQUIRE(call_count == 2);
+        }
+
+        THEN("The callback is not called anymore after unregistering") {
+            poll_manager.unregister_fd(pipe.read_end());
+            poll_manager.poll(0);
+            REQUIRE(call_count == 0);
+        }
+    }
+
+    GIVEN("An edge triggered fd with pending input") {
+        Pipe pipe;
+        int call_count{0};
+
+        poll_manager.register_fd(
+            pipe.read_end(), [&call_count](short) { call_count++; }, POLLIN, io::PollTrigger::EDGE);
+        pipe.put();
+
+        THEN("The callback is only called once per edge") {
+            poll_manager.poll(0);
+            poll_manager.poll(0);
+            REQUIRE(call_count == 1);
+
+            pipe.put();
+            poll_manager.poll(0);
+            REQUIRE(call_count == 2);
+        }
+    }
+
+    GIVEN("A writable fd registered for POLLIN only") {
+        Pipe pipe;
+        short received_events{0};
+
+        poll_manager.register_fd(
+            pipe.write_end(), [&received_events](short revents) { received_events = revents; }, POLLIN);
+
+        THEN("Write readiness is reported only after POLLOUT has been requested") {
+            poll_manager.poll(0);
+            REQUIRE(received_events == 0);
+
+            poll_manager.modify_fd(pipe.write_end(), POLLOUT);
+            poll_manager.poll(0);
+            REQUIRE((received_events & POLLOUT) != 0);
+        }
+    }
+
+    GIVEN("Two ready fds, where the first callback unregisters the second one") {
+        Pipe first;
+        Pipe second;
+        int second_call_count{0};
+
+        poll_manager.register_fd(first.read_end(), [&]() {
+            first.drain();
+            poll_manager.unregister_fd(second.read_end());
+        });
+        poll_manager.register_fd(second.read_end(), [&second_call_count]() { second_call_count++; });
+
+        first.put();
+        second.put();
+
+        THEN("The stale ready event of the unregistered fd is not dispatched") {
+            poll_manager.poll(0);
+            // the order of the ready list is not defined, so the second callback might have been called first
+            REQUIRE(second_call_count <= 1);
+
+            poll_manager.poll(0);
+            REQUIRE(second_call_count <= 1);
+        }
+    }
+
+    GIVEN("An aborted poll manager") {
+        Pipe pipe;
+        int call_count{0};
+
+        poll_manager.register_fd(pipe.read_end(), [&call_count]() { call_count++; });
+        poll_manager.abort();
+
+        THEN("An unlimited poll returns immediately") {
+            poll_manager.poll(-1);
+            REQUIRE(call_count == 0);
+        }
+
+        THEN("Ready fds are still dispatched") {
+            pipe.put();
+            poll_manager.poll(-1);
+            REQUIRE(call_count == 1);
+        }
+    }
+
+    GIVEN("A timer and no fds") {
+        int call_count{0};
+        poll_manager.add_timer(20, [&call_count]() { call_count++; });
+
+        THEN("An unlimited poll returns when the timer is due") {
+            const auto start = std::chrono::steady_clock::now();
+            poll_manager.poll(-1);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            REQUIRE(call_count == 1);
+            REQUIRE(elapsed >= std::chrono::milliseconds(19));
+        }
+
+        THEN("A shorter poll timeout is kept") {
+            poll_manager.poll(0);
+            REQUIRE(call_count == 0);
+        }
+    }
+
+    GIVEN("A cancelled timer") {
+        int call_count{0};
+        const auto id = poll_manager.add_timer(0, [&call_count]() { call_count++; });
+        poll_manager.cancel_timer(id);
+
+        THEN("It is not called") {
+            poll_manager.poll(10);
+            REQUIRE(call_count == 0);
+        }
+    }
+}
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <iso15118/io/sdp_rate_limiter.hpp>
+
+using namespace iso15118;
+
+namespace {
+constexpr auto BURST = 3;
+constexpr auto INTERVAL = std::chrono::milliseconds(250);
+
+sockaddr_in6 make_peer(uint8_t last_byte, uint32_t scope_id = 1) {
+    sockaddr_in6 peer{};
+    peer.sin6_family = AF_INET6;
+    peer.sin6_addr.s6_addr[0] = 0xfe;
+    peer.sin6_addr.s6_addr[1] = 0x80;
+    peer.sin6_addr.s6_addr[15] = last_byte;
+    peer.sin6_scope_id = scope_id;
+    return peer;
+}
+
+int count_allowed(io::SdpRateLimiter& limiter, const sockaddr_in6& peer, const TimePoint& now, int requests) {
+    auto allowed = 0;
+    for (auto i = 0; i < requests; ++i) {
+        allowed += limiter.allow(peer, now) ? 1 : 0;
+    }
+    return allowed;
+}
+} // namespace
+
+SCENARIO("SDP rate limiting") {
+
+    io::SdpRateLimiter limiter(BURST, INTERVAL);
+    const auto start = get_current_time_point();
+    const auto peer = make_peer(1);
+
+    GIVEN("A burst of requests") {
+        THEN("Only the burst size is allowed") {
+            REQUIRE(count_allowed(limiter, peer, start, 10) == BURST);
+        }
+    }
+
+    GIVEN("A peer, which used up its tokens") {
+        count_allowed(limiter, peer, start, BURST);
+
+        THEN("A token is added every interval") {
+            REQUIRE(limiter.allow(peer, start + INTERVAL / 2) == false);
+            REQUIRE(limiter.allow(peer, start + INTERVAL) == true);
+            REQUIRE(limiter.allow(peer, start + INTERVAL * 3 / 2) == false);
+            REQUIRE(limiter.allow(peer, start + INTERVAL * 2) == true);
+        }
+
+        THEN("The tokens are refilled up to the burst size") {
+            REQUIRE(count_allowed(limiter, peer, start + INTERVAL * 100, 10) == BURST);
+        }
+    }
+
+    GIVEN("An EV, which retries every interval") {
+        THEN("All retries are allowed") {
+            REQUIRE(count_allowed(limiter, peer, start, 1) == 1);
+            for (auto i = 1; i < 50; ++i) {
+                REQUIRE(limiter.allow(peer, start + INTERVAL * i));
+            }
+        }
+    }
+
+    GIVEN("A flooding peer") {
+        count_allowed(limiter, peer, start, 10);
+
+        THEN("Other peers are not affected") {
+            REQUIRE(count_allowed(limiter, make_peer(2), start, BURST) == BURST);
+            REQUIRE(count_allowed(limiter, make_peer(1, 2), start, BURST) == BURST);
+        }
+    }
+
+    GIVEN("More peers than tracked") {
+        count_allowed(limiter, peer, start, BURST);
+
+        for (std::size_t i = 0; i < io::SdpRateLimiter::MAX_TRACKED_PEERS; ++i) {
+            limiter.allow(make_peer(10 + i), start + std::chrono::milliseconds(1));
+        }
+
+        THEN("The least recently seen peer is forgotten") {
+            REQUIRE(limiter.allow(peer, start + std::chrono::milliseconds(2)));
+        }
+    }
+}
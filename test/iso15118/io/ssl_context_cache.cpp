@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <iso15118/detail/io/ssl_context_cache.hpp>
+
+using namespace iso15118;
+
+namespace {
+struct TemporaryDirectory {
+    TemporaryDirectory() {
+        char path_template[] = "/tmp/iso15118_ssl_context_cache_XXXXXX";
+        REQUIRE(mkdtemp(path_template) != nullptr);
+        path = path_template;
+    }
+
+    ~TemporaryDirectory() {
+        std::filesystem::remove_all(path);
+    }
+
+    std::filesystem::path path;
+};
+
+void write_file(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream ofs(path);
+    ofs << content;
+}
+} // namespace
+
+SCENARIO("SSL context cache") {
+
+    TemporaryDirectory directory;
+    const auto chain_path = directory.path / "chain.pem";
+    write_file(chain_path, "chain");
+
+    config::SSLConfig ssl_config{};
+    ssl_config.path_certificate_chain = chain_path;
+    ssl_config.path_certificate_key = directory.path / "key.pem";
+
+    int build_count{0};
+    bool fail_build{false};
+    const io::SSLContextCache::Builder builder = [&](const config::SSLConfig&) -> SSL_CTX* {
+        if (fail_build) {
+            throw std::runtime_error("Failed to build");
+        }
+        build_count++;
+        return SSL_CTX_new(TLS_server_method());
+    };
+
+    io::SSLContextCache cache;
+    const auto ctx = cache.get(ssl_config, builder);
+    REQUIRE(ctx != nullptr);
+
+    GIVEN("The same config") {
+        THEN("The context is only built once") {
+            REQUIRE(cache.get(ssl_config, builder) == ctx);
+            REQUIRE(build_count == 1);
+        }
+    }
+
+    GIVEN("A different config") {
+        auto other_config = ssl_config;
+        other_config.enforce_tls_1_3 = true;
+
+        THEN("Another context is built") {
+            REQUIRE(cache.get(other_config, builder) != ctx);
+            REQUIRE(build_count == 2);
+        }
+    }
+
+    GIVEN("A changed certificate file") {
+        write_file(chain_path, "new chain");
+
+        THEN("The context is rebuilt once, while the previous one stays valid") {
+            const auto new_ctx = cache.get(ssl_config, builder);
+            REQUIRE(new_ctx != ctx);
+            REQUIRE(build_count == 2);
+            REQUIRE(SSL_CTX_get_timeout(ctx.get()) > 0);
+
+            REQUIRE(cache.get(ssl_config, builder) == new_ctx);
+            REQUIRE(build_count == 2);
+        }
+    }
+
+    GIVEN("A certificate file, which is replaced by a rename") {
+        const auto temporary_path = directory.path / "key.pem.tmp";
+        write_file(temporary_path, "key");
+        std::filesystem::rename(temporary_path, directory.path / "key.pem");
+
+        THEN("The context is rebuilt") {
+            REQUIRE(cache.get(ssl_config, builder) != ctx);
+        }
+    }
+
+    GIVEN("A changed certificate file, which can't be loaded") {
+        write_file(chain_path, "broken chain");
+        fail_build = true;
+
+        THEN("The previous context is kept") {
+            REQUIRE(cache.get(ssl_config, builder) == ctx);
+        }
+
+        THEN("The reload is retried on the next lookup, without another change of the file") {
+            REQUIRE(cache.get(ssl_config, builder) == ctx);
+
+            fail_build = false;
+            const auto new_ctx = cache.get(ssl_config, builder);
+            REQUIRE(new_ctx != ctx);
+            REQUIRE(build_count == 2);
+
+            REQUIRE(cache.get(ssl_config, builder) == new_ctx);
+            REQUIRE(build_count == 2);
+        }
+    }
+
+    GIVEN("A change of an unrelated file") {
+        write_file(directory.path / "unrelated.pem", "unrelated");
+
+        THEN("The context is not rebuilt") {
+            REQUIRE(cache.get(ssl_config, builder) == ctx);
+            REQUIRE(build_count == 1);
+        }
+    }
+}
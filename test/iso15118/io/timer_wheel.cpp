@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include <iso15118/io/timer_wheel.hpp>
+
+using namespace iso15118;
+
+SCENARIO("Timer wheel") {
+
+    io::TimerWheel wheel(1000);
+
+    GIVEN("An empty timer wheel") {
+        THEN("There is no timeout") {
+            REQUIRE(wheel.empty());
+            REQUIRE(wheel.get_timeout() == std::nullopt);
+        }
+    }
+
+    GIVEN("A timer on the lowest wheel") {
+        int called{0};
+        wheel.add(1010, [&called]() { called++; });
+
+        THEN("The timeout is exact") {
+            REQUIRE(wheel.get_timeout() == 10);
+        }
+
+        THEN("It doesn't expire too early") {
+            wheel.update(1009);
+            REQUIRE(wheel.expire() == 0);
+            REQUIRE(called == 0);
+        }
+
+        THEN("It expires on time") {
+            wheel.update(1010);
+            REQUIRE(wheel.expire() == 1);
+            REQUIRE(called == 1);
+            REQUIRE(wheel.empty());
+        }
+    }
+
+    GIVEN("A timer on a higher wheel") {
+        int called{0};
+        wheel.add(1000 + 60000, [&called]() { called++; });
+
+        THEN("The timeout is never later than the expiry") {
+            const auto timeout = wheel.get_timeout();
+            REQUIRE(timeout.has_value());
+            REQUIRE(*timeout <= 60000);
+        }
+
+        THEN("Following the timeouts expires it on time") {
+            uint64_t now = 1000;
+            while (called == 0) {
+                now += *wheel.get_timeout();
+                wheel.update(now);
+                wheel.expire();
+            }
+            REQUIRE(now == 61000);
+        }
+
+        THEN("Jumping over it expires it") {
+            wheel.update(1000000);
+            REQUIRE(wheel.expire() == 1);
+        }
+    }
+
+    GIVEN("A cancelled timer") {
+        int called{0};
+        const auto id = wheel.add(1020, [&called]() { called++; });
+
+        REQUIRE(wheel.cancel(id));
+
+        THEN("It is not called") {
+            REQUIRE(wheel.empty());
+            REQUIRE(wheel.get_timeout() == std::nullopt);
+            wheel.update(2000);
+            REQUIRE(wheel.expire() == 0);
+            REQUIRE(called == 0);
+            REQUIRE(wheel.cancel(id) == false);
+        }
+    }
+
+    GIVEN("A timer which re-arms itself") {
+        int called{0};
+        io::TimerCallback callback = [&]() {
+            called++;
+            wheel.add(wheel.get_current_time(), callback);
+        };
+        wheel.add(1000, callback);
+
+        THEN("The re-armed timer is called on the next expire only") {
+            REQUIRE(wheel.expire() == 1);
+            REQUIRE(wheel.expire() == 1);
+            REQUIRE(called == 2);
+        }
+    }
+
+    GIVEN("Many random timers") {
+        std::mt19937 generator(15118);
+        std::uniform_int_distribution<uint64_t> timeout_distribution(0, 100000);
+        std::uniform_int_distribution<uint64_t> step_distribution(0, 5000);
+
+        std::multimap<uint64_t, int> reference;
+        std::vector<std::pair<uint64_t, uint64_t>> fired; // expected expiry, actual time
+        uint64_t now = 1000;
+
+        for (auto i = 0; i < 2000; ++i) {
+            const auto expires = now + timeout_distribution(generator);
+            reference.emplace(expires, i);
+            wheel.add(expires, [&fired, &now, expires]() { fired.emplace_back(expires, now); });
+        }
+
+        while (not wheel.empty()) {
+            const auto timeout = wheel.get_timeout();
+            REQUIRE(timeout.has_value());
+
+            // never sleep beyond the next expiry
+            REQUIRE(now + *timeout <= reference.begin()->first);
+
+            // advance either to the next timeout or by a random step
+            now += std::min(*timeout, step_distribution(generator));
+            wheel.update(now);
+            wheel.expire();
+
+            while (not reference.empty() and reference.begin()->first <= now) {
+                reference.erase(reference.begin());
+            }
+
+            REQUIRE(fired.size() + reference.size() == 2000);
+        }
+
+        THEN("All timers fired on the first update after their expiry") {
+            REQUIRE(reference.empty());
+            for (const auto& [expires, when] : fired) {
+                REQUIRE(expires <= when);
+            }
+        }
+    }
+}
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <iso15118/detail/io/tls_key_log_writer.hpp>
+
+using namespace iso15118;
+
+namespace {
+struct TemporaryDirectory {
+    TemporaryDirectory() {
+        char path_template[] = "/tmp/iso15118_tls_key_log_writer_XXXXXX";
+        REQUIRE(mkdtemp(path_template) != nullptr);
+        path = path_template;
+    }
+
+    ~TemporaryDirectory() {
+        std::filesystem::remove_all(path);
+    }
+
+    std::filesystem::path path;
+};
+
+std::vector<std::string> read_lines(const std::filesystem::path& path) {
+    std::vector<std::string> lines;
+    std::ifstream ifs(path);
+    for (std::string line; std::getline(ifs, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::string make_line(int producer, int index) {
+    return "CLIENT_RANDOM " + std::to_string(producer) + " " + std::to_string(index);
+}
+} // namespace
+
+SCENARIO("TLS key log writer") {
+
+    TemporaryDirectory directory;
+    const auto file_path = directory.path / "tls_session_keys.log";
+
+    GIVEN("Lines of a single handshake") {
+        {
+            io::TlsKeyLogWriter writer;
+            for (auto i = 0; i < 5; ++i) {
+                REQUIRE(writer.push(make_line(0, i).c_str(), directory.path, nullptr));
+            }
+        }
+
+        THEN("They are appended in order") {
+            const auto lines = read_lines(file_path);
+            REQUIRE(lines.size() == 5);
+            for (auto i = 0; i < 5; ++i) {
+                REQUIRE(lines[i] == make_line(0, i));
+            }
+        }
+    }
+
+    GIVEN("Lines, which are written in another batch") {
+        io::TlsKeyLogWriter writer;
+        REQUIRE(writer.push(make_line(0, 0).c_str(), directory.path, nullptr));
+
+        std::this_thread::sleep_for(io::TlsKeyLogWriter::FLUSH_INTERVAL * 3);
+
+        THEN("The file is flushed after the batch, while it is kept open") {
+            REQUIRE(read_lines(file_path) == std::vector<std::string>{make_line(0, 0)});
+        }
+    }
+
+    GIVEN("Lines from concurrent handshakes") {
+        constexpr auto PRODUCERS = 4;
+        constexpr auto LINES_PER_PRODUCER = 50;
+
+        uint64_t dropped_lines{0};
+        {
+            io::TlsKeyLogWriter writer;
+            std::vector<std::thread> producers;
+            for (auto producer = 0; producer < PRODUCERS; ++producer) {
+                producers.emplace_back([&writer, &directory, producer]() {
+                    for (auto i = 0; i < LINES_PER_PRODUCER; ++i) {
+                        writer.push(make_line(producer, i).c_str(), directory.path, nullptr);
+                    }
+                });
+            }
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            dropped_lines = writer.get_dropped_lines();
+        }
+
+        THEN("All lines are written and the lines of each handshake stay in order") {
+            REQUIRE(dropped_lines == 0);
+
+            const auto lines = read_lines(file_path);
+            REQUIRE(lines.size() == PRODUCERS * LINES_PER_PRODUCER);
+
+            std::vector<int> next_index(PRODUCERS, 0);
+            for (const auto& line : lines) {
+                const auto producer = line.at(14) - '0';
+                REQUIRE(line == make_line(producer, next_index[producer]++));
+            }
+        }
+    }
+
+    GIVEN("A line, which is too long") {
+        io::TlsKeyLogWriter writer;
+        const std::string line(io::TlsKeyLogWriter::MAX_LINE_LENGTH, 'a');
+
+        THEN("It is dropped") {
+            REQUIRE(writer.push(line.c_str(), directory.path, nullptr) == false);
+            REQUIRE(writer.get_dropped_lines() == 1);
+        }
+    }
+}
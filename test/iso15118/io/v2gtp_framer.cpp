@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <iso15118/io/sdp_packet.hpp>
+#include <iso15118/io/v2gtp_framer.hpp>
+
+using namespace iso15118;
+
+namespace {
+// connection, which returns the stream in chunks of at most max_chunk_size bytes per read
+struct StreamConnection : public io::IConnection {
+    void set_event_callback(const io::ConnectionEventCallback&) override {
+    }
+
+    io::Ipv6EndPoint get_public_endpoint() const override {
+        return {};
+    }
+
+    void write(const uint8_t*, size_t) override {
+    }
+
+    io::ReadResult read(uint8_t* buf, size_t len) override {
+        read_count++;
+        const auto count = std::min({len, max_chunk_size, stream.size() - position});
+        std::memcpy(buf, stream.data() + position, count);
+        position += count;
+        return {count < len, count};
+    }
+
+    void close() override {
+    }
+
+    std::optional<io::sha512_hash_t> get_vehicle_cert_hash() const override {
+        return std::nullopt;
+    }
+
+    void append_frame(uint16_t payload_type, const std::vector<uint8_t>& payload) {
+        stream.push_back(io::SDP_PROTOCOL_VERSION);
+        stream.push_back(io::SDP_INVERSE_PROTOCOL_VERSION);
+        stream.push_back(payload_type >> 8);
+        stream.push_back(payload_type & 0xff);
+        const auto length = static_cast<uint32_t>(payload.size());
+        for (auto shift : {24, 16, 8, 0}) {
+            stream.push_back((length >> shift) & 0xff);
+        }
+        stream.insert(stream.end(), payload.begin(), payload.end());
+    }
+
+    std::vector<uint8_t> stream;
+    size_t position{0};
+    size_t max_chunk_size{static_cast<size_t>(-1)};
+    int read_count{0};
+};
+} // namespace
+
+SCENARIO("V2GTP framer") {
+
+    StreamConnection connection;
+    io::V2gtpFramer framer;
+
+    GIVEN("Two frames, which arrived back to back") {
+        connection.append_frame(0x8001, {0x01, 0x02, 0x03});
+        connection.append_frame(0x8002, {0x04});
+
+        THEN("Both are extracted in order with a single read") {
+            REQUIRE(framer.read(connection).would_block);
+            REQUIRE(connection.read_count == 1);
+
+            const auto first = framer.next_frame();
+            REQUIRE(first.has_value());
+            REQUIRE(first->payload_type == io::v2gtp::PayloadType::SAP);
+            REQUIRE(first->payload_length == 3);
+            REQUIRE(first->payload[2] == 0x03);
+
+            const auto second = framer.next_frame();
+            REQUIRE(second.has_value());
+            REQUIRE(second->payload_type == io::v2gtp::PayloadType::Part20Main);
+            REQUIRE(second->payload_length == 1);
+            REQUIRE(second->payload[0] == 0x04);
+
+            REQUIRE(framer.next_frame() == std::nullopt);
+            REQUIRE(framer.get_buffered_bytes() == 0);
+        }
+    }
+
+    GIVEN("A frame, which arrives in small chunks") {
+        connection.append_frame(0x8004, std::vector<uint8_t>(100, 0xaa));
+        connection.max_chunk_size = 7;
+
+        THEN("It is only handed out once complete") {
+            auto reads = 0;
+            std::optional<io::V2gtpFrame> frame;
+
+            while (not frame) {
+                framer.read(connection);
+                reads++;
+                frame = framer.next_frame();
+            }
+
+            REQUIRE(reads == (100 + io::SdpPacket::V2GTP_HEADER_SIZE + 6) / 7);
+            REQUIRE(frame->payload_length == 100);
+            REQUIRE(frame->payload[99] == 0xaa);
+        }
+    }
+
+    GIVEN("Many frames of maximum size") {
+        const auto payload_size = io::V2gtpFramer::MAX_FRAME_SIZE - io::SdpPacket::V2GTP_HEADER_SIZE;
+        for (auto i = 0; i < 20; ++i) {
+            connection.append_frame(0x8002, std::vector<uint8_t>(payload_size, i));
+        }
+        connection.max_chunk_size = 3000;
+
+        THEN("Incomplete frames are moved within the buffer without losing data") {
+            auto frame_count = 0;
+
+            while (connection.position < connection.stream.size() or framer.get_buffered_bytes() > 0) {
+                framer.read(connection);
+                while (const auto frame = framer.next_frame()) {
+                    REQUIRE(frame->payload_length == payload_size);
+                    REQUIRE(frame->payload[0] == frame_count);
+                    REQUIRE(frame->payload[payload_size - 1] == frame_count);
+                    frame_count++;
+                }
+            }
+
+            REQUIRE(frame_count == 20);
+        }
+    }
+
+    GIVEN("A stream with an invalid header") {
+        connection.stream = {0x02, 0xFD, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00};
+
+        THEN("Getting the frame throws") {
+            framer.read(connection);
+            REQUIRE_THROWS(framer.next_frame());
+        }
+    }
+
+    GIVEN("A frame, which is too large") {
+        connection.append_frame(0x8002, std::vector<uint8_t>(io::V2gtpFramer::MAX_FRAME_SIZE, 0));
+
+        THEN("Getting the frame throws") {
+            framer.read(connection);
+            REQUIRE_THROWS(framer.next_frame());
+        }
+    }
+}
@@ -22,6 +22,21 @@ using Scheduled_BPT_DC_Res = message_20::datatypes::BPT_Scheduled_DC_CLResContro
 using Dynamic_DC_Res = message_20::datatypes::Dynamic_DC_CLResControlMode;
 using Dynamic_BPT_DC_Res = message_20::datatypes::BPT_Dynamic_DC_CLResControlMode;
 
+namespace {
+// the state writes the response into the document, read it back for the checks
+message_20::DC_ChargeLoopResponse handle_request(const message_20::DC_ChargeLoopRequest& req,
+                                                 const d20::Session& session, float present_voltage,
+                                                 float present_current, bool stop,
+                                                 const d20::DcTransferLimits& dc_limits,
+                                                 const d20::UpdateDynamicModeParameters& dynamic_parameters) {
+    message_20::ResponseDocuments documents;
+    auto res = documents.create_builder<message_20::DC_ChargeLoopResponseBuilder>();
+    d20::state::handle_charge_loop_request(req, session, present_voltage, present_current, stop, dc_limits,
+                                           dynamic_parameters, res);
+    return res.get();
+}
+} // namespace
+
 SCENARIO("DC charge loop state handling") {
 
     const auto evse_id = std::string("everest se");
@@ -63,8 +78,8 @@ SCENARIO("DC charge loop state handling") {
         req.meter_info_requested = false;
         req.present_voltage = {330, 0};
 
-        const auto res = d20::state::handle_request(req, d20::Session(), 330, 30, false, evse_setup.dc_limits,
-                                                    d20::UpdateDynamicModeParameters());
+        const auto res = handle_request(req, d20::Session(), 330, 30, false, evse_setup.dc_limits,
+                                        d20::UpdateDynamicModeParameters());
 
         THEN("ResponseCode: FAILED_UnknownSession, mandatory fields should be set") {
             REQUIRE(res.response_code == dt::ResponseCode::FAILED_UnknownSession);
@@ -97,8 +112,8 @@ SCENARIO("DC charge loop state handling") {
         req.meter_info_requested = false;
         req.present_voltage = {330, 0};
 
-        const auto res = d20::state::handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
-                                                    d20::UpdateDynamicModeParameters());
+        const auto res = handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
+                                        d20::UpdateDynamicModeParameters());
 
         THEN("ResponseCode: FAILED, mandatory fields should be set") {
             REQUIRE(res.response_code == dt::ResponseCode::FAILED);
@@ -130,8 +145,8 @@ SCENARIO("DC charge loop state handling") {
         req.meter_info_requested = false;
         req.present_voltage = {330, 0};
 
-        const auto res = d20::state::handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
-                                                    d20::UpdateDynamicModeParameters());
+        const auto res = handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
+                                        d20::UpdateDynamicModeParameters());
 
         THEN("ResponseCode: FAILED, mandatory fields should be set") {
             REQUIRE(res.response_code == dt::ResponseCode::FAILED);
@@ -163,8 +178,8 @@ SCENARIO("DC charge loop state handling") {
         req.meter_info_requested = false;
         req.present_voltage = {330, 0};
 
-        const auto res = d20::state::handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
-                                                    d20::UpdateDynamicModeParameters());
+        const auto res = handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
+                                        d20::UpdateDynamicModeParameters());
 
         THEN("ResponseCode: OK, mandatory fields should be set") {
             REQUIRE(res.response_code == dt::ResponseCode::OK);
@@ -206,8 +221,8 @@ SCENARIO("DC charge loop state handling") {
         req.meter_info_requested = false;
         req.present_voltage = {330, 0};
 
-        const auto res = d20::state::handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
-                                                    d20::UpdateDynamicModeParameters());
+        const auto res = handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
+                                        d20::UpdateDynamicModeParameters());
 
         THEN("ResponseCode: OK, mandatory fields should be set") {
             REQUIRE(res.response_code == dt::ResponseCode::OK);
@@ -259,8 +274,8 @@ SCENARIO("DC charge loop state handling") {
         req.meter_info_requested = false;
         req.present_voltage = {330, 0};
 
-        const auto res = d20::state::handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
-                                                    d20::UpdateDynamicModeParameters());
+        const auto res = handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
+                                        d20::UpdateDynamicModeParameters());
 
         THEN("ResponseCode: OK, mandatory fields should be set") {
             REQUIRE(res.response_code == dt::ResponseCode::OK);
@@ -307,8 +322,8 @@ SCENARIO("DC charge loop state handling") {
         req.meter_info_requested = false;
         req.present_voltage = {330, 0};
 
-        const auto res = d20::state::handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
-                                                    d20::UpdateDynamicModeParameters());
+        const auto res = handle_request(req, session, 330, 30, false, evse_setup.dc_limits,
+                                        d20::UpdateDynamicModeParameters());
 
         THEN("ResponseCode: OK, mandatory fields should be set") {
             REQUIRE(res.response_code == dt::ResponseCode::OK);
@@ -356,8 +371,7 @@ SCENARIO("DC charge loop state handling") {
 
         const d20::UpdateDynamicModeParameters dynamic_parameters = {std::time(nullptr) + 60, 95, std::nullopt};
 
-        const auto res =
-            d20::state::handle_request(req, session, 330, 30, false, evse_setup.dc_limits, dynamic_parameters);
+        const auto res = handle_request(req, session, 330, 30, false, evse_setup.dc_limits, dynamic_parameters);
 
         THEN("ResponseCode: OK, mandatory fields should be set") {
             REQUIRE(res.response_code == dt::ResponseCode::OK);
@@ -409,8 +423,7 @@ SCENARIO("DC charge loop state handling") {
 
         const d20::UpdateDynamicModeParameters dynamic_parameters = {std::time(nullptr) + 40, std::nullopt, 95};
 
-        const auto res =
-            d20::state::handle_request(req, session, 330, 30, false, evse_setup.dc_limits, dynamic_parameters);
+        const auto res = handle_request(req, session, 330, 30, false, evse_setup.dc_limits, dynamic_parameters);
 
         THEN("ResponseCode: OK, mandatory fields should be set") {
             REQUIRE(res.response_code == dt::ResponseCode::OK);
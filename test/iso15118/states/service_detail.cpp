@@ -309,8 +309,8 @@ SCENARIO("Service detail state handling") {
 
             // Protocol == HTTP
             REQUIRE(parameters.parameter[0].name == "Protocol");
-            REQUIRE(std::holds_alternative<std::string>(parameters.parameter[0].value));
-            REQUIRE(std::get<std::string>(parameters.parameter[0].value) == "http");
+            REQUIRE(std::holds_alternative<dt::Name>(parameters.parameter[0].value));
+            REQUIRE(std::get<dt::Name>(parameters.parameter[0].value) == "http");
             // Port == 80
             REQUIRE(parameters.parameter[1].name == "Port");
             REQUIRE(std::holds_alternative<int32_t>(parameters.parameter[1].value));
@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Pionix GmbH and Contributors to EVerest
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <iso15118/detail/io/interface_registry.hpp>
+#include <iso15118/tbd_controller.hpp>
+
+using namespace iso15118;
+namespace dt = message_20::datatypes;
+
+namespace {
+
+// V2GTP header (SAP payload type) + SupportedAppProtocolReq
+const uint8_t SAP_REQUEST_FRAME[] = {0x01, 0xfe, 0x80, 0x01, 0x00, 0x00, 0x00, 0x25, 0x80, 0x00, 0xf3, 0xab, 0x93,
+                                     0x71, 0xd3, 0x4b, 0x9b, 0x79, 0xd3, 0x9b, 0xa3, 0x21, 0xd3, 0x4b, 0x9b, 0x79,
+                                     0xd1, 0x89, 0xa9, 0x89, 0x89, 0xc1, 0xd1, 0x69, 0x91, 0x81, 0xd2, 0x0a, 0x18,
+                                     0x01, 0x00, 0x00, 0x04, 0x00, 0x40};
+
+const uint8_t INVALID_FRAME[] = {0x02, 0x02, 0x80, 0x01, 0x00, 0x00, 0x00, 0x01};
+
+constexpr auto PKI_PASSWORD = "123456";
+constexpr auto TIMEOUT = std::chrono::seconds(5);
+
+// records the feedback of one connector, the callbacks are called from the loop thread
+struct ConnectorFeedback {
+    std::mutex mutex;
+    std::vector<message_20::Type> messages;
+    std::vector<session::feedback::Signal> signals;
+
+    session::feedback::Callbacks get_callbacks() {
+        session::feedback::Callbacks callbacks;
+        callbacks.v2g_message = [this](const message_20::Type& type) {
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.push_back(type);
+        };
+        callbacks.signal = [this](session::feedback::Signal signal) {
+            std::lock_guard<std::mutex> lock(mutex);
+            signals.push_back(signal);
+        };
+        return callbacks;
+    }
+
+    bool wait_for_signal(session::feedback::Signal signal) {
+        const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (std::find(signals.begin(), signals.end(), signal) != signals.end()) {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+};
+
+// runs the loop of the controller, stops and joins it at the latest when going out of scope, so a failing REQUIRE
+// doesn't unwind past a joinable thread
+class LoopThread {
+public:
+    explicit LoopThread(TbdController& controller_) : controller(controller_) {
+        thread = std::thread([this]() { controller.loop(); });
+    }
+
+    ~LoopThread() {
+        stop();
+    }
+
+    void stop() {
+        if (thread.joinable()) {
+            controller.stop();
+            thread.join();
+        }
+    }
+
+private:
+    TbdController& controller;
+    std::thread thread;
+};
+
+d20::EvseSetupConfig make_evse_setup(const std::string& evse_id) {
+    const std::vector<dt::ServiceCategory> supported_energy_services = {dt::ServiceCategory::DC};
+    const std::vector<dt::Authorization> auth_services = {dt::Authorization::EIM};
+    const std::vector<d20::ControlMobilityNeedsModes> control_mobility_modes = {
+        {dt::ControlMode::Scheduled, dt::MobilityNeedsMode::ProvidedByEvcc}};
+
+    return {evse_id, supported_energy_services, auth_services, false, d20::DcTransferLimits{}, control_mobility_modes};
+}
+
+config::SSLConfig make_ssl_config() {
+    config::SSLConfig ssl_config{};
+    ssl_config.path_certificate_chain = "pki/certs/client/cso/CPO_CERT_CHAIN.pem";
+    ssl_config.path_certificate_key = "pki/certs/client/cso/SECC_LEAF.key";
+    ssl_config.private_key_password = PKI_PASSWORD;
+    ssl_config.path_certificate_v2g_root = "pki/certs/ca/v2g/V2G_ROOT_CA.pem";
+    ssl_config.path_certificate_mo_root = "pki/certs/ca/oem/OEM_ROOT_CA.pem";
+    return ssl_config;
+}
+
+void set_receive_timeout(int fd) {
+    // the test fails instead of hanging, if the controller doesn't answer
+    timeval timeout{TIMEOUT.count(), 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+}
+
+sockaddr_in6 get_interface_address(const std::string& interface_name) {
+    const auto address = io::InterfaceRegistry::get_instance().get_address(interface_name);
+    REQUIRE(address.has_value());
+    return *address;
+}
+
+int connect_client(const sockaddr_in6& peer_address) {
+    const auto fd = socket(AF_INET6, SOCK_STREAM, 0);
+    REQUIRE(fd != -1);
+
+    set_receive_timeout(fd);
+
+    REQUIRE(connect(fd, reinterpret_cast<const sockaddr*>(&peer_address), sizeof(peer_address)) == 0);
+
+    return fd;
+}
+
+int connect_client(const std::string& interface_name) {
+    auto peer_address = get_interface_address(interface_name);
+    peer_address.sin6_port = htons(io::TCP_LISTENER_PORT);
+
+    return connect_client(peer_address);
+}
+
+// sends an SDP request to the interface and returns the offered endpoint, if there is an answer
+std::optional<sockaddr_in6> request_endpoint(const std::string& interface_name, io::v2gtp::Security security) {
+    auto peer_address = get_interface_address(interface_name);
+    peer_address.sin6_port = htons(io::v2gtp::SDP_SERVER_PORT);
+
+    const auto fd = socket(AF_INET6, SOCK_DGRAM, 0);
+    REQUIRE(fd != -1);
+    set_receive_timeout(fd);
+
+    const uint8_t request[] = {0x01, 0xfe, 0x90, 0x00, 0x00, 0x00, 0x00, 0x02, static_cast<uint8_t>(security), 0x00};
+    const auto send_result =
+        sendto(fd, request, sizeof(request), 0, reinterpret_cast<const sockaddr*>(&peer_address), sizeof(peer_address));
+
+    // header, address, port, security and transport protocol
+    uint8_t response[28];
+    const auto receive_result = recv(fd, response, sizeof(response), 0);
+    close(fd);
+
+    REQUIRE(send_result == static_cast<ssize_t>(sizeof(request)));
+    if (receive_result == -1) {
+        return std::nullopt;
+    }
+    REQUIRE(receive_result == static_cast<ssize_t>(sizeof(response)));
+
+    auto end_point = peer_address;
+    std::memcpy(&end_point.sin6_addr, response + 8, sizeof(end_point.sin6_addr));
+    std::memcpy(&end_point.sin6_port, response + 24, sizeof(end_point.sin6_port));
+
+    return end_point;
+}
+
+sockaddr_in6 discover_endpoint(const std::string& interface_name, io::v2gtp::Security security) {
+    const auto end_point = request_endpoint(interface_name, security);
+    REQUIRE(end_point.has_value());
+    return *end_point;
+}
+
+bool is_connection_open(int fd) {
+    uint8_t buffer[1];
+    return recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT) == -1 and (errno == EAGAIN or errno == EWOULDBLOCK);
+}
+
+// returns the number of received bytes (0 if the connection got closed)
+ssize_t send_and_receive(int fd, const uint8_t* frame, size_t frame_length) {
+    REQUIRE(send(fd, frame, frame_length, MSG_NOSIGNAL) == static_cast<ssize_t>(frame_length));
+
+    uint8_t buffer[1024];
+    return recv(fd, buffer, sizeof(buffer), 0);
+}
+
+} // namespace
+
+// NOTE: tagged, as it binds the fixed listener ports and needs a second network interface (see CMakeLists.txt)
+SCENARIO("TbdController with several connectors", "[network]") {
+
+    // NOTE: every connector needs its own interface, the second one is any interface with a link local address
+    const auto second_interface = io::InterfaceRegistry::get_instance().find_first_link_local_interface();
+    if (second_interface.empty()) {
+        SKIP("No second interface with an ipv6 link local address available");
+    }
+
+    ConnectorFeedback feedback_a;
+    ConnectorFeedback feedback_b;
+
+    std::vector<TbdConnectorConfig> connector_configs;
+    connector_configs.push_back({"lo", feedback_a.get_callbacks(), make_evse_setup("DE*PNX*E1")});
+    connector_configs.push_back({second_interface, feedback_b.get_callbacks(), make_evse_setup("DE*PNX*E2")});
+
+    TbdConfig config;
+    config.enable_sdp_server = false;
+
+    TbdController controller(config, std::move(connector_configs));
+    REQUIRE(controller.get_connector_count() == 2);
+
+    LoopThread loop_thread(controller);
+
+    GIVEN("A request on each connector") {
+        const auto client_a = connect_client("lo");
+        const auto client_b = connect_client(second_interface);
+
+        REQUIRE(send_and_receive(client_a, SAP_REQUEST_FRAME, sizeof(SAP_REQUEST_FRAME)) > 0);
+        REQUIRE(send_and_receive(client_b, SAP_REQUEST_FRAME, sizeof(SAP_REQUEST_FRAME)) > 0);
+
+        loop_thread.stop();
+
+        THEN("Each connector has its own session and callbacks") {
+            REQUIRE(feedback_a.messages.size() == 2);
+            REQUIRE(feedback_a.messages[0] == message_20::Type::SupportedAppProtocolReq);
+            REQUIRE(feedback_b.messages.size() == 2);
+            REQUIRE(feedback_b.messages[0] == message_20::Type::SupportedAppProtocolReq);
+        }
+
+        close(client_a);
+        close(client_b);
+    }
+
+    GIVEN("A broken frame on one connector") {
+        const auto client_a = connect_client("lo");
+        const auto client_b = connect_client(second_interface);
+
+        // the session of connector a gets dropped, which closes its connection
+        REQUIRE(send_and_receive(client_a, INVALID_FRAME, sizeof(INVALID_FRAME)) <= 0);
+
+        // the session of connector a got restarted
+        const auto client_a_retry = connect_client("lo");
+        REQUIRE(send_and_receive(client_a_retry, SAP_REQUEST_FRAME, sizeof(SAP_REQUEST_FRAME)) > 0);
+
+        REQUIRE(send_and_receive(client_b, SAP_REQUEST_FRAME, sizeof(SAP_REQUEST_FRAME)) > 0);
+
+        loop_thread.stop();
+
+        THEN("Only its session is closed, the other connector keeps running") {
+            REQUIRE(feedback_a.signals.size() == 1);
+            REQUIRE(feedback_a.signals[0] == session::feedback::Signal::DLINK_ERROR);
+            REQUIRE(feedback_a.messages.size() == 2);
+
+            REQUIRE(feedback_b.signals.empty());
+            REQUIRE(feedback_b.messages.size() == 2);
+        }
+
+        close(client_a);
+        close(client_a_retry);
+        close(client_b);
+    }
+}
+
+SCENARIO("TbdController with a failing TLS handshake on one connector", "[network]") {
+
+    const auto second_interface = io::InterfaceRegistry::get_instance().find_first_link_local_interface();
+    if (second_interface.empty()) {
+        SKIP("No second interface with an ipv6 link local address available");
+    }
+
+    ConnectorFeedback feedback_a;
+    ConnectorFeedback feedback_b;
+
+    std::vector<TbdConnectorConfig> connector_configs;
+    connector_configs.push_back({"lo", feedback_a.get_callbacks(), make_evse_setup("DE*PNX*E1")});
+    connector_configs.push_back({second_interface, feedback_b.get_callbacks(), make_evse_setup("DE*PNX*E2")});
+
+    TbdConfig config;
+    config.ssl = make_ssl_config();
+
+    TbdController controller(config, std::move(connector_configs));
+    LoopThread loop_thread(controller);
+
+    GIVEN("An EV, which doesn't speak TLS on the offered TLS endpoint") {
+        const auto client_a = connect_client(discover_endpoint("lo", io::v2gtp::Security::TLS));
+        send(client_a, SAP_REQUEST_FRAME, sizeof(SAP_REQUEST_FRAME), MSG_NOSIGNAL);
+
+        REQUIRE(feedback_a.wait_for_signal(session::feedback::Signal::DLINK_ERROR));
+
+        const auto client_b =
+            connect_client(discover_endpoint(second_interface, io::v2gtp::Security::NO_TRANSPORT_SECURITY));
+        const auto received = send_and_receive(client_b, SAP_REQUEST_FRAME, sizeof(SAP_REQUEST_FRAME));
+
+        loop_thread.stop();
+        close(client_a);
+        close(client_b);
+
+        THEN("Only its session is closed, the other connector keeps serving") {
+            REQUIRE(feedback_a.signals.size() == 1);
+            REQUIRE(feedback_a.messages.empty());
+
+            REQUIRE(received > 0);
+            REQUIRE(feedback_b.signals.empty());
+            REQUIRE(feedback_b.messages.size() == 2);
+        }
+    }
+}
+
+SCENARIO("TbdController with an SDP request during a running session", "[network]") {
+
+    ConnectorFeedback feedback;
+
+    std::vector<TbdConnectorConfig> connector_configs;
+    connector_configs.push_back({"lo", feedback.get_callbacks(), make_evse_setup("DE*PNX*E1")});
+
+    TbdConfig config;
+    config.ssl = make_ssl_config();
+
+    TbdController controller(config, std::move(connector_configs));
+    LoopThread loop_thread(controller);
+
+    GIVEN("An EV, which already exchanges messages") {
+        const auto client = connect_client(discover_endpoint("lo", io::v2gtp::Security::NO_TRANSPORT_SECURITY));
+        REQUIRE(send_and_receive(client, SAP_REQUEST_FRAME, sizeof(SAP_REQUEST_FRAME)) > 0);
+
+        // e.g. a second EV on the same link
+        const auto end_point = request_endpoint("lo", io::v2gtp::Security::NO_TRANSPORT_SECURITY);
+        const auto connection_open = is_connection_open(client);
+
+        loop_thread.stop();
+        close(client);
+
+        THEN("The request is dropped and the session keeps running") {
+            REQUIRE(not end_point.has_value());
+            REQUIRE(connection_open);
+            REQUIRE(feedback.signals.empty());
+            REQUIRE(feedback.messages.size() == 2);
+        }
+    }
+}